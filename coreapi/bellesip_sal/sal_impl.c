@@ -312,6 +312,15 @@ SalBodyHandler *sal_body_handler_new_from_buffer(const void *data, size_t size)
 	return (SalBodyHandler *)belle_sip_memory_body_handler_new_copy_from_buffer(data, size, NULL, NULL);
 }
 
+SalBodyHandler *sal_body_handler_clone(const SalBodyHandler *body_handler) {
+	return (SalBodyHandler *)belle_sip_object_clone(BELLE_SIP_OBJECT(body_handler));
+}
+
+int sal_body_handler_apply_encoding(SalBodyHandler *body_handler, const char *encoding) {
+	if (!BELLE_SIP_IS_INSTANCE_OF(body_handler, belle_sip_memory_body_handler_t)) return -1;
+	return belle_sip_memory_body_handler_apply_encoding(BELLE_SIP_MEMORY_BODY_HANDLER(body_handler), encoding);
+}
+
 SalBodyHandler *sal_body_handler_ref(SalBodyHandler *body_handler) {
 	return (SalBodyHandler *)belle_sip_object_ref(BELLE_SIP_OBJECT(body_handler));
 }
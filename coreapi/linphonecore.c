@@ -2646,6 +2646,9 @@ static void misc_config_read(LinphoneCore *lc) {
 
 	lc->send_call_stats_periodical_updates =
 	    !!linphone_config_get_int(config, "misc", "send_call_stats_periodical_updates", 0);
+
+	linphone_config_enable_background_sync(config,
+	                                       !!linphone_config_get_int(config, "misc", "config_background_sync", 0));
 }
 
 void linphone_core_reload_ms_plugins(LinphoneCore *lc, const char *path) {
@@ -4449,6 +4452,10 @@ void linphone_core_iterate(LinphoneCore *lc) {
 
 	if (lc->sal) lc->sal->iterate();
 	if (lc->msevq) ms_event_queue_pump(lc->msevq);
+
+	auto &mainDb = L_GET_PRIVATE_FROM_C_OBJECT(lc)->mainDb;
+	if (mainDb) mainDb->flushPendingWritesIfNeeded();
+
 	if (linphone_core_get_global_state(lc) == LinphoneGlobalConfiguring)
 		// Avoid registration before getting remote configuration results
 		return;
@@ -7846,6 +7853,7 @@ void _linphone_core_stop_async_end(LinphoneCore *lc) {
 	L_GET_PRIVATE_FROM_C_OBJECT(lc)->disconnectMainDb();
 
 	if (linphone_config_needs_commit(lc->config)) linphone_core_config_sync(lc);
+	linphone_config_flush(lc->config);
 
 	bctbx_list_for_each(lc->call_logs, (void (*)(void *))linphone_call_log_unref);
 	lc->call_logs = bctbx_list_free(lc->call_logs);
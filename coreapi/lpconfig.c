@@ -45,6 +45,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #if !defined(_WIN32_WCE)
 #include <errno.h>
 #include <sys/stat.h>
@@ -82,8 +88,18 @@ typedef struct _LpItem {
 	int is_comment;
 	bool_t overwrite; // If set to true, will add overwrite=true when converted to xml
 	bool_t skip;      // If set to true, won't be dumped when converted to xml
+	/* Parsed value of the item, valid while int_value_cached is set. */
+	bool_t int_value_cached;
+	int int_value;
 } LpItem;
 
+/* Lookup indexes keyed by the names owned by the indexed items and sections. The lists remain the reference for
+ * ordering and serialization, the indexes point to the first occurrence of each name in them. */
+typedef std::unordered_map<std::string_view, LpItem *> LpItemIndex;
+typedef std::unordered_map<std::string_view, struct _LpSection *> LpSectionIndex;
+
+typedef struct _LpConfigWriter LpConfigWriter;
+
 typedef struct _LpSectionParam {
 	char *key;
 	char *value;
@@ -93,6 +109,7 @@ typedef struct _LpSection {
 	char *name;
 	bctbx_list_t *items;
 	bctbx_list_t *params;
+	LpItemIndex *index;
 	bool_t overwrite; // If set to true, will add overwrite=true to all items of this section when converted to xml
 	bool_t skip;      // If set to true, won't be dumped when converted to xml
 } LpSection;
@@ -104,6 +121,8 @@ struct _LpConfig {
 	char *tmpfilename;
 	char *factory_filename;
 	bctbx_list_t *sections;
+	LpSectionIndex *section_index;
+	LpConfigWriter *writer;
 	bctbx_vfs_t *g_bctbx_vfs;
 	bool_t modified;
 	bool_t readonly;
@@ -163,6 +182,7 @@ LpSectionParam *lp_section_param_new(const char *key, const char *value) {
 LpSection *lp_section_new(const char *name) {
 	LpSection *sec = lp_new0(LpSection, 1);
 	sec->name = ortp_strdup(name);
+	sec->index = new LpItemIndex();
 	return sec;
 }
 
@@ -173,6 +193,15 @@ void lp_item_destroy(void *pitem) {
 	free(item);
 }
 
+void lp_item_set_value(LpItem *item, const char *value) {
+	if (item->value != value) {
+		char *prev_value = item->value;
+		item->value = ortp_strdup(value);
+		item->int_value_cached = FALSE;
+		ortp_free(prev_value);
+	}
+}
+
 void lp_section_param_destroy(void *section_param) {
 	LpSectionParam *param = (LpSectionParam *)section_param;
 	ortp_free(param->key);
@@ -181,6 +210,7 @@ void lp_section_param_destroy(void *section_param) {
 }
 
 void lp_section_destroy(LpSection *sec) {
+	delete sec->index;
 	ortp_free(sec->name);
 	bctbx_list_for_each(sec->items, lp_item_destroy);
 	bctbx_list_for_each(sec->params, lp_section_param_destroy);
@@ -190,10 +220,18 @@ void lp_section_destroy(LpSection *sec) {
 
 void lp_section_add_item(LpSection *sec, LpItem *item) {
 	sec->items = bctbx_list_append(sec->items, (void *)item);
+	if (!item->is_comment) sec->index->emplace(item->key, item);
+}
+
+static LpSectionIndex *linphone_config_get_section_index(const LpConfig *lpconfig) {
+	LpConfig *config = const_cast<LpConfig *>(lpconfig);
+	if (config->section_index == NULL) config->section_index = new LpSectionIndex();
+	return config->section_index;
 }
 
 void linphone_config_add_section(LpConfig *lpconfig, LpSection *section) {
 	lpconfig->sections = bctbx_list_append(lpconfig->sections, (void *)section);
+	linphone_config_get_section_index(lpconfig)->emplace(section->name, section);
 }
 
 void linphone_config_add_section_param(LpSection *section, LpSectionParam *param) {
@@ -202,11 +240,37 @@ void linphone_config_add_section_param(LpSection *section, LpSectionParam *param
 
 void linphone_config_remove_section(LpConfig *lpconfig, LpSection *section) {
 	lpconfig->sections = bctbx_list_remove(lpconfig->sections, (void *)section);
+	LpSectionIndex *index = linphone_config_get_section_index(lpconfig);
+	auto it = index->find(section->name);
+	if (it != index->end() && it->second == section) {
+		index->erase(it);
+		/* Another section with the same name may have been added, it becomes the one found by name. */
+		for (bctbx_list_t *elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem)) {
+			LpSection *sec = (LpSection *)elem->data;
+			if (strcmp(sec->name, section->name) == 0) {
+				index->emplace(sec->name, sec);
+				break;
+			}
+		}
+	}
 	lp_section_destroy(section);
 }
 
 void lp_section_remove_item(LpSection *sec, LpItem *item) {
 	sec->items = bctbx_list_remove(sec->items, (void *)item);
+	if (!item->is_comment) {
+		auto it = sec->index->find(item->key);
+		if (it != sec->index->end() && it->second == item) {
+			sec->index->erase(it);
+			for (bctbx_list_t *elem = sec->items; elem != NULL; elem = bctbx_list_next(elem)) {
+				LpItem *other = (LpItem *)elem->data;
+				if (!other->is_comment && strcmp(other->key, item->key) == 0) {
+					sec->index->emplace(other->key, other);
+					break;
+				}
+			}
+		}
+	}
 	lp_item_destroy(item);
 }
 
@@ -227,17 +291,9 @@ static int is_a_comment(const char *str) {
 }
 
 LpSection *linphone_config_find_section(const LpConfig *lpconfig, const char *name) {
-	LpSection *sec;
-	bctbx_list_t *elem = lpconfig->sections;
-	/*printf("Looking for section %s\n",name);*/
-	for (; elem != NULL; elem = bctbx_list_next(elem)) {
-		sec = (LpSection *)elem->data;
-		if (strcmp(sec->name, name) == 0) {
-			/*printf("Section %s found\n",name);*/
-			return sec;
-		}
-	}
-	return NULL;
+	if (lpconfig->section_index == NULL) return NULL;
+	auto it = lpconfig->section_index->find(name);
+	return it != lpconfig->section_index->end() ? it->second : NULL;
 }
 
 LpSectionParam *lp_section_find_param(const LpSection *sec, const char *key) {
@@ -267,17 +323,8 @@ LpItem *lp_section_find_comment(const LpSection *sec, const char *comment) {
 }
 
 LpItem *lp_section_find_item(const LpSection *sec, const char *name) {
-	bctbx_list_t *elem;
-	LpItem *item;
-	/*printf("Looking for item %s\n",name);*/
-	for (elem = sec->items; elem != NULL; elem = bctbx_list_next(elem)) {
-		item = (LpItem *)elem->data;
-		if (!item->is_comment && strcmp(item->key, name) == 0) {
-			/*printf("Item %s found\n",name);*/
-			return item;
-		}
-	}
-	return NULL;
+	auto it = sec->index->find(name);
+	return it != sec->index->end() ? it->second : NULL;
 }
 
 bctbx_list_t *lp_section_get_items(const LpSection *sec) {
@@ -385,8 +432,7 @@ static LpSection *linphone_config_parse_line(LpConfig *lpconfig, char *line, LpS
 							if (item == NULL) {
 								lp_section_add_item(cur, lp_item_new(key, pos1));
 							} else {
-								ortp_free(item->value);
-								item->value = ortp_strdup(pos1);
+								lp_item_set_value(item, pos1);
 							}
 							/*ms_message("Found %s=%s",key,pos1);*/
 						} else {
@@ -663,19 +709,13 @@ LinphoneStatus linphone_config_load_from_xml_string(LpConfig *lpc, const char *b
 	} else return 0;
 }
 
-void lp_item_set_value(LpItem *item, const char *value) {
-	if (item->value != value) {
-		char *prev_value = item->value;
-		item->value = ortp_strdup(value);
-		ortp_free(prev_value);
-	}
-}
-
 static void _linphone_config_uninit(LpConfig *lpconfig) {
+	linphone_config_enable_background_sync(lpconfig, FALSE);
 	if (lpconfig->filename != NULL) ortp_free(lpconfig->filename);
 	if (lpconfig->tmpfilename) ortp_free(lpconfig->tmpfilename);
 	if (lpconfig->factory_filename) bctbx_free(lpconfig->factory_filename);
 	if (lpconfig->sections) bctbx_list_free_with_data(lpconfig->sections, (bctbx_list_free_func)lp_section_destroy);
+	delete lpconfig->section_index;
 }
 
 LpConfig *linphone_config_ref(LpConfig *lpconfig) {
@@ -769,26 +809,34 @@ bool_t linphone_config_get_range(const LpConfig *lpconfig,
 	}
 }
 
-int linphone_config_get_int(const LpConfig *lpconfig, const char *section, const char *key, int default_value) {
-	const char *str = linphone_config_get_string(lpconfig, section, key, NULL);
-	if (str != NULL) {
+static LpItem *linphone_config_find_item(const LpConfig *lpconfig, const char *section, const char *key) {
+	LpSection *sec = linphone_config_find_section(lpconfig, section);
+	return sec ? lp_section_find_item(sec, key) : NULL;
+}
+
+/* The parsed value is kept in the item so that repeated reads of the same entry skip sscanf(). */
+static int lp_item_get_int(LpItem *item) {
+	if (!item->int_value_cached) {
+		const char *str = item->value;
 		int ret = 0;
 
 		if (strstr(str, "0x") == str) {
 			sscanf(str, "%x", &ret);
 		} else sscanf(str, "%i", &ret);
-		return ret;
-	} else return default_value;
+		item->int_value = ret;
+		item->int_value_cached = TRUE;
+	}
+	return item->int_value;
+}
+
+int linphone_config_get_int(const LpConfig *lpconfig, const char *section, const char *key, int default_value) {
+	LpItem *item = linphone_config_find_item(lpconfig, section, key);
+	return item ? lp_item_get_int(item) : default_value;
 }
 
 bool_t linphone_config_get_bool(const LpConfig *lpconfig, const char *section, const char *key, bool_t default_value) {
-	const char *str = linphone_config_get_string(lpconfig, section, key, NULL);
-	if (str != NULL) {
-		int ret = 0;
-		sscanf(str, "%i", &ret);
-		return ret != 0;
-	}
-	return default_value;
+	LpItem *item = linphone_config_find_item(lpconfig, section, key);
+	return item ? lp_item_get_int(item) != 0 : default_value;
 }
 
 int64_t
@@ -969,42 +1017,170 @@ void linphone_config_set_skip_flag_for_section(LpConfig *lpconfig, const char *s
 	}
 }
 
-void lp_item_write(LpItem *item, LpConfig *lpconfig) {
-	int ret = -1;
+static void lp_item_write(const LpItem *item, std::string &output) {
 	if (item->is_comment) {
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s\n", item->value);
-
+		output += item->value;
+		output += "\n";
 	} else if (item->value && item->value[0] != '\0') {
-		ret = (int)bctbx_file_fprintf(lpconfig->pFile, 0, "%s=%s\n", item->key, item->value);
-	}
-
-	else {
+		output += item->key;
+		output += "=";
+		output += item->value;
+		output += "\n";
+	} else {
 		ms_warning("Not writing item %s to file, it is empty", item->key);
 	}
-	if (ret < 0) {
-		ms_error("lp_item_write : not writing item to file");
-	}
 }
 
-void lp_section_param_write(LpSectionParam *param, LpConfig *lpconfig) {
+static void lp_section_param_write(const LpSectionParam *param, std::string &output) {
 	if (param->value && param->value[0] != '\0') {
-		bctbx_file_fprintf(lpconfig->pFile, 0, " %s=%s", param->key, param->value);
-
+		output += " ";
+		output += param->key;
+		output += "=";
+		output += param->value;
 	} else {
 		ms_warning("Not writing param %s to file, it is empty", param->key);
 	}
 }
 
-void lp_section_write(LpSection *sec, LpConfig *lpconfig) {
+static void lp_section_write(const LpSection *sec, std::string &output) {
+	output += "[";
+	output += sec->name;
+	for (const bctbx_list_t *elem = sec->params; elem != NULL; elem = bctbx_list_next(elem))
+		lp_section_param_write((const LpSectionParam *)elem->data, output);
+	output += "]\n";
+	for (const bctbx_list_t *elem = sec->items; elem != NULL; elem = bctbx_list_next(elem))
+		lp_item_write((const LpItem *)elem->data, output);
+	output += "\n";
+}
 
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "[%s", sec->name) < 0)
-		ms_error("lp_section_write : write error on %s", sec->name);
-	bctbx_list_for_each2(sec->params, (void (*)(void *, void *))lp_section_param_write, (void *)lpconfig);
+/* Serializes the whole configuration, in the on-disk format. */
+static void linphone_config_write(const LpConfig *lpconfig, std::string &output) {
+	for (const bctbx_list_t *elem = lpconfig->sections; elem != NULL; elem = bctbx_list_next(elem))
+		lp_section_write((const LpSection *)elem->data, output);
+}
 
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "]\n") < 0) ms_error("lp_section_write : write error ");
-	bctbx_list_for_each2(sec->items, (void (*)(void *, void *))lp_item_write, (void *)lpconfig);
+/* Atomically replaces filename by content, going through tmpfilename. Safe to call from any thread.
+ * Returns -1 if tmpfilename cannot be created, and -2 if it cannot be written or renamed: filename is then left
+ * untouched. */
+static int linphone_config_write_file(bctbx_vfs_t *vfs,
+                                      const std::string &filename,
+                                      const std::string &tmpfilename,
+                                      const std::string &content) {
+#ifndef _WIN32
+	/* don't create group/world-accessible files */
+	(void)umask(S_IRWXG | S_IRWXO);
+#endif
+	bctbx_vfs_file_t *pFile = bctbx_file_open(vfs, tmpfilename.c_str(), "w");
+	if (pFile == NULL) {
+		ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.", filename.c_str());
+		return -1;
+	}
+	bool_t written = TRUE;
+	if (!content.empty() && bctbx_file_write(pFile, content.c_str(), content.size(), 0) != (ssize_t)content.size()) {
+		ms_error("linphone_config_sync(): write error on %s", tmpfilename.c_str());
+		written = FALSE;
+	}
+	if (written && bctbx_file_sync(pFile) < 0) {
+		ms_error("linphone_config_sync(): cannot sync %s", tmpfilename.c_str());
+		written = FALSE;
+	}
+	if (bctbx_file_close(pFile) < 0) written = FALSE;
+	if (!written) {
+		ms_error("Configuration is not saved to %s", filename.c_str());
+		return -2;
+	}
 
-	if (bctbx_file_fprintf(lpconfig->pFile, 0, "\n") < 0) ms_error("lp_section_write : write error");
+#ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
+	/* On windows, rename() does not accept that the newpath is an existing file, while it is accepted on Unix.
+	 * As a result, we are forced to first delete the linphonerc file, and then rename.*/
+	if (remove(filename.c_str()) != 0) {
+		ms_error("Cannot remove %s: %s", filename.c_str(), strerror(errno));
+	}
+#endif
+	if (rename(tmpfilename.c_str(), filename.c_str()) != 0) {
+		ms_error("Cannot rename %s into %s: %s", tmpfilename.c_str(), filename.c_str(), strerror(errno));
+		return -2;
+	}
+	return 0;
+}
+
+/* Writer thread of a config with background sync enabled. linphone_config_sync() hands it a snapshot of the
+ * serialized config; a snapshot taken while a previous one is still waiting replaces it, so that bursts of
+ * changes end up in a single write. */
+struct _LpConfigWriter {
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cond;
+	bctbx_vfs_t *vfs = nullptr;
+	std::string filename;
+	std::string tmpfilename;
+	std::string pending;
+	bool has_pending = false;
+	bool writing = false;
+	bool stopping = false;
+	bool failed = false;      /* The file cannot be created: later snapshots are not written. */
+	bool write_error = false; /* The last snapshot could not be written. */
+	unsigned int coalesced = 0;
+
+	void run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			cond.wait(lock, [this] { return has_pending || stopping; });
+			if (!has_pending) break;
+			std::string content = std::move(pending);
+			has_pending = false;
+			writing = true;
+			lock.unlock();
+			int ret = linphone_config_write_file(vfs, filename, tmpfilename, content);
+			lock.lock();
+			writing = false;
+			if (ret == -1) failed = true;
+			write_error = ret != 0;
+			cond.notify_all();
+		}
+	}
+
+	void waitIdle(std::unique_lock<std::mutex> &lock) {
+		cond.wait(lock, [this] { return !has_pending && !writing; });
+	}
+};
+
+void linphone_config_enable_background_sync(LinphoneConfig *lpconfig, bool_t enable) {
+	if (enable && !lpconfig->writer) {
+		if (lpconfig->filename == NULL) return;
+		LpConfigWriter *writer = new LpConfigWriter();
+		writer->vfs = lpconfig->g_bctbx_vfs;
+		writer->filename = lpconfig->filename;
+		writer->tmpfilename = lpconfig->tmpfilename;
+		writer->thread = std::thread(&LpConfigWriter::run, writer);
+		lpconfig->writer = writer;
+		ms_message("Background sync enabled for config file %s", lpconfig->filename);
+	} else if (!enable && lpconfig->writer) {
+		LpConfigWriter *writer = lpconfig->writer;
+		{
+			std::lock_guard<std::mutex> lock(writer->mutex);
+			writer->stopping = true;
+		}
+		writer->cond.notify_all();
+		/* The thread writes the pending snapshot before exiting. */
+		writer->thread.join();
+		if (writer->coalesced > 0)
+			ms_message("Background sync of %s skipped %u intermediate writes", lpconfig->filename, writer->coalesced);
+		delete writer;
+		lpconfig->writer = NULL;
+	}
+}
+
+bool_t linphone_config_background_sync_enabled(const LinphoneConfig *lpconfig) {
+	return lpconfig->writer != NULL;
+}
+
+LinphoneStatus linphone_config_flush(LinphoneConfig *lpconfig) {
+	LpConfigWriter *writer = lpconfig->writer;
+	if (!writer) return 0;
+	std::unique_lock<std::mutex> lock(writer->mutex);
+	writer->waitIdle(lock);
+	return (writer->failed || writer->write_error) ? -1 : 0;
 }
 
 void linphone_config_simulate_read_failure(bool_t value) {
@@ -1016,51 +1192,49 @@ void linphone_config_simulate_crash_during_sync(LinphoneConfig *lpconfig, bool_t
 }
 
 LinphoneStatus linphone_config_sync(LpConfig *lpconfig) {
-	bctbx_vfs_file_t *pFile = NULL;
 	if (lpconfig->filename == NULL) return -1;
 	if (lpconfig->readonly) return 0;
 
-#ifndef _WIN32
-	/* don't create group/world-accessible files */
-	(void)umask(S_IRWXG | S_IRWXO);
-#endif
-	pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, lpconfig->tmpfilename, "w");
-	lpconfig->pFile = pFile;
-	if (pFile == NULL) {
-		ms_warning("Could not write %s ! Maybe it is read-only. Configuration will not be saved.", lpconfig->filename);
-		lpconfig->readonly = TRUE;
-		return -1;
-	}
-
 	if (lpconfig->abort_sync) {
+		bctbx_vfs_file_t *pFile = bctbx_file_open(lpconfig->g_bctbx_vfs, lpconfig->tmpfilename, "w");
 		ms_warning("linphone_config_sync(): simulating crash during file writing, leaving an empty file.");
-		bctbx_file_close(pFile);
+		if (pFile) bctbx_file_close(pFile);
 		return -1;
 	}
 
-	bctbx_list_for_each2(lpconfig->sections, (void (*)(void *, void *))lp_section_write, (void *)lpconfig);
-	bctbx_file_sync(pFile);
-	bctbx_file_close(pFile);
-	lpconfig->pFile = NULL;
+	std::string content;
+	linphone_config_write(lpconfig, content);
 
-#ifdef RENAME_REQUIRES_NONEXISTENT_NEW_PATH
-	/* On windows, rename() does not accept that the newpath is an existing file, while it is accepted on Unix.
-	 * As a result, we are forced to first delete the linphonerc file, and then rename.*/
-	if (remove(lpconfig->filename) != 0) {
-		ms_error("Cannot remove %s: %s", lpconfig->filename, strerror(errno));
-	}
-#endif
-	if (rename(lpconfig->tmpfilename, lpconfig->filename) != 0) {
-		ms_error("Cannot rename %s into %s: %s", lpconfig->tmpfilename, lpconfig->filename, strerror(errno));
+	LpConfigWriter *writer = lpconfig->writer;
+	if (writer) {
+		{
+			std::lock_guard<std::mutex> lock(writer->mutex);
+			if (writer->failed) {
+				lpconfig->readonly = TRUE;
+				return -1;
+			}
+			if (writer->has_pending) writer->coalesced++;
+			writer->pending = std::move(content);
+			writer->has_pending = true;
+		}
+		writer->cond.notify_all();
+		lpconfig->modified = FALSE;
+		return 0;
 	}
+
+	int ret = linphone_config_write_file(lpconfig->g_bctbx_vfs, lpconfig->filename, lpconfig->tmpfilename, content);
+	if (ret == -1) lpconfig->readonly = TRUE;
+	if (ret != 0) return -1;
 	lpconfig->modified = FALSE;
 	return 0;
 }
 
 void linphone_config_reload(LinphoneConfig *lpconfig) {
+	linphone_config_flush(lpconfig);
 	bctbx_list_for_each(lpconfig->sections, (void (*)(void *))lp_section_destroy);
 	bctbx_list_free(lpconfig->sections);
 	lpconfig->sections = NULL;
+	if (lpconfig->section_index) lpconfig->section_index->clear();
 	linphone_config_read_file(lpconfig, lpconfig->filename);
 }
 
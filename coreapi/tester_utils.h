@@ -412,6 +412,9 @@ LINPHONE_PUBLIC bool_t linphone_tunnel_is_tunnel_rtp_transport(const LinphoneTun
 LINPHONE_PUBLIC void linphone_config_simulate_crash_during_sync(LinphoneConfig *lpconfig, bool_t value);
 LINPHONE_PUBLIC void linphone_config_simulate_read_failure(bool_t value);
 
+LINPHONE_PUBLIC void linphone_presence_model_enable_streaming_pidf_parser(bool_t enable);
+LINPHONE_PUBLIC LinphonePresenceModel *linphone_presence_model_parse_pidf(const char *body);
+
 LINPHONE_PUBLIC void linphone_payload_type_set_priority_bonus(LinphonePayloadType *pt, bool_t value);
 
 LINPHONE_PUBLIC bool_t linphone_account_lime_enabled(LinphoneAccount *account);
@@ -305,6 +305,23 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_message_events(Linp
 LINPHONE_PUBLIC bctbx_list_t *
 linphone_chat_room_get_history_range_message_events(LinphoneChatRoom *chat_room, int begin, int end);
 
+/**
+ * Gets the chat message events surrounding a given event, sorted from oldest to most recent.
+ * Unlike #linphone_chat_room_get_history_range_message_events(), the cost of this call does not depend on how far the
+ * given event is from the most recent one, which makes it suitable for scrolling through a long history.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved
+ * @notnil
+ * @param before The maximum number of events older than the given event to retrieve.
+ * @param after The maximum number of events more recent than the given event to retrieve.
+ * @param event The #LinphoneEventLog the range is relative to, it is not part of the returned list. If NULL, the
+ * before most recent events are returned. @maybenil
+ * @return The list of chat message events. \bctbx_list{LinphoneEventLog} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_range_message_events_near(LinphoneChatRoom *chat_room,
+                                                                                       unsigned int before,
+                                                                                       unsigned int after,
+                                                                                       LinphoneEventLog *event);
+
 /**
  * Gets nb_events most recent events from chat_room chat room, sorted from oldest to most recent.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved
@@ -325,6 +342,23 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_events(LinphoneChat
 LINPHONE_PUBLIC bctbx_list_t *
 linphone_chat_room_get_history_range_events(LinphoneChatRoom *chat_room, int begin, int end);
 
+/**
+ * Gets the events surrounding a given event, sorted from oldest to most recent.
+ * Unlike #linphone_chat_room_get_history_range_events(), the cost of this call does not depend on how far the given
+ * event is from the most recent one, which makes it suitable for scrolling through a long history.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved
+ * @notnil
+ * @param before The maximum number of events older than the given event to retrieve.
+ * @param after The maximum number of events more recent than the given event to retrieve.
+ * @param event The #LinphoneEventLog the range is relative to, it is not part of the returned list. If NULL, the
+ * before most recent events are returned. @maybenil
+ * @return The list of the found events. \bctbx_list{LinphoneEventLog} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_range_events_near(LinphoneChatRoom *chat_room,
+                                                                               unsigned int before,
+                                                                               unsigned int after,
+                                                                               LinphoneEventLog *event);
+
 /**
  * Gets the number of events in a chat room.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which size has to be computed
@@ -351,6 +385,21 @@ LINPHONE_PUBLIC LinphoneChatMessage *linphone_chat_room_get_last_message_in_hist
 LINPHONE_PUBLIC LinphoneChatMessage *linphone_chat_room_find_message(LinphoneChatRoom *chat_room,
                                                                      const char *message_id);
 
+/**
+ * Searches the text of the messages sent or received in this chat room, best matches first.
+ * Every word of text must be found in a message, the last one possibly as a prefix. If the full-text index is not
+ * available (MySQL storage), messages containing text are returned instead, most recent first.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation to search @notnil
+ * @param text The text to search for @notnil
+ * @param limit The maximum number of messages to return.
+ * @param cursor The number of messages already returned by previous calls for the same text, 0 for the first page.
+ * @return The list of matching chat messages. \bctbx_list{LinphoneChatMessage} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_search_chat_messages(LinphoneChatRoom *chat_room,
+                                                                      const char *text,
+                                                                      unsigned int limit,
+                                                                      unsigned int cursor);
+
 /**
  * Notifies the destination of the chat message being composed that the user is typing a new message.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which a new message is being
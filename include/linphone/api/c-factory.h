@@ -576,6 +576,55 @@ LINPHONE_PUBLIC bool_t linphone_factory_is_cache_dir_set(const LinphoneFactory *
  */
 LINPHONE_PUBLIC void linphone_factory_set_cache_dir(LinphoneFactory *factory, const char *path);
 
+/**
+ * Sets the maximum number of parsed addresses kept in the cache shared by all the cores of the process.
+ * When the cache is full, the least recently used address is evicted. Changing the capacity empties the cache.
+ * @param factory the #LinphoneFactory @notnil
+ * @param capacity The maximum number of cached addresses, 10000 by default.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC void linphone_factory_set_address_cache_capacity(LinphoneFactory *factory, int capacity);
+
+/**
+ * Gets the maximum number of parsed addresses kept in cache.
+ * @param factory the #LinphoneFactory @notnil
+ * @return The maximum number of cached addresses.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC int linphone_factory_get_address_cache_capacity(const LinphoneFactory *factory);
+
+/**
+ * Gets the number of parsed addresses currently in cache.
+ * @param factory the #LinphoneFactory @notnil
+ * @return The number of cached addresses.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC int linphone_factory_get_address_cache_size(const LinphoneFactory *factory);
+
+/**
+ * Gets the number of addresses created from the cache since the process started.
+ * @param factory the #LinphoneFactory @notnil
+ * @return The number of address cache hits.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC uint64_t linphone_factory_get_address_cache_hits(const LinphoneFactory *factory);
+
+/**
+ * Gets the number of addresses that had to be parsed since the process started.
+ * @param factory the #LinphoneFactory @notnil
+ * @return The number of address cache misses.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC uint64_t linphone_factory_get_address_cache_misses(const LinphoneFactory *factory);
+
+/**
+ * Gets the number of addresses evicted from the cache because it was full since the process started.
+ * @param factory the #LinphoneFactory @notnil
+ * @return The number of address cache evictions.
+ * @ingroup misc
+ **/
+LINPHONE_PUBLIC uint64_t linphone_factory_get_address_cache_evictions(const LinphoneFactory *factory);
+
 /**
  * Creates an object LinphoneErrorInfo.
  * @param factory #LinphoneFactory object @notnil
@@ -996,6 +1045,9 @@ linphone_factory_create_core_with_config_2(const LinphoneFactory *factory,
  * @maybenil
  * @param[in]	secretSize		size of the secret
  *
+ * The sqlite3 WAL journal mode ([storage] sqlite3_wal_enabled) is not enabled when an encryption module is set, as it
+ * requires a VFS that does not encrypt the database.
+ *
  * @return true if everything went well, false if it appears that the given secret is unable to decrypt existing
  * configuration
  */
@@ -170,6 +170,48 @@ LINPHONE_PUBLIC bool_t linphone_magic_search_get_limited_search(const LinphoneMa
  **/
 LINPHONE_PUBLIC void linphone_magic_search_set_limited_search(LinphoneMagicSearch *magic_search, bool_t limited);
 
+/**
+ * Returns whether friends are looked up through an n-gram index of their friend list.
+ * @param magic_search a #LinphoneMagicSearch object @notnil
+ * @return TRUE if the n-gram index is used, FALSE otherwise
+ **/
+LINPHONE_PUBLIC bool_t linphone_magic_search_get_use_ngram_index(const LinphoneMagicSearch *magic_search);
+
+/**
+ * Enables or disables the n-gram index of friend lists.
+ * When enabled, only the friends whose name, organization, SIP addresses or phone numbers may contain the filter are
+ *weighted, which makes searches in large friend lists faster at the cost of memory. The index of a friend list is
+ *built by the first search using it and kept up to date afterwards.
+ * @param magic_search a #LinphoneMagicSearch object @notnil
+ * @param enable TRUE to use the n-gram index, FALSE otherwise
+ **/
+LINPHONE_PUBLIC void linphone_magic_search_set_use_ngram_index(LinphoneMagicSearch *magic_search, bool_t enable);
+
+/**
+ * Returns whether the asynchronous search notifies partial results.
+ * @param magic_search a #LinphoneMagicSearch object @notnil
+ * @return TRUE if partial results are notified, FALSE otherwise
+ **/
+LINPHONE_PUBLIC bool_t linphone_magic_search_get_notify_partial_results(const LinphoneMagicSearch *magic_search);
+
+/**
+ * Enables or disables the notification of partial results.
+ * When enabled, the search results received callback is also called while an asynchronous search is waiting for
+ *some providers, such as LDAP servers, with the results of the providers that have already answered. Use
+ *linphone_magic_search_is_last_search_partial() to know whether more results are to come.
+ * @param magic_search a #LinphoneMagicSearch object @notnil
+ * @param enable TRUE to notify partial results, FALSE otherwise
+ **/
+LINPHONE_PUBLIC void linphone_magic_search_set_notify_partial_results(LinphoneMagicSearch *magic_search, bool_t enable);
+
+/**
+ * Returns whether the results of linphone_magic_search_get_last_search() are partial, some providers not having
+ *answered yet.
+ * @param magic_search a #LinphoneMagicSearch object @notnil
+ * @return TRUE if more results are to come, FALSE otherwise
+ **/
+LINPHONE_PUBLIC bool_t linphone_magic_search_is_last_search_partial(const LinphoneMagicSearch *magic_search);
+
 /**
  * Reset the cache to begin a new search
  * @param magic_search a #LinphoneMagicSearch object @notnil
@@ -367,6 +367,30 @@ linphone_config_set_float(LinphoneConfig *config, const char *section, const cha
  **/
 LINPHONE_PUBLIC LinphoneStatus linphone_config_sync(LinphoneConfig *config);
 
+/**
+ * Enables or disables the background writing of the config file.
+ * When enabled, linphone_config_sync() only takes a snapshot of the config, which is written to disk by a dedicated
+ * thread. Snapshots taken while a write is in progress are coalesced. Disabling it waits for the pending write.
+ * @param config The #LinphoneConfig object @notnil
+ * @param enable TRUE to write the config file from a background thread, FALSE to write it in linphone_config_sync()
+ **/
+LINPHONE_PUBLIC void linphone_config_enable_background_sync(LinphoneConfig *config, bool_t enable);
+
+/**
+ * Tells whether the config file is written from a background thread.
+ * @param config The #LinphoneConfig object @notnil
+ * @return TRUE if background sync is enabled, FALSE otherwise
+ **/
+LINPHONE_PUBLIC bool_t linphone_config_background_sync_enabled(const LinphoneConfig *config);
+
+/**
+ * Waits until the snapshots handed to the background writer by linphone_config_sync() are on disk.
+ * Returns immediately when background sync is disabled.
+ * @param config The #LinphoneConfig object @notnil
+ * @return 0 if successful, -1 if a background write failed
+ **/
+LINPHONE_PUBLIC LinphoneStatus linphone_config_flush(LinphoneConfig *config);
+
 /**
  * Reload the config from the file.
  * @param config The #LinphoneConfig object @notnil
@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <mutex>
+
 #include <bctoolbox/defs.h>
 
 #include "address-parser.h"
@@ -25,6 +27,8 @@
 
 #include "address.h"
 #include "c-wrapper/c-wrapper.h"
+#include "containers/lru-cache.h"
+#include "linphone/utils/utils.h"
 #include "logger/logger.h"
 
 // =============================================================================
@@ -33,11 +37,34 @@ using namespace std;
 
 LINPHONE_BEGIN_NAMESPACE
 
-std::unordered_map<std::string, std::unique_ptr<SalAddress, Address::SalAddressDeleter>> Address::sAddressCache;
+// Cores may run in different threads, so every access is done under the mutex. Cached addresses are never handed
+// out, only clones of them.
+struct Address::SalAddressCache {
+	static constexpr int DefaultCapacity = 10000;
+
+	std::mutex mutex;
+	LruCache<string, unique_ptr<SalAddress, SalAddressDeleter>> entries{DefaultCapacity};
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+};
+
+Address::SalAddressCache &Address::getSalAddressCache() {
+	static SalAddressCache cache;
+	return cache;
+}
 
 SalAddress *Address::getSalAddressFromCache(const string &address, bool assumeGrUri) {
-	auto &ptr = sAddressCache[address];
-	if (ptr) return sal_address_clone(ptr.get());
+	SalAddressCache &cache = getSalAddressCache();
+	{
+		lock_guard<mutex> lock(cache.mutex);
+		auto ptr = cache.entries.touch(address);
+		if (ptr) {
+			cache.hits++;
+			return sal_address_clone(ptr->get());
+		}
+		cache.misses++;
+	}
 
 	// lInfo() << "Creating SalAddress for " << address;
 	/* To optimize, use the fast uri parser from AddressParser when we can assume that it is a simple URI with
@@ -48,12 +75,15 @@ SalAddress *Address::getSalAddressFromCache(const string &address, bool assumeGr
 		parsedAddress = AddressParser::get().parseAddress(address);
 	}
 	if (!parsedAddress) parsedAddress = sal_address_new(L_STRING_TO_C(address));
-	if (parsedAddress) {
-		removeFromLeakDetector(parsedAddress);
-		ptr = (unique_ptr<SalAddress, SalAddressDeleter>(parsedAddress, SalAddressDeleter()));
-		return sal_address_clone(parsedAddress);
-	}
-	return nullptr;
+	if (!parsedAddress) return nullptr;
+
+	removeFromLeakDetector(parsedAddress);
+	SalAddress *clonedAddress = sal_address_clone(parsedAddress);
+
+	lock_guard<mutex> lock(cache.mutex);
+	if (!cache.entries[address] && cache.entries.getSize() == cache.entries.getCapacity()) cache.evictions++;
+	cache.entries.insert(address, unique_ptr<SalAddress, SalAddressDeleter>(parsedAddress, SalAddressDeleter()));
+	return clonedAddress;
 }
 
 // -----------------------------------------------------------------------------
@@ -66,7 +96,8 @@ Address::Address(const string &address, bool assumeGrUri) {
 	}
 }
 
-Address::Address(const Address &other) : HybridObject(other) {
+Address::Address(const Address &other)
+    : HybridObject(other), mOrderedKey(other.mOrderedKey), mLowercaseOrderedKey(other.mLowercaseOrderedKey) {
 	SalAddress *salAddress = other.mImpl;
 	if (salAddress) mImpl = sal_address_clone(salAddress);
 	else mImpl = sal_address_new_empty();
@@ -76,9 +107,12 @@ Address::Address() {
 	mImpl = sal_address_new_empty();
 }
 
-Address::Address(Address &&other) : bellesip::HybridObject<LinphoneAddress, Address>(std::move(other)) {
+Address::Address(Address &&other)
+    : bellesip::HybridObject<LinphoneAddress, Address>(std::move(other)), mOrderedKey(std::move(other.mOrderedKey)),
+      mLowercaseOrderedKey(std::move(other.mLowercaseOrderedKey)) {
 	mImpl = other.mImpl;
 	other.mImpl = nullptr;
+	other.invalidateOrderedKeys();
 }
 
 Address::Address(SalAddress *addr, bool acquire) {
@@ -106,6 +140,8 @@ Address &Address::operator=(const Address &other) {
 		if (mImpl) sal_address_unref(mImpl);
 		SalAddress *salAddress = other.mImpl;
 		mImpl = salAddress ? sal_address_clone(salAddress) : nullptr;
+		mOrderedKey = other.mOrderedKey;
+		mLowercaseOrderedKey = other.mLowercaseOrderedKey;
 	}
 
 	return *this;
@@ -122,7 +158,7 @@ bool Address::operator!=(const Address &other) const {
 }
 
 bool Address::operator<(const Address &other) const {
-	return toStringOrdered() < other.toStringOrdered();
+	return getOrderedKey() < other.getOrderedKey();
 }
 
 // -----------------------------------------------------------------------------
@@ -147,10 +183,53 @@ void Address::setImpl(const SalAddress *addr) {
 void Address::setImpl(SalAddress *addr) {
 	if (mImpl) sal_address_unref(mImpl);
 	mImpl = addr;
+	invalidateOrderedKeys();
 }
 
 void Address::clearSipAddressesCache() {
-	sAddressCache.clear();
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	if (cache.hits + cache.misses > 0)
+		lInfo() << "Clearing sip addresses cache (hits: " << cache.hits << ", misses: " << cache.misses
+		        << ", evictions: " << cache.evictions << ")";
+	cache.entries.clear();
+}
+
+// Changing the capacity drops the cached addresses.
+void Address::setSipAddressesCacheCapacity(int capacity) {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	cache.entries.setCapacity(capacity);
+}
+
+int Address::getSipAddressesCacheCapacity() {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	return cache.entries.getCapacity();
+}
+
+int Address::getSipAddressesCacheSize() {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	return cache.entries.getSize();
+}
+
+uint64_t Address::getSipAddressesCacheHits() {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	return cache.hits;
+}
+
+uint64_t Address::getSipAddressesCacheMisses() {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	return cache.misses;
+}
+
+uint64_t Address::getSipAddressesCacheEvictions() {
+	SalAddressCache &cache = getSalAddressCache();
+	lock_guard<mutex> lock(cache.mutex);
+	return cache.evictions;
 }
 
 bool Address::isValid() const {
@@ -188,6 +267,7 @@ bool Address::setDisplayName(const string &displayName) {
 	if (!mImpl) return false;
 
 	sal_address_set_display_name(mImpl, L_STRING_TO_C(displayName));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -203,6 +283,7 @@ bool Address::setUsername(const string &username) {
 	if (!mImpl) return false;
 
 	sal_address_set_username(mImpl, L_STRING_TO_C(username));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -218,6 +299,7 @@ bool Address::setDomain(const string &domain) {
 	if (!mImpl) return false;
 
 	sal_address_set_domain(mImpl, L_STRING_TO_C(domain));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -229,6 +311,7 @@ bool Address::setPort(int port) {
 	if (!mImpl) return false;
 
 	sal_address_set_port(mImpl, port);
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -240,6 +323,7 @@ bool Address::setTransport(Transport transport) {
 	if (!mImpl) return false;
 
 	sal_address_set_transport(mImpl, static_cast<SalTransport>(transport));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -251,6 +335,7 @@ bool Address::setSecure(bool enabled) {
 	if (!mImpl) return false;
 
 	sal_address_set_secure(mImpl, enabled);
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -261,6 +346,7 @@ bool Address::isSip() const {
 bool Address::setMethodParam(const std::string &value) {
 	if (!mImpl) return false;
 	sal_address_set_method_param(mImpl, value.c_str());
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -284,6 +370,7 @@ bool Address::setPassword(const string &password) {
 	if (!mImpl) return false;
 
 	sal_address_set_password(mImpl, L_STRING_TO_C(password));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -291,6 +378,7 @@ bool Address::clean() {
 	if (!mImpl) return false;
 
 	sal_address_clean(mImpl);
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -305,59 +393,64 @@ std::string Address::toString() const {
 	return ret;
 }
 
-string Address::toStringUriOnlyOrdered(bool lowercaseParams) const {
-	ostringstream res;
-	res << getScheme() << ":";
-	if (!getUsername().empty()) {
-		char *tmp = belle_sip_uri_to_escaped_username(getUsername().c_str());
-		res << tmp << "@";
+void Address::computeOrderedKey(OrderedKey &key, bool lowercaseParams) const {
+	auto appendParams = [&key, lowercaseParams](const map<string, string> &params) {
+		for (const auto &[name, value] : params) {
+			key.value += ";";
+			key.value += lowercaseParams ? Utils::stringToLower(name) : name;
+			if (!value.empty()) {
+				key.value += "=";
+				key.value += lowercaseParams ? Utils::stringToLower(value) : value;
+			}
+		}
+	};
+
+	key.value = getScheme();
+	key.value += ":";
+	const char *username = getUsernameCstr();
+	if (username && username[0] != '\0') {
+		char *tmp = belle_sip_uri_to_escaped_username(username);
+		key.value += tmp;
+		key.value += "@";
 		ms_free(tmp);
 	}
 
-	if (getDomain().find(":") != string::npos) {
-		res << "[" << getDomain() << "]";
+	const string domain = getDomain();
+	if (domain.find(":") != string::npos) {
+		key.value += "[";
+		key.value += domain;
+		key.value += "]";
 	} else {
-		res << getDomain();
+		key.value += domain;
 	}
 
 	const auto uriParams = getUriParams();
-	for (const auto &param : uriParams) {
-		auto name = param.first;
-		if (lowercaseParams) {
-			std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return tolower(c); });
-		}
-		res << ";" << name;
-		auto value = param.second;
-		if (!value.empty()) {
-			if (lowercaseParams) {
-				std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return tolower(c); });
-			}
-			res << "=" << value;
-		}
-	}
-	return res.str();
+	appendParams(uriParams);
+	key.uriOnlyLength = key.value.size();
+	// The ordered form has always carried the URI parameters twice, keep it so that stored keys remain valid.
+	appendParams(uriParams);
+}
+
+void Address::invalidateOrderedKeys() {
+	mOrderedKey.value.clear();
+	mLowercaseOrderedKey.value.clear();
+}
+
+const string &Address::getOrderedKey(bool lowercaseParams) const {
+	OrderedKey &key = lowercaseParams ? mLowercaseOrderedKey : mOrderedKey;
+	// A computed key is never empty as it contains at least the scheme separator.
+	if (key.value.empty()) computeOrderedKey(key, lowercaseParams);
+	return key.value;
+}
+
+string Address::toStringUriOnlyOrdered(bool lowercaseParams) const {
+	const string &key = getOrderedKey(lowercaseParams);
+	const OrderedKey &orderedKey = lowercaseParams ? mLowercaseOrderedKey : mOrderedKey;
+	return key.substr(0, orderedKey.uriOnlyLength);
 }
 
 string Address::toStringOrdered(bool lowercaseParams) const {
-	auto res = toStringUriOnlyOrdered(lowercaseParams);
-	const auto uriParams = getUriParams();
-	for (const auto &param : uriParams) {
-		auto name = param.first;
-		if (lowercaseParams) {
-			std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return tolower(c); });
-		}
-		res += ";";
-		res += name;
-		auto value = param.second;
-		if (!value.empty()) {
-			if (lowercaseParams) {
-				std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return tolower(c); });
-			}
-			res += "=";
-			res += value;
-		}
-	}
-	return res;
+	return getOrderedKey(lowercaseParams);
 }
 
 char *Address::toStringUriOnlyOrderedCstr(bool lowercaseParams) const {
@@ -380,6 +473,16 @@ bool Address::weakEqual(const Address &address) const {
 	return !!sal_address_weak_equals(mImpl, address.mImpl);
 }
 
+string Address::getWeakKey() const {
+	// Coarser than weakEqual(): sal_address_weak_equals() compares the username with its case and the port too, so
+	// addresses weakly equal share this key but addresses sharing it must still be confirmed with weakEqual().
+	if (!isSip()) return string();
+	string key = Utils::stringToLower(getUsername());
+	key += '\0';
+	key += Utils::stringToLower(getDomain());
+	return key;
+}
+
 bool Address::uriEqual(const Address &other) const {
 	return !!sal_address_uri_equals(mImpl, other.mImpl);
 }
@@ -396,6 +499,7 @@ bool Address::setHeader(const string &headerName, const string &headerValue) {
 	if (!mImpl) return false;
 
 	sal_address_set_header(mImpl, L_STRING_TO_C(headerName), L_STRING_TO_C(headerValue));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -415,6 +519,7 @@ bool Address::setParam(const string &paramName, const string &paramValue) {
 	if (!mImpl) return false;
 
 	sal_address_set_param(mImpl, L_STRING_TO_C(paramName), L_STRING_TO_C(paramValue));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -422,6 +527,7 @@ bool Address::setParams(const string &params) {
 	if (!mImpl) return false;
 
 	sal_address_set_params(mImpl, L_STRING_TO_C(params));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -429,6 +535,7 @@ bool Address::removeParam(const string &uriParamName) {
 	if (!mImpl) return false;
 
 	sal_address_remove_param(mImpl, L_STRING_TO_C(uriParamName));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -448,6 +555,7 @@ bool Address::setUriParam(const string &uriParamName, const string &uriParamValu
 	if (!mImpl) return false;
 
 	sal_address_set_uri_param(mImpl, L_STRING_TO_C(uriParamName), L_STRING_TO_C(uriParamValue));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -455,6 +563,7 @@ bool Address::setUriParams(const string &uriParams) {
 	if (!mImpl) return false;
 
 	sal_address_set_uri_params(mImpl, L_STRING_TO_C(uriParams));
+	invalidateOrderedKeys();
 	return true;
 }
 
@@ -462,6 +571,7 @@ bool Address::removeUriParam(const string &uriParamName) {
 	if (!mImpl) return false;
 
 	sal_address_remove_uri_param(mImpl, L_STRING_TO_C(uriParamName));
+	invalidateOrderedKeys();
 	return true;
 }
 
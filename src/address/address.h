@@ -140,11 +140,16 @@ public:
 	char *toStringUriOnlyOrderedCstr(bool lowercaseParams = false) const;
 	std::string toStringUriOnlyOrdered(bool lowercaseParams = false) const;
 	std::string toStringOrdered(bool lowercaseParams = false) const;
+	// Canonical form of toStringOrdered(), computed on first use and kept until the address is modified.
+	const std::string &getOrderedKey(bool lowercaseParams = false) const;
 
 	std::string asStringUriOnly() const;
 
 	bool clean();
 	bool weakEqual(const Address &other) const;
+	// Case-folded username and domain, shared by all the addresses weakly equal to this one, to bucket addresses in
+	// hash tables. Addresses with the same key are not necessarily weakly equal: confirm them with weakEqual().
+	std::string getWeakKey() const;
 	bool uriEqual(const Address &other) const;
 
 	inline const SalAddress *getImpl() const {
@@ -152,7 +157,14 @@ public:
 	}
 	void setImpl(SalAddress *value);
 	void setImpl(const SalAddress *value);
+	// Parsed addresses are kept in a size-bounded LRU cache shared by all the cores of the process.
 	static void clearSipAddressesCache();
+	static void setSipAddressesCacheCapacity(int capacity);
+	static int getSipAddressesCacheCapacity();
+	static int getSipAddressesCacheSize();
+	static uint64_t getSipAddressesCacheHits();
+	static uint64_t getSipAddressesCacheMisses();
+	static uint64_t getSipAddressesCacheEvictions();
 
 protected:
 	static SalAddress *getSalAddressFromCache(const std::string &address, bool assumeGrUri);
@@ -166,7 +178,17 @@ private:
 	};
 	static void removeFromLeakDetector(SalAddress *addr);
 
-	static std::unordered_map<std::string, std::unique_ptr<SalAddress, SalAddressDeleter>> sAddressCache;
+	struct OrderedKey {
+		std::string value;
+		size_t uriOnlyLength = 0;
+	};
+	void computeOrderedKey(OrderedKey &key, bool lowercaseParams) const;
+	void invalidateOrderedKeys();
+	mutable OrderedKey mOrderedKey;
+	mutable OrderedKey mLowercaseOrderedKey;
+
+	struct SalAddressCache;
+	static SalAddressCache &getSalAddressCache();
 };
 
 inline std::ostream &operator<<(std::ostream &os, const Address &address) {
@@ -325,6 +325,15 @@ bctbx_list_t *linphone_chat_room_get_history_range_message_events(LinphoneChatRo
 	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(AbstractChatRoom::toCpp(cr)->getMessageHistoryRange(startm, endm));
 }
 
+bctbx_list_t *linphone_chat_room_get_history_range_message_events_near(LinphoneChatRoom *cr,
+                                                                       unsigned int before,
+                                                                       unsigned int after,
+                                                                       LinphoneEventLog *event) {
+	ChatRoomLogContextualizer logContextualizer(cr);
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(AbstractChatRoom::toCpp(cr)->getMessageHistoryRangeNear(
+	    before, after, event ? L_GET_CPP_PTR_FROM_C_OBJECT(event) : nullptr));
+}
+
 bctbx_list_t *linphone_chat_room_get_history_message_events(LinphoneChatRoom *cr, int nb_events) {
 	ChatRoomLogContextualizer logContextualizer(cr);
 	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(AbstractChatRoom::toCpp(cr)->getMessageHistory(nb_events));
@@ -340,6 +349,15 @@ bctbx_list_t *linphone_chat_room_get_history_range_events(LinphoneChatRoom *cr,
 	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(AbstractChatRoom::toCpp(cr)->getHistoryRange(begin, end));
 }
 
+bctbx_list_t *linphone_chat_room_get_history_range_events_near(LinphoneChatRoom *cr,
+                                                               unsigned int before,
+                                                               unsigned int after,
+                                                               LinphoneEventLog *event) {
+	ChatRoomLogContextualizer logContextualizer(cr);
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(AbstractChatRoom::toCpp(cr)->getHistoryRangeNear(
+	    before, after, event ? L_GET_CPP_PTR_FROM_C_OBJECT(event) : nullptr));
+}
+
 int linphone_chat_room_get_history_events_size(LinphoneChatRoom *cr) {
 	ChatRoomLogContextualizer logContextualizer(cr);
 	return AbstractChatRoom::toCpp(cr)->getHistorySize();
@@ -361,6 +379,13 @@ LinphoneChatMessage *linphone_chat_room_find_message(LinphoneChatRoom *cr, const
 	return linphone_chat_message_ref(L_GET_C_BACK_PTR(cppPtr));
 }
 
+bctbx_list_t *
+linphone_chat_room_search_chat_messages(LinphoneChatRoom *cr, const char *text, unsigned int limit, unsigned int cursor) {
+	ChatRoomLogContextualizer logContextualizer(cr);
+	return L_GET_RESOLVED_C_LIST_FROM_CPP_LIST(
+	    AbstractChatRoom::toCpp(cr)->searchChatMessages(L_C_TO_STRING(text), limit, cursor));
+}
+
 LinphoneChatRoomState linphone_chat_room_get_state(const LinphoneChatRoom *cr) {
 	ChatRoomLogContextualizer logContextualizer(cr);
 	return linphone_conference_state_to_chat_room_state(
@@ -20,6 +20,7 @@
 
 #include <bctoolbox/defs.h>
 
+#include "address/address.h"
 #include "auth-info/auth-info.h"
 #include "c-wrapper/c-wrapper.h"
 #include "conference/participant-info.h"
@@ -352,6 +353,30 @@ void linphone_factory_set_cache_dir(LinphoneFactory *factory, const char *path)
 	Factory::toCpp(factory)->setCacheDir(path ? path : "");
 }
 
+void linphone_factory_set_address_cache_capacity(BCTBX_UNUSED(LinphoneFactory *factory), int capacity) {
+	Address::setSipAddressesCacheCapacity(capacity);
+}
+
+int linphone_factory_get_address_cache_capacity(BCTBX_UNUSED(const LinphoneFactory *factory)) {
+	return Address::getSipAddressesCacheCapacity();
+}
+
+int linphone_factory_get_address_cache_size(BCTBX_UNUSED(const LinphoneFactory *factory)) {
+	return Address::getSipAddressesCacheSize();
+}
+
+uint64_t linphone_factory_get_address_cache_hits(BCTBX_UNUSED(const LinphoneFactory *factory)) {
+	return Address::getSipAddressesCacheHits();
+}
+
+uint64_t linphone_factory_get_address_cache_misses(BCTBX_UNUSED(const LinphoneFactory *factory)) {
+	return Address::getSipAddressesCacheMisses();
+}
+
+uint64_t linphone_factory_get_address_cache_evictions(BCTBX_UNUSED(const LinphoneFactory *factory)) {
+	return Address::getSipAddressesCacheEvictions();
+}
+
 LinphoneErrorInfo *linphone_factory_create_error_info(LinphoneFactory *factory) {
 	return Factory::toCpp(factory)->createErrorInfo();
 }
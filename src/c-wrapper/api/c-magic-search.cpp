@@ -163,6 +163,26 @@ void linphone_magic_search_set_limited_search(LinphoneMagicSearch *magic_search,
 	L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->setLimitedSearch(!!limited);
 }
 
+bool_t linphone_magic_search_get_use_ngram_index(const LinphoneMagicSearch *magic_search) {
+	return L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->getUseNgramIndex();
+}
+
+void linphone_magic_search_set_use_ngram_index(LinphoneMagicSearch *magic_search, bool_t enable) {
+	L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->setUseNgramIndex(!!enable);
+}
+
+bool_t linphone_magic_search_get_notify_partial_results(const LinphoneMagicSearch *magic_search) {
+	return L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->getNotifyPartialResults();
+}
+
+void linphone_magic_search_set_notify_partial_results(LinphoneMagicSearch *magic_search, bool_t enable) {
+	L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->setNotifyPartialResults(!!enable);
+}
+
+bool_t linphone_magic_search_is_last_search_partial(const LinphoneMagicSearch *magic_search) {
+	return L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->isLastSearchPartial();
+}
+
 void linphone_magic_search_reset_search_cache(LinphoneMagicSearch *magic_search) {
 	L_GET_CPP_PTR_FROM_C_OBJECT(magic_search)->resetSearchCache();
 }
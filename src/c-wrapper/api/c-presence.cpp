@@ -707,6 +707,16 @@ void linphone_notify_parse_presence(const char *content_type,
 	                             result);
 }
 
+void linphone_presence_model_enable_streaming_pidf_parser(bool_t enable) {
+	PresenceModel::enableStreamingPidfParser(!!enable);
+}
+
+LinphonePresenceModel *linphone_presence_model_parse_pidf(const char *body) {
+	SalPresenceModel *result = nullptr;
+	linphone_notify_parse_presence("application", "pidf+xml", body, &result);
+	return (LinphonePresenceModel *)result;
+}
+
 void linphone_notify_recv(LinphoneCore *lc, SalOp *op, SalSubscribeStatus ss, SalPresenceModel *model) {
 	std::shared_ptr<PresenceModel> presence;
 	if (model) {
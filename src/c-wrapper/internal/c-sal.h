@@ -549,6 +549,10 @@ void sal_cancel_timer(Sal *sal, belle_sip_source_t *timer);
 // *encoding);
 SalBodyHandler *sal_body_handler_new(void);
 SalBodyHandler *sal_body_handler_new_from_buffer(const void *data, size_t size);
+// The clone keeps the content encoding applied to the buffer, but not the state of a transfer.
+SalBodyHandler *sal_body_handler_clone(const SalBodyHandler *body_handler);
+// Only applies to memory body handlers. Returns 0 on success.
+int sal_body_handler_apply_encoding(SalBodyHandler *body_handler, const char *encoding);
 SalBodyHandler *sal_body_handler_ref(SalBodyHandler *body_handler);
 void sal_body_handler_unref(SalBodyHandler *body_handler);
 const char *sal_body_handler_get_type(const SalBodyHandler *body_handler);
@@ -21,6 +21,8 @@
 #ifndef _L_CHAT_MESSAGE_P_H_
 #define _L_CHAT_MESSAGE_P_H_
 
+#include <unordered_map>
+
 #include <belle-sip/types.h>
 
 #include "chat/chat-message/chat-message.h"
@@ -119,7 +121,13 @@ public:
 		contentsNotLoadedFromDatabase = true;
 	}
 
+	bool hasContentsNotLoadedFromDatabase() const {
+		return contentsNotLoadedFromDatabase;
+	}
+
 	void loadContentsFromDatabase() const;
+	// Called by MainDb with the contents read from database, possibly for a whole page of messages at once.
+	void setContentsFromDatabase(const std::list<std::shared_ptr<Content>> &dbContents);
 
 	std::list<std::shared_ptr<Content>> &getContents() {
 		loadContentsFromDatabase();
@@ -262,6 +270,32 @@ private:
 	// Keep setState private as the chat message state must only be set through setParticipantState
 	virtual void setState(ChatMessage::State newState);
 
+	// In-memory copy of the participant states stored in database. It is loaded once so that an IMDN does not have to
+	// reload all of them to compute the global state of the message.
+	struct CachedParticipantState {
+		ChatMessage::State state;
+		bool isSender;
+		// Participants that are no longer in the chat room do not count in the global state.
+		bool counted;
+	};
+
+	struct ParticipantStateCounters {
+		size_t recipients = 0;
+		size_t displayed = 0;
+		size_t deliveredToUser = 0;
+		size_t delivered = 0;
+		size_t notDelivered = 0;
+	};
+
+	void loadParticipantStates(const std::shared_ptr<EventLog> &eventLog);
+	void invalidateParticipantStates();
+	void recordParticipantState(const std::string &key,
+	                            const std::shared_ptr<Address> &participantAddress,
+	                            bool counted,
+	                            ChatMessage::State newState);
+	void countParticipantState(const CachedParticipantState &participantState, int delta);
+	static std::string getParticipantStateKey(const Address &participantAddress);
+
 	ChatMessagePrivate(const std::shared_ptr<AbstractChatRoom> &chatRoom, ChatMessage::Direction dir);
 	virtual ~ChatMessagePrivate();
 
@@ -319,6 +353,12 @@ private:
 	bool encryptionPrevented = false;
 	mutable bool contentsNotLoadedFromDatabase = false;
 
+	std::unordered_map<std::string, CachedParticipantState> participantStates;
+	ParticipantStateCounters participantStateCounters;
+	bool participantStatesLoaded = false;
+	// Participants version of the conference when the states were loaded, see loadParticipantStates().
+	unsigned int participantStatesVersion = 0;
+
 	std::list<std::shared_ptr<ChatMessageListener>> listeners;
 	L_DECLARE_PUBLIC(ChatMessage);
 };
@@ -82,6 +82,7 @@ void ChatMessagePrivate::setStorageId(long long id) {
 	}
 
 	storageId = id;
+	invalidateParticipantStates();
 }
 
 void ChatMessagePrivate::resetStorageId() {
@@ -122,11 +123,14 @@ void ChatMessagePrivate::setParticipantState(const std::shared_ptr<Address> &par
 	    (chatRoom->getCurrentParams()->getChatParams()->getBackend() == ChatParams::Backend::Basic);
 	unique_ptr<MainDb> &mainDb = chatRoom->getCore()->getPrivate()->mainDb;
 	shared_ptr<EventLog> eventLog = mainDb->getEvent(mainDb, q->getStorageId());
+	const string participantKey = getParticipantStateKey(*participantAddress);
 	ChatMessage::State currentState = ChatMessage::State::Idle;
 	if (isBasicChatRoom) {
 		currentState = q->getState();
 	} else if (eventLog) {
-		currentState = mainDb->getChatMessageParticipantState(eventLog, participantAddress);
+		loadParticipantStates(eventLog);
+		const auto it = participantStates.find(participantKey);
+		if (it != participantStates.cend()) currentState = it->second.state;
 	}
 
 	if (!isValidStateTransition(currentState, newState)) {
@@ -206,6 +210,7 @@ void ChatMessagePrivate::setParticipantState(const std::shared_ptr<Address> &par
 	        << Utils::toString(newState);
 	if (eventLog) {
 		mainDb->setChatMessageParticipantState(eventLog, participantAddress, newState, stateChangeTime);
+		recordParticipantState(participantKey, participantAddress, participant != nullptr, newState);
 	}
 
 	// Update chat message state if it doesn't depend on IMDN
@@ -214,48 +219,16 @@ void ChatMessagePrivate::setParticipantState(const std::shared_ptr<Address> &par
 	}
 
 	if (isImdnControlledState(newState)) {
-		const auto imdnStates = q->getParticipantsState();
-		size_t nbRecipients = 0;
-		size_t nbDisplayedStates = 0;
-		size_t nbDeliveredStates = 0;
-		size_t nbDeliveredToUserStates = 0;
-		size_t nbNotDeliveredStates = 0;
-		for (const auto &imdnState : imdnStates) {
-			const auto &participantState = imdnState.getState();
-			const auto &imdnParticipant = imdnState.getParticipant();
-			if (fromAddress->weakEqual(*(imdnParticipant->getAddress()))) {
-				if (participantState == ChatMessage::State::NotDelivered) {
-					nbNotDeliveredStates++;
-				}
-			} else {
-				nbRecipients++;
-				switch (participantState) {
-					case ChatMessage::State::Displayed:
-						nbDisplayedStates++;
-						break;
-					case ChatMessage::State::DeliveredToUser:
-						nbDeliveredToUserStates++;
-						break;
-					case ChatMessage::State::Delivered:
-						nbDeliveredStates++;
-						break;
-					case ChatMessage::State::NotDelivered:
-						nbNotDeliveredStates++;
-						break;
-					default:
-						break;
-				}
-			}
-		}
-
-		if (nbNotDeliveredStates > 0) {
+		const ParticipantStateCounters &counters = participantStateCounters;
+		if (counters.notDelivered > 0) {
 			setState(ChatMessage::State::NotDelivered);
-		} else if ((nbRecipients > 0) && (nbDisplayedStates == nbRecipients)) {
+		} else if ((counters.recipients > 0) && (counters.displayed == counters.recipients)) {
 			setState(ChatMessage::State::Displayed);
-		} else if ((nbRecipients > 0) && ((nbDisplayedStates + nbDeliveredToUserStates) == nbRecipients)) {
+		} else if ((counters.recipients > 0) &&
+		           ((counters.displayed + counters.deliveredToUser) == counters.recipients)) {
 			setState(ChatMessage::State::DeliveredToUser);
-		} else if ((nbRecipients > 0) &&
-		           ((nbDeliveredStates + nbDisplayedStates + nbDeliveredToUserStates) == nbRecipients)) {
+		} else if ((counters.recipients > 0) &&
+		           ((counters.delivered + counters.displayed + counters.deliveredToUser) == counters.recipients)) {
 			setState(ChatMessage::State::Delivered);
 		}
 	}
@@ -275,6 +248,98 @@ void ChatMessagePrivate::setParticipantState(const std::shared_ptr<Address> &par
 	}
 }
 
+string ChatMessagePrivate::getParticipantStateKey(const Address &participantAddress) {
+	// Participant states are stored without gruu.
+	return participantAddress.getUriWithoutGruu().toStringUriOnlyOrdered();
+}
+
+void ChatMessagePrivate::countParticipantState(const CachedParticipantState &participantState, int delta) {
+	if (!participantState.counted) return;
+
+	auto add = [delta](size_t &counter) { counter = size_t(ptrdiff_t(counter) + delta); };
+	ParticipantStateCounters &counters = participantStateCounters;
+	if (participantState.isSender) {
+		if (participantState.state == ChatMessage::State::NotDelivered) add(counters.notDelivered);
+		return;
+	}
+
+	add(counters.recipients);
+	switch (participantState.state) {
+		case ChatMessage::State::Displayed:
+			add(counters.displayed);
+			break;
+		case ChatMessage::State::DeliveredToUser:
+			add(counters.deliveredToUser);
+			break;
+		case ChatMessage::State::Delivered:
+			add(counters.delivered);
+			break;
+		case ChatMessage::State::NotDelivered:
+			add(counters.notDelivered);
+			break;
+		default:
+			break;
+	}
+}
+
+void ChatMessagePrivate::loadParticipantStates(const shared_ptr<EventLog> &eventLog) {
+	L_Q();
+
+	const auto &chatRoom = q->getChatRoom();
+	// Only states of current participants are counted, so they are loaded again when participants change.
+	const auto &conference = chatRoom->getConference();
+	const unsigned int participantsVersion = conference ? conference->getParticipantsVersion() : 0;
+	if (participantStatesLoaded && participantStatesVersion == participantsVersion) return;
+
+	unique_ptr<MainDb> &mainDb = chatRoom->getCore()->getPrivate()->mainDb;
+	invalidateParticipantStates();
+	for (const auto &dbResult : mainDb->getChatMessageParticipantStates(eventLog)) {
+		const bool counted = chatRoom->isMe(dbResult.address) || chatRoom->findParticipant(dbResult.address);
+		const CachedParticipantState participantState = {dbResult.state, fromAddress->weakEqual(*dbResult.address),
+		                                                  counted};
+		const string key = getParticipantStateKey(*dbResult.address);
+		const auto it = participantStates.find(key);
+		if (it != participantStates.cend()) countParticipantState(it->second, -1);
+		countParticipantState(participantState, 1);
+		participantStates[key] = participantState;
+	}
+	participantStatesLoaded = true;
+	// Participants of lazily loaded chat rooms may have been loaded by the lookups above.
+	participantStatesVersion = conference ? conference->getParticipantsVersion() : 0;
+}
+
+void ChatMessagePrivate::invalidateParticipantStates() {
+	participantStates.clear();
+	participantStateCounters = ParticipantStateCounters();
+	participantStatesLoaded = false;
+}
+
+void ChatMessagePrivate::recordParticipantState(const string &key,
+                                                const shared_ptr<Address> &participantAddress,
+                                                bool counted,
+                                                ChatMessage::State newState) {
+	if (!participantStatesLoaded) return;
+
+	const auto it = participantStates.find(key);
+	if (it == participantStates.cend()) {
+		const CachedParticipantState participantState = {newState, fromAddress->weakEqual(*participantAddress),
+		                                                  counted};
+		countParticipantState(participantState, 1);
+		participantStates.emplace(key, participantState);
+		return;
+	}
+
+	// Same rule as MainDb: Displayed and DeliveredToUser states are never downgraded.
+	CachedParticipantState &participantState = it->second;
+	if (int(newState) < int(participantState.state) && (participantState.state == ChatMessage::State::Displayed ||
+	                                                    participantState.state == ChatMessage::State::DeliveredToUser))
+		return;
+
+	countParticipantState(participantState, -1);
+	participantState.state = newState;
+	countParticipantState(participantState, 1);
+}
+
 void ChatMessagePrivate::setState(ChatMessage::State newState) {
 	L_Q();
 
@@ -304,6 +369,7 @@ void ChatMessagePrivate::setState(ChatMessage::State newState) {
 	if (direction == ChatMessage::Direction::Outgoing) {
 		// Delivered state isn't triggered by IMDN, so participants state won't be set unless we manually do so here
 		if (state == ChatMessage::State::Delivered) {
+			MainDb::WriteBatch writeBatch(chatRoom->getCore()->getPrivate()->mainDb);
 			// Use list of participants the client is sure have received the message and not the actual list of
 			// participants being part of the chatroom
 			for (const auto &imdnState : q->getParticipantsState()) {
@@ -368,6 +434,9 @@ void ChatMessagePrivate::setState(ChatMessage::State newState) {
 	if (state != ChatMessage::State::InProgress && state != ChatMessage::State::FileTransferError &&
 	    state != ChatMessage::State::FileTransferInProgress) {
 		updateInDb();
+		// Storing these states may update the states of all participants.
+		if (state == ChatMessage::State::Delivered || state == ChatMessage::State::NotDelivered)
+			invalidateParticipantStates();
 	}
 }
 
@@ -1673,13 +1742,30 @@ void ChatMessagePrivate::loadContentsFromDatabase() const {
 	L_Q();
 
 	if (contentsNotLoadedFromDatabase) {
-		isReadOnly = false;
-		contentsNotLoadedFromDatabase = false;
 		q->getChatRoom()->getCore()->getPrivate()->mainDb->loadChatMessageContents(
 		    const_pointer_cast<ChatMessage>(q->getSharedFromThis()));
+	}
+}
 
-		isReadOnly = true;
+void ChatMessagePrivate::setContentsFromDatabase(const list<shared_ptr<Content>> &dbContents) {
+	L_Q();
+
+	if (!contentsNotLoadedFromDatabase) return;
+
+	isReadOnly = false;
+	contentsNotLoadedFromDatabase = false;
+
+	bool hasFileTransferContent = false;
+	for (const auto &content : dbContents) {
+		if (content->isFileTransfer()) hasFileTransferContent = true;
+		else if (content->isFile()) static_pointer_cast<FileContent>(content)->setCreationTimestamp(q->getTime());
+		q->addContent(content);
 	}
+
+	// Load external body url from body into FileTransferContent if needed.
+	if (hasFileTransferContent) loadFileTransferUrlFromBodyToContent();
+
+	isReadOnly = true;
 }
 
 bool ChatMessage::isRead() const {
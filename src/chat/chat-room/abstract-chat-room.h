@@ -120,10 +120,14 @@ public:
 
 	virtual std::list<std::shared_ptr<EventLog>> getMessageHistory(int nLast) const = 0;
 	virtual std::list<std::shared_ptr<EventLog>> getMessageHistoryRange(int begin, int end) const = 0;
+	virtual std::list<std::shared_ptr<EventLog>> getMessageHistoryRangeNear(
+	    unsigned int before, unsigned int after, const std::shared_ptr<const EventLog> &event) const = 0;
 	virtual std::list<std::shared_ptr<ChatMessage>> getUnreadChatMessages() const = 0;
 	virtual int getMessageHistorySize() const = 0;
 	virtual std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const = 0;
 	virtual std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const = 0;
+	virtual std::list<std::shared_ptr<EventLog>>
+	getHistoryRangeNear(unsigned int before, unsigned int after, const std::shared_ptr<const EventLog> &event) const = 0;
 	virtual int getHistorySize() const = 0;
 
 	virtual void deleteFromDb() = 0;
@@ -153,6 +157,8 @@ public:
 	                                                     ChatMessage::Direction direction) const = 0;
 	virtual std::list<std::shared_ptr<ChatMessage>>
 	findChatMessages(const std::list<std::string> &messageIds) const = 0;
+	virtual std::list<std::shared_ptr<ChatMessage>>
+	searchChatMessages(const std::string &text, unsigned int limit, unsigned int cursor) const = 0;
 
 	virtual void sendPendingMessages(){};
 
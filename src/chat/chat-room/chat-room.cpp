@@ -342,6 +342,11 @@ list<shared_ptr<ChatMessage>> ChatRoom::findChatMessages(const list<string> &mes
 	return getCore()->getPrivate()->mainDb->findChatMessages(getConferenceId(), messageIds);
 }
 
+list<shared_ptr<ChatMessage>>
+ChatRoom::searchChatMessages(const string &text, unsigned int limit, unsigned int cursor) const {
+	return getCore()->getPrivate()->mainDb->searchChatMessages(text, getConferenceId(), limit, cursor);
+}
+
 // -----------------------------------------------------------------------------
 
 void ChatRoom::sendDeliveryErrorNotification(const shared_ptr<ChatMessage> &chatMessage, LinphoneReason reason) {
@@ -645,6 +650,13 @@ list<shared_ptr<EventLog>> ChatRoom::getMessageHistoryRange(int begin, int end)
 	                                                        MainDb::Filter::ConferenceChatMessageFilter);
 }
 
+list<shared_ptr<EventLog>> ChatRoom::getMessageHistoryRangeNear(unsigned int before,
+                                                               unsigned int after,
+                                                               const shared_ptr<const EventLog> &event) const {
+	return getCore()->getPrivate()->mainDb->getHistoryRangeNear(getConferenceId(), before, after, event,
+	                                                            MainDb::Filter::ConferenceChatMessageFilter);
+}
+
 list<shared_ptr<ChatMessage>> ChatRoom::getUnreadChatMessages() const {
 	return getCore()->getPrivate()->mainDb->getUnreadChatMessages(getConferenceId());
 }
@@ -668,6 +680,14 @@ list<shared_ptr<EventLog>> ChatRoom::getHistoryRange(int begin, int end) const {
 	        {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
 }
 
+list<shared_ptr<EventLog>>
+ChatRoom::getHistoryRangeNear(unsigned int before, unsigned int after, const shared_ptr<const EventLog> &event) const {
+	return getCore()->getPrivate()->mainDb->getHistoryRangeNear(
+	    getConferenceId(), before, after, event,
+	    MainDb::FilterMask(
+	        {MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter}));
+}
+
 int ChatRoom::getHistorySize() const {
 	return getCore()->getPrivate()->mainDb->getHistorySize(getConferenceId());
 }
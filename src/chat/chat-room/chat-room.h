@@ -58,10 +58,14 @@ public:
 
 	std::list<std::shared_ptr<EventLog>> getMessageHistory(int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getMessageHistoryRange(int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getMessageHistoryRangeNear(
+	    unsigned int before, unsigned int after, const std::shared_ptr<const EventLog> &event) const override;
 	std::list<std::shared_ptr<ChatMessage>> getUnreadChatMessages() const override;
 	int getMessageHistorySize() const override;
 	std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getHistoryRangeNear(
+	    unsigned int before, unsigned int after, const std::shared_ptr<const EventLog> &event) const override;
 	int getHistorySize() const override;
 
 	void deleteFromDb() override;
@@ -90,6 +94,8 @@ public:
 	                                             ChatMessage::Direction direction) const override;
 	std::list<std::shared_ptr<ChatMessage>> findChatMessages(const std::string &messageId) const;
 	std::list<std::shared_ptr<ChatMessage>> findChatMessages(const std::list<std::string> &messageIds) const override;
+	std::list<std::shared_ptr<ChatMessage>>
+	searchChatMessages(const std::string &text, unsigned int limit, unsigned int cursor) const override;
 
 	void markAsRead() override;
 	void enableEphemeral(bool ephem, bool updateDb) override;
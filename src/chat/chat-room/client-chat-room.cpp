@@ -170,6 +170,16 @@ list<shared_ptr<EventLog>> ClientChatRoom::getHistoryRange(int begin, int end) c
 	                                  : MainDb::Filter::ConferenceChatMessageSecurityFilter);
 }
 
+list<shared_ptr<EventLog>> ClientChatRoom::getHistoryRangeNear(unsigned int before,
+                                                              unsigned int after,
+                                                              const shared_ptr<const EventLog> &event) const {
+	return getCore()->getPrivate()->mainDb->getHistoryRangeNear(
+	    getConferenceId(), before, after, event,
+	    getCurrentParams()->isGroup() ? MainDb::FilterMask({MainDb::Filter::ConferenceChatMessageFilter,
+	                                                        MainDb::Filter::ConferenceInfoNoDeviceFilter})
+	                                  : MainDb::Filter::ConferenceChatMessageSecurityFilter);
+}
+
 int ClientChatRoom::getHistorySize() const {
 	return getCore()->getPrivate()->mainDb->getHistorySize(
 	    getConferenceId(), getCurrentParams()->isGroup()
@@ -291,8 +301,14 @@ void ClientChatRoom::onRemotelyExhumedConference(SalCallOp *op) {
 	eventHandler->subscribe(getConferenceId());
 }
 
+void ClientChatRoom::addConferenceIdToPreviousList(const ConferenceId &confId) {
+	mPreviousConferenceIds.push_back(confId);
+	getCore()->getPrivate()->indexChatRoom(getSharedFromThis());
+}
+
 void ClientChatRoom::removeConferenceIdFromPreviousList(const ConferenceId &confId) {
 	mPreviousConferenceIds.remove(confId);
+	getCore()->getPrivate()->unindexPreviousConferenceId(confId, getSharedFromThis());
 	getCore()->getPrivate()->mainDb->removePreviousConferenceId(confId);
 }
 
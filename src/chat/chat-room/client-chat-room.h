@@ -56,6 +56,8 @@ public:
 
 	std::list<std::shared_ptr<EventLog>> getHistory(int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getHistoryRange(int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getHistoryRangeNear(
+	    unsigned int before, unsigned int after, const std::shared_ptr<const EventLog> &event) const override;
 	int getHistorySize() const override;
 	void exhume();
 
@@ -100,9 +102,7 @@ public:
 	void onLocallyExhumedConference(const std::shared_ptr<Address> &remoteContact);
 	void onRemotelyExhumedConference(SalCallOp *op);
 	void removeConferenceIdFromPreviousList(const ConferenceId &confId);
-	void addConferenceIdToPreviousList(const ConferenceId &confId) {
-		mPreviousConferenceIds.push_back(confId);
-	}
+	void addConferenceIdToPreviousList(const ConferenceId &confId);
 	const std::list<ConferenceId> &getPreviousConferenceIds() const {
 		return mPreviousConferenceIds;
 	};
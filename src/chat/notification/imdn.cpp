@@ -237,6 +237,8 @@ void Imdn::parse(const shared_ptr<ChatMessage> &chatMessage) {
 	// It seems to be more efficient to only make one database request to get all chat messages from their IMDN message
 	// ID
 	list<shared_ptr<ChatMessage>> chatMessages = cr->findChatMessages(messagesIds);
+	// Store all the participant states carried by this notification at once.
+	MainDb::WriteBatch writeBatch(cr->getCore()->getPrivate()->mainDb);
 	for (const auto &imdn : imdns) {
 		shared_ptr<ChatMessage> cm = nullptr;
 		for (const auto &chatMessage : chatMessages) {
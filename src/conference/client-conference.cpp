@@ -363,7 +363,7 @@ void ClientConference::confirmJoining(BCTBX_UNUSED(SalCallOp *op)) {
 					auto participant = findParticipant(address);
 					if (!participant) {
 						participant = Participant::create(getSharedFromThis(), address);
-						mParticipants.push_back(participant);
+						insertParticipant(participant);
 					}
 				}
 			}
@@ -1478,6 +1478,7 @@ void ClientConference::onParticipantsCleared() {
 	if (mConfParams->chatEnabled() && chatRoom) {
 		// clear from db as well
 		auto &mainDb = getCore()->getPrivate()->mainDb;
+		loadParticipants();
 		for (const auto &participant : mParticipants) {
 			mainDb->deleteChatRoomParticipant(chatRoom, participant->getAddress());
 			for (const auto &device : participant->getDevices()) {
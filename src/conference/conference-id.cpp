@@ -98,9 +98,9 @@ bool ConferenceId::isValid() const {
 
 size_t ConferenceId::getHash() const {
 	if (mHash == 0) {
-		const auto &pAddress = peerAddress ? peerAddress->toStringOrdered(true) : "sip:";
-		const auto &lAddress = localAddress ? localAddress->toStringOrdered(true) : "sip:";
-		mHash = hash<string>()(pAddress) ^ (hash<string>()(lAddress) << 1);
+		const size_t pHash = hash<string>()(peerAddress ? peerAddress->getOrderedKey(true) : "sip:");
+		const size_t lHash = hash<string>()(localAddress ? localAddress->getOrderedKey(true) : "sip:");
+		mHash = pHash ^ (lHash << 1);
 	}
 	return mHash;
 }
@@ -134,7 +134,7 @@ shared_ptr<Participant> Conference::getActiveParticipant() const {
 
 void Conference::clearParticipants() {
 	mMe->clearDevices();
-	mParticipants.clear();
+	setParticipantList({});
 }
 
 // -----------------------------------------------------------------------------
@@ -256,7 +256,7 @@ bool Conference::addParticipant(std::shared_ptr<Call> call) {
 			bool value = Utils::stob(remoteContactAddress->getParamValue("admin"));
 			p->setAdmin(value);
 		}
-		mParticipants.push_back(p);
+		insertParticipant(p);
 
 		time_t creationTime = time(nullptr);
 		notifyParticipantAdded(creationTime, false, p);
@@ -285,7 +285,7 @@ bool Conference::addParticipant(const std::shared_ptr<const Address> &participan
 	bool isFocus = participantAddress && confAddr && (*participantAddress == *confAddr);
 	participant->setFocus(isFocus);
 	participant->setPreserveSession(false);
-	mParticipants.push_back(participant);
+	insertParticipant(participant);
 	if (!mActiveParticipant) mActiveParticipant = participant;
 
 	const auto conferenceAddressStr =
@@ -328,8 +328,7 @@ bool Conference::addParticipants(const std::list<std::shared_ptr<Call>> &calls)
 }
 
 bool Conference::setParticipants(const std::list<std::shared_ptr<Participant>> &&newParticipants) {
-	mParticipants.clear();
-	mParticipants = std::move(newParticipants);
+	setParticipantList(std::list<std::shared_ptr<Participant>>(newParticipants));
 	return 0;
 }
 
@@ -402,7 +401,7 @@ int Conference::removeParticipant(const std::shared_ptr<CallSession> &session,
 	}
 	if (p->getDevices().empty()) {
 		lInfo() << "Remove participant with address " << *pAddress << " from conference " << *conferenceAddress;
-		mParticipants.remove(p);
+		eraseParticipant(p);
 		time_t creationTime = time(nullptr);
 		notifyParticipantRemoved(creationTime, false, p);
 		return 0;
@@ -462,7 +461,7 @@ bool Conference::removeParticipant(const std::shared_ptr<Participant> &participa
 			pSession->removeListener(this);
 		}
 	}
-	mParticipants.remove(conferenceParticipant);
+	eraseParticipant(conferenceParticipant);
 	return true;
 }
 
@@ -513,7 +512,7 @@ ConferenceInfo::participant_list_t Conference::getFullParticipantList() const {
 }
 
 int Conference::terminate() {
-	mParticipants.clear();
+	setParticipantList({});
 	return 0;
 }
 
@@ -606,6 +605,7 @@ void Conference::setConferenceAddress(const std::shared_ptr<Address> &conference
 }
 
 shared_ptr<Participant> Conference::getMe() const {
+	loadParticipants();
 	return mMe;
 }
 
@@ -614,12 +614,13 @@ int Conference::getParticipantCount() const {
 }
 
 const list<shared_ptr<Participant>> &Conference::getParticipants() const {
+	loadParticipants();
 	return mParticipants;
 }
 
 const list<shared_ptr<ParticipantDevice>> Conference::getParticipantDevices() const {
 	list<shared_ptr<ParticipantDevice>> devices;
-	for (const auto &p : mParticipants) {
+	for (const auto &p : getParticipants()) {
 		const auto &d = p->getDevices();
 		if (!d.empty()) {
 			devices.insert(devices.end(), d.begin(), d.end());
@@ -822,10 +823,86 @@ void Conference::setUsername(const string &username) {
 
 // -----------------------------------------------------------------------------
 
+void Conference::insertParticipant(const shared_ptr<Participant> &participant) {
+	loadParticipants();
+	mParticipants.push_back(participant);
+	mParticipantsVersion++;
+	mParticipantsByAddress.emplace(participant->getAddress()->getWeakKey(), participant);
+	indexChatRoom();
+}
+
+void Conference::eraseParticipant(const shared_ptr<Participant> &participant) {
+	loadParticipants();
+	mParticipants.remove(participant);
+	mParticipantsVersion++;
+	const auto range = mParticipantsByAddress.equal_range(participant->getAddress()->getWeakKey());
+	for (auto it = range.first; it != range.second;) {
+		if (it->second == participant) it = mParticipantsByAddress.erase(it);
+		else ++it;
+	}
+}
+
+void Conference::setParticipantList(list<shared_ptr<Participant>> &&participants) {
+	mParticipantsLoader = nullptr;
+	mParticipants = std::move(participants);
+	mParticipantsVersion++;
+	mParticipantsByAddress.clear();
+	mParticipantDevicesBySession.clear();
+	for (const auto &participant : mParticipants)
+		mParticipantsByAddress.emplace(participant->getAddress()->getWeakKey(), participant);
+	if (!mParticipants.empty()) indexChatRoom();
+}
+
+void Conference::setParticipantsLoader(std::function<void()> loader) {
+	mParticipantsLoader = std::move(loader);
+}
+
+void Conference::loadParticipants() const {
+	if (!mParticipantsLoader) return;
+	// The loader sets the participants, which must not call it again.
+	auto loader = std::move(mParticipantsLoader);
+	mParticipantsLoader = nullptr;
+	loader();
+}
+
+// One-to-one chat rooms are indexed by the core with their participant.
+void Conference::indexChatRoom() const {
+	if (mChatRoom) getCore()->getPrivate()->indexChatRoom(mChatRoom);
+}
+
+bool Conference::isIndexedParticipant(const shared_ptr<Participant> &participant) const {
+	const auto range = mParticipantsByAddress.equal_range(participant->getAddress()->getWeakKey());
+	return std::any_of(range.first, range.second, [&participant](const auto &entry) {
+		return entry.second == participant;
+	});
+}
+
+shared_ptr<ParticipantDevice>
+Conference::findCachedParticipantDevice(const shared_ptr<const CallSession> &session) const {
+	const auto it = mParticipantDevicesBySession.find(session.get());
+	if (it == mParticipantDevicesBySession.cend()) return nullptr;
+	auto device = it->second.lock();
+	auto participant = device ? device->getParticipant() : nullptr;
+	if (participant && (device->getSession() == session) && isIndexedParticipant(participant) &&
+	    (participant->findDevice(session, false) == device)) {
+		return device;
+	}
+	mParticipantDevicesBySession.erase(it);
+	return nullptr;
+}
+
 shared_ptr<Participant> Conference::findParticipant(const shared_ptr<const CallSession> &session) const {
+	loadParticipants();
+	const auto cachedDevice = findCachedParticipantDevice(session);
+	if (cachedDevice) return cachedDevice->getParticipant();
+
 	for (const auto &participant : mParticipants) {
-		shared_ptr<ParticipantDevice> device = participant->findDevice(session);
-		if (device || (participant->getSession() == session)) {
+		shared_ptr<ParticipantDevice> device = participant->findDevice(session, false);
+		if (device) {
+			mParticipantDevicesBySession[session.get()] = device;
+			return participant;
+		}
+		if (participant->getSession() == session) {
 			return participant;
 		}
 	}
@@ -837,9 +914,11 @@ shared_ptr<Participant> Conference::findParticipant(const shared_ptr<const CallS
 }
 
 shared_ptr<Participant> Conference::findParticipant(const std::shared_ptr<const Address> &addr) const {
-	for (const auto &participant : mParticipants) {
-		if (participant->getAddress()->weakEqual(*addr)) {
-			return participant;
+	loadParticipants();
+	const auto range = mParticipantsByAddress.equal_range(addr->getWeakKey());
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second->getAddress()->weakEqual(*addr)) {
+			return it->second;
 		}
 	}
 
@@ -867,6 +946,7 @@ Conference::findInvitedParticipant(const std::shared_ptr<const Address> &partici
 
 shared_ptr<ParticipantDevice> Conference::findParticipantDeviceByLabel(const LinphoneStreamType type,
                                                                        const std::string &label) const {
+	loadParticipants();
 	for (const auto &participant : mParticipants) {
 		auto device = participant->findDevice(type, label, false);
 		if (device) return device;
@@ -880,6 +960,7 @@ shared_ptr<ParticipantDevice> Conference::findParticipantDeviceByLabel(const Lin
 }
 
 shared_ptr<ParticipantDevice> Conference::findParticipantDeviceBySsrc(uint32_t ssrc, LinphoneStreamType type) const {
+	loadParticipants();
 	for (const auto &participant : mParticipants) {
 		auto device = participant->findDeviceBySsrc(ssrc, type);
 		if (device) {
@@ -896,9 +977,11 @@ shared_ptr<ParticipantDevice> Conference::findParticipantDeviceBySsrc(uint32_t s
 
 shared_ptr<ParticipantDevice> Conference::findParticipantDevice(const std::shared_ptr<const Address> &pAddr,
                                                                 const std::shared_ptr<const Address> &dAddr) const {
-	for (const auto &participant : mParticipants) {
-		if (pAddr->weakEqual(*participant->getAddress())) {
-			auto device = participant->findDevice(dAddr, false);
+	loadParticipants();
+	const auto range = mParticipantsByAddress.equal_range(pAddr->getWeakKey());
+	for (auto it = range.first; it != range.second; ++it) {
+		if (pAddr->weakEqual(*it->second->getAddress())) {
+			auto device = it->second->findDevice(dAddr, false);
 			if (device) {
 				return device;
 			}
@@ -913,10 +996,14 @@ shared_ptr<ParticipantDevice> Conference::findParticipantDevice(const std::share
 }
 
 shared_ptr<ParticipantDevice> Conference::findParticipantDevice(const shared_ptr<const CallSession> &session) const {
+	loadParticipants();
+	auto device = findCachedParticipantDevice(session);
+	if (device) return device;
 
 	for (const auto &participant : mParticipants) {
-		auto device = participant->findDevice(session, false);
+		device = participant->findDevice(session, false);
 		if (device) {
+			mParticipantDevicesBySession[session.get()] = device;
 			return device;
 		}
 	}
@@ -1782,6 +1869,7 @@ void Conference::setChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom)
 	mChatRoom = chatRoom;
 	if (mChatRoom) {
 		addListener(mChatRoom);
+		indexChatRoom();
 	}
 }
 
@@ -21,7 +21,9 @@
 #ifndef _L_CONFERENCE_H_
 #define _L_CONFERENCE_H_
 
+#include <functional>
 #include <map>
+#include <unordered_map>
 
 #include "belle-sip/object++.hh"
 
@@ -244,6 +246,16 @@ public:
 
 	const std::shared_ptr<AbstractChatRoom> getChatRoom() const;
 
+	// The loader is called once, on the first access to the participants, and is discarded by setParticipants().
+	void setParticipantsLoader(std::function<void()> loader);
+	bool participantsLoaded() const {
+		return !mParticipantsLoader;
+	}
+	// Changes each time a participant is added or removed.
+	unsigned int getParticipantsVersion() const {
+		return mParticipantsVersion;
+	}
+
 	ConferenceInterface::State getState() const override {
 		return mState;
 	}
@@ -334,6 +346,10 @@ protected:
 	                    const std::shared_ptr<const ConferenceParams> params);
 
 	std::list<std::shared_ptr<Participant>> mParticipants;
+	// mParticipants indexed by the lower case username and domain of their address, see insertParticipant().
+	std::unordered_multimap<std::string, std::shared_ptr<Participant>> mParticipantsByAddress;
+	// Devices already found by call session, checked on use as devices may change session or be removed.
+	mutable std::unordered_map<const CallSession *, std::weak_ptr<ParticipantDevice>> mParticipantDevicesBySession;
 	std::shared_ptr<Participant> mActiveParticipant;
 	std::shared_ptr<Participant> mMe;
 	std::shared_ptr<ParticipantDevice> mActiveSpeakerDevice = nullptr;
@@ -385,10 +401,24 @@ protected:
 
 	void setChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
 
+	// mParticipants must only be changed through these methods to keep its index up to date.
+	void insertParticipant(const std::shared_ptr<Participant> &participant);
+	void eraseParticipant(const std::shared_ptr<Participant> &participant);
+	void setParticipantList(std::list<std::shared_ptr<Participant>> &&participants);
+	// Must be called before reading mParticipants or the devices of mMe directly.
+	void loadParticipants() const;
+
 	std::unique_ptr<LogContextualizer> getLogContextualizer() override;
 
 private:
+	std::shared_ptr<ParticipantDevice>
+	findCachedParticipantDevice(const std::shared_ptr<const CallSession> &session) const;
+	bool isIndexedParticipant(const std::shared_ptr<Participant> &participant) const;
+	void indexChatRoom() const;
+
 	std::shared_ptr<AbstractChatRoom> mChatRoom = nullptr;
+	mutable std::function<void()> mParticipantsLoader;
+	unsigned int mParticipantsVersion = 0;
 
 	L_DISABLE_COPY(Conference);
 };
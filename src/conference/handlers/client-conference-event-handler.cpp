@@ -344,7 +344,7 @@ void ClientConferenceEventHandler::conferenceInfoNotifyReceived(const string &xm
 				lInfo() << "Participant " << *address << " requested to be deleted is me.";
 				continue;
 			} else if (participant) {
-				getConference()->mParticipants.remove(participant);
+				getConference()->eraseParticipant(participant);
 				lInfo() << "Participant " << *participant << " is successfully removed - conference "
 				        << conferenceAddressString << " has " << getConference()->getParticipantCount()
 				        << " participants";
@@ -370,7 +370,7 @@ void ClientConferenceEventHandler::conferenceInfoNotifyReceived(const string &xm
 				participant = Participant::create(getConference(), address);
 				fillParticipantAttributes(participant, roles, state, isFullState, false);
 
-				getConference()->mParticipants.push_back(participant);
+				getConference()->insertParticipant(participant);
 				lInfo() << "Participant " << *participant << " is successfully added - conference "
 				        << conferenceAddressString << " has " << getConference()->getParticipantCount()
 				        << " participants";
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2010-2023 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "conference-info-writer.h"
+
+#include "linphone/utils/utils.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+ConferenceInfoWriter::ConferenceInfoWriter(const string &entity, const string &state, unsigned int version) {
+	// Enough for most partial state documents, so that they are written without reallocation.
+	mBuffer.reserve(2048);
+	mBuffer += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
+	startElement("conference-info");
+	addAttribute("xmlns", "urn:ietf:params:xml:ns:conference-info");
+	addAttribute("xmlns:linphone-cie", "linphone:xml:ns:conference-info-linphone-extension");
+	addAttribute("entity", entity);
+	addAttribute("state", state);
+	addAttribute("version", to_string(version));
+}
+
+void ConferenceInfoWriter::startElement(const char *name) {
+	closeStartTag();
+	mBuffer += '<';
+	mBuffer += name;
+	mOpenElements.push_back(name);
+	mStartTagOpen = true;
+}
+
+void ConferenceInfoWriter::addAttribute(const char *name, const string &value) {
+	mBuffer += ' ';
+	mBuffer += name;
+	mBuffer += "=\"";
+	appendEscaped(value, true);
+	mBuffer += '"';
+}
+
+void ConferenceInfoWriter::endElement() {
+	if (mOpenElements.empty()) return;
+	if (mStartTagOpen) {
+		mBuffer += "/>";
+		mStartTagOpen = false;
+	} else {
+		mBuffer += "</";
+		mBuffer += mOpenElements.back();
+		mBuffer += '>';
+	}
+	mOpenElements.pop_back();
+}
+
+void ConferenceInfoWriter::writeElement(const char *name, const string &text) {
+	startElement(name);
+	if (text.empty()) {
+		endElement();
+		return;
+	}
+	closeStartTag();
+	appendEscaped(text, false);
+	endElement();
+}
+
+string ConferenceInfoWriter::finish() {
+	while (!mOpenElements.empty())
+		endElement();
+	mBuffer += '\n';
+	return std::move(mBuffer);
+}
+
+string ConferenceInfoWriter::timeToDateTime(time_t time) {
+	tm utcTime = Utils::getTimeTAsTm(time);
+	char dateTime[32];
+	if (strftime(dateTime, sizeof(dateTime), "%Y-%m-%dT%H:%M:%SZ", &utcTime) == 0) return string();
+	return dateTime;
+}
+
+void ConferenceInfoWriter::closeStartTag() {
+	if (!mStartTagOpen) return;
+	mBuffer += '>';
+	mStartTagOpen = false;
+}
+
+void ConferenceInfoWriter::appendEscaped(const string &text, bool attribute) {
+	for (const char c : text) {
+		switch (c) {
+			case '&':
+				mBuffer += "&amp;";
+				break;
+			case '<':
+				mBuffer += "&lt;";
+				break;
+			case '>':
+				mBuffer += "&gt;";
+				break;
+			case '"':
+				if (attribute) mBuffer += "&quot;";
+				else mBuffer += c;
+				break;
+			case '\r':
+				mBuffer += "&#xD;";
+				break;
+			case '\n':
+				if (attribute) mBuffer += "&#xA;";
+				else mBuffer += c;
+				break;
+			case '\t':
+				if (attribute) mBuffer += "&#x9;";
+				else mBuffer += c;
+				break;
+			default:
+				// Other C0 control characters cannot appear in an XML 1.0 document, even as character references.
+				if (static_cast<unsigned char>(c) >= 0x20) mBuffer += c;
+				break;
+		}
+	}
+}
+
+LINPHONE_END_NAMESPACE
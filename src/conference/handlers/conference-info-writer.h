@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010-2023 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_CONFERENCE_INFO_WRITER_H_
+#define _L_CONFERENCE_INFO_WRITER_H_
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+/*
+ * Streaming writer of conference-info documents (RFC 4575) into a single string, without building a DOM.
+ * Elements are written as they are started, so callers must follow the element order of the schema.
+ */
+class ConferenceInfoWriter {
+public:
+	// Start the conference-info root element, declaring the namespaces of the conference event package.
+	ConferenceInfoWriter(const std::string &entity, const std::string &state, unsigned int version);
+
+	void startElement(const char *name);
+	// Attributes must be added right after startElement().
+	void addAttribute(const char *name, const std::string &value);
+	void endElement();
+	void writeElement(const char *name, const std::string &text);
+
+	// Close the elements left open and return the document.
+	std::string finish();
+
+	// xs:dateTime representation of a time in UTC.
+	static std::string timeToDateTime(time_t time);
+
+private:
+	void closeStartTag();
+	void appendEscaped(const std::string &text, bool attribute);
+
+	std::string mBuffer;
+	std::vector<const char *> mOpenElements;
+	bool mStartTagOpen = false;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_CONFERENCE_INFO_WRITER_H_
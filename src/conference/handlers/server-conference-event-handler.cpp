@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <ctime>
 
 #include <bctoolbox/defs.h>
@@ -71,6 +72,7 @@ void ServerConferenceEventHandler::notifyAllExceptDevice(const std::shared_ptr<C
 	if (!conf) {
 		return;
 	}
+	prepareFanOut(notify);
 	for (const auto &participant : conf->getParticipants()) {
 		for (const auto &device : participant->getDevices()) {
 			if (device != exceptDevice) {
@@ -88,6 +90,7 @@ void ServerConferenceEventHandler::notifyAllExcept(const std::shared_ptr<Content
 		return;
 	}
 
+	prepareFanOut(notify);
 	for (const auto &participant : conf->getParticipants()) {
 		if (participant != exceptParticipant) {
 			notifyParticipant(notify, participant);
@@ -101,11 +104,84 @@ void ServerConferenceEventHandler::notifyAll(const std::shared_ptr<Content> &not
 		return;
 	}
 
+	prepareFanOut(notify);
 	for (const auto &participant : conf->getParticipants()) {
 		notifyParticipant(notify, participant);
 	}
 }
 
+void ServerConferenceEventHandler::prepareFanOut(const std::shared_ptr<Content> &notify) {
+	// The body, and its deflated form, is identical for all devices: build it once, each NOTIFY copies it
+	if (notify && !notify->isEmpty()) {
+		notify->prepareBodyHandler();
+		recordSentNotify(notify);
+	}
+}
+
+int ServerConferenceEventHandler::getFullStateTrigger() {
+	if (fullStateTrigger < 0) {
+		auto conf = getConference();
+		if (!conf) return 10;
+		fullStateTrigger = std::max(0, linphone_config_get_int(linphone_core_get_config(conf->getCore()->getCCore()),
+		                                                       "misc", "full_state_trigger_due_to_missing_updates", 10));
+	}
+	return fullStateTrigger;
+}
+
+void ServerConferenceEventHandler::recordSentNotify(const std::shared_ptr<Content> &notify) {
+	auto conf = getConference();
+	if (!conf) {
+		return;
+	}
+
+	// A version that does not follow the last one recorded (skipped or reset) breaks the sequence: start it over
+	const unsigned int version = conf->getLastNotify();
+	if (!sentNotifies.empty() && (version != sentNotifies.back().version + 1)) clearSentNotifies();
+	sentNotifies.push_back({version, notify->getBodyAsUtf8String()});
+	while (sentNotifies.size() > static_cast<size_t>(getFullStateTrigger()))
+		sentNotifies.pop_front();
+	replayedNotify = nullptr;
+}
+
+void ServerConferenceEventHandler::clearSentNotifies() {
+	sentNotifies.clear();
+	replayedNotify = nullptr;
+}
+
+std::shared_ptr<Content> ServerConferenceEventHandler::createNotifyMultipartFromSentNotifies(unsigned int notifyId) {
+	auto conf = getConference();
+	if (!conf) {
+		return nullptr;
+	}
+
+	const unsigned int lastNotify = conf->getLastNotify();
+	if (sentNotifies.empty() || (sentNotifies.back().version != lastNotify) ||
+	    (sentNotifies.front().version > notifyId + 1) || (notifyId >= lastNotify))
+		return nullptr;
+
+	if (replayedNotify && (replayedNotifyFrom == notifyId) && (replayedNotifyTo == lastNotify)) return replayedNotify;
+
+	list<shared_ptr<Content>> contents;
+	for (const auto &sentNotify : sentNotifies) {
+		if (sentNotify.version > notifyId) contents.push_back(makeContent(sentNotify.body));
+	}
+	Content multipart = ContentManager::contentListToMultipart(contents);
+	if (linphone_core_content_encoding_supported(conf->getCore()->getCCore(), "deflate"))
+		multipart.setContentEncoding("deflate");
+	replayedNotify = Content::create(multipart);
+	replayedNotify->prepareBodyHandler();
+	replayedNotifyFrom = notifyId;
+	replayedNotifyTo = lastNotify;
+	return replayedNotify;
+}
+
+std::shared_ptr<Content> ServerConferenceEventHandler::createNotifyMissedUpdates(int notifyId) {
+	auto content = createNotifyMultipartFromSentNotifies(static_cast<unsigned int>(notifyId));
+	if (content) return content;
+	// The missed versions are no longer, or were never, in memory (e.g. after a restart): replay the event log
+	return createNotifyMultipart(notifyId);
+}
+
 std::shared_ptr<Content> ServerConferenceEventHandler::createNotifyFullState(const shared_ptr<EventSubscribe> &ev) {
 	auto conf = getConference();
 	if (!conf) {
@@ -284,36 +360,16 @@ void ServerConferenceEventHandler::addAvailableMediaCapabilities(const LinphoneM
 	confDescr.setAvailableMedia(mediaType);
 }
 
-void ServerConferenceEventHandler::addEndpointSessionInfo(const std::shared_ptr<ParticipantDevice> &device,
-                                                          EndpointType &endpoint) {
-	const auto &state = device->getState();
-	auto status = EndpointStatusType::pending;
-	const auto &joiningMethod = device->getJoiningMethod();
-	std::string reasonText = std::string();
-	switch (joiningMethod) {
-		case ParticipantDevice::JoiningMethod::DialedIn:
-			reasonText = "Ad-hoc invitation";
-			break;
-		case ParticipantDevice::JoiningMethod::DialedOut:
-			reasonText = "Added by focus";
-			break;
-		case ParticipantDevice::JoiningMethod::FocusOwner:
-			reasonText = "is focus";
-			break;
-	}
-
-	switch (state) {
+EndpointStatusType ServerConferenceEventHandler::getEndpointStatus(const std::shared_ptr<ParticipantDevice> &device) {
+	switch (device->getState()) {
 		case ParticipantDevice::State::ScheduledForJoining:
-			status = EndpointStatusType::pending;
-			break;
+			return EndpointStatusType::pending;
 		case ParticipantDevice::State::Joining:
-			switch (joiningMethod) {
+			switch (device->getJoiningMethod()) {
 				case ParticipantDevice::JoiningMethod::DialedIn:
-					status = EndpointStatusType::dialing_in;
-					break;
+					return EndpointStatusType::dialing_in;
 				case ParticipantDevice::JoiningMethod::DialedOut:
-					status = EndpointStatusType::dialing_out;
-					break;
+					return EndpointStatusType::dialing_out;
 				case ParticipantDevice::JoiningMethod::FocusOwner:
 					lError() << "Focus owner device " << *device->getAddress()
 					         << " should never be in the joining state";
@@ -321,51 +377,76 @@ void ServerConferenceEventHandler::addEndpointSessionInfo(const std::shared_ptr<
 			}
 			break;
 		case ParticipantDevice::State::Alerting:
-			status = EndpointStatusType::alerting;
-			break;
+			return EndpointStatusType::alerting;
 		case ParticipantDevice::State::Present:
-			status = EndpointStatusType::connected;
-			break;
+			return EndpointStatusType::connected;
 		case ParticipantDevice::State::OnHold:
-			status = EndpointStatusType::on_hold;
-			break;
+			return EndpointStatusType::on_hold;
 		case ParticipantDevice::State::ScheduledForLeaving:
 		case ParticipantDevice::State::Leaving:
-			status = EndpointStatusType::disconnecting;
-			break;
+			return EndpointStatusType::disconnecting;
 		case ParticipantDevice::State::Left:
-			status = EndpointStatusType::disconnected;
-			break;
+			return EndpointStatusType::disconnected;
 		case ParticipantDevice::State::MutedByFocus:
-			status = EndpointStatusType::muted_via_focus;
-			break;
+			return EndpointStatusType::muted_via_focus;
+	}
+	return EndpointStatusType::pending;
+}
+
+JoiningType ServerConferenceEventHandler::getEndpointJoiningMethod(const std::shared_ptr<ParticipantDevice> &device) {
+	switch (device->getJoiningMethod()) {
+		case ParticipantDevice::JoiningMethod::DialedIn:
+			return JoiningType::dialed_in;
+		case ParticipantDevice::JoiningMethod::DialedOut:
+			return JoiningType::dialed_out;
+		case ParticipantDevice::JoiningMethod::FocusOwner:
+			return JoiningType::focus_owner;
 	}
-	endpoint.setStatus(status);
+	return JoiningType::dialed_in;
+}
 
-	auto joiningMethodNotify = JoiningType::dialed_in;
-	switch (joiningMethod) {
+string ServerConferenceEventHandler::getEndpointJoiningReason(const std::shared_ptr<ParticipantDevice> &device) {
+	std::string reasonText = std::string();
+	switch (device->getJoiningMethod()) {
 		case ParticipantDevice::JoiningMethod::DialedIn:
-			joiningMethodNotify = JoiningType::dialed_in;
+			reasonText = "Ad-hoc invitation";
 			break;
 		case ParticipantDevice::JoiningMethod::DialedOut:
-			joiningMethodNotify = JoiningType::dialed_out;
+			reasonText = "Added by focus";
 			break;
 		case ParticipantDevice::JoiningMethod::FocusOwner:
-			joiningMethodNotify = JoiningType::focus_owner;
+			reasonText = "is focus";
 			break;
 	}
+	return std::string("Reason: SIP;text=") + reasonText;
+}
 
-	JoiningType joiningMethodType = JoiningType(joiningMethodNotify);
-	endpoint.setJoiningMethod(joiningMethodType);
+DisconnectionType
+ServerConferenceEventHandler::getEndpointDisconnectionMethod(const std::shared_ptr<ParticipantDevice> &device) {
+	switch (device->getDisconnectionMethod()) {
+		case ParticipantDevice::DisconnectionMethod::Booted:
+			return DisconnectionType::booted;
+		case ParticipantDevice::DisconnectionMethod::Departed:
+			return DisconnectionType::departed;
+		case ParticipantDevice::DisconnectionMethod::Failed:
+			return DisconnectionType::failed;
+		case ParticipantDevice::DisconnectionMethod::Busy:
+			return DisconnectionType::busy;
+	}
+	return DisconnectionType::departed;
+}
+
+void ServerConferenceEventHandler::addEndpointSessionInfo(const std::shared_ptr<ParticipantDevice> &device,
+                                                          EndpointType &endpoint) {
+	endpoint.setStatus(getEndpointStatus(device));
+	endpoint.setJoiningMethod(getEndpointJoiningMethod(device));
 
 	ExecutionType joiningInfoType = ExecutionType();
 	auto joiningTime = device->getTimeOfJoining();
 	if (joiningTime >= 0) {
 		joiningInfoType.setWhen(timeTToDateTime(joiningTime));
 	}
-
-	std::string reason = std::string("Reason: SIP;text=") + reasonText;
-	joiningInfoType.setReason(reason);
+	joiningInfoType.setReason(getEndpointJoiningReason(device));
 	endpoint.setJoiningInfo(joiningInfoType);
 }
 
@@ -380,78 +461,127 @@ void ServerConferenceEventHandler::addEndpointCallInfo(const std::shared_ptr<Par
 	}
 }
 
-void ServerConferenceEventHandler::addMediaCapabilities(const std::shared_ptr<ParticipantDevice> &device,
-                                                        EndpointType &endpoint) {
+vector<ServerConferenceEventHandler::EndpointMedia>
+ServerConferenceEventHandler::getEndpointMedia(const std::shared_ptr<ParticipantDevice> &device) {
+	vector<EndpointMedia> media;
+	media.reserve(4);
+
 	const auto &audioDirection = device->getStreamCapability(LinphoneStreamTypeAudio);
-	MediaType audio = MediaType("1");
-	audio.setDisplayText("audio");
-	audio.setType("audio");
+	EndpointMedia audio{"1", "audio", "audio", device->getLabel(LinphoneStreamTypeAudio), "", audioDirection, nullptr};
 	if (audioDirection != LinphoneMediaDirectionInactive) {
 		if (device->getSsrc(LinphoneStreamTypeAudio) > 0) {
-			audio.setSrcId(std::to_string(device->getSsrc(LinphoneStreamTypeAudio)));
+			audio.srcId = std::to_string(device->getSsrc(LinphoneStreamTypeAudio));
 		}
 	}
-	if (!device->getLabel(LinphoneStreamTypeAudio).empty()) {
-		audio.setLabel(device->getLabel(LinphoneStreamTypeAudio));
-	}
-	audio.setStatus(ServerConferenceEventHandler::mediaDirectionToMediaStatus(audioDirection));
-	endpoint.getMedia().push_back(audio);
+	media.push_back(std::move(audio));
 
 	const auto isScreenSharing = device->screenSharingEnabled();
 	const auto &videoDirection =
 	    isScreenSharing ? LinphoneMediaDirectionSendOnly : device->getStreamCapability(LinphoneStreamTypeVideo);
-	MediaType video = MediaType("2");
-	video.setDisplayText("video");
-	video.setType("video");
+	EndpointMedia video{"2", "video", "video", "", "", videoDirection, isScreenSharing ? "slides" : nullptr};
 	if (videoDirection != LinphoneMediaDirectionInactive) {
-		if (!device->getLabel(LinphoneStreamTypeVideo).empty()) {
-			video.setLabel(device->getLabel(LinphoneStreamTypeVideo));
-		}
+		video.label = device->getLabel(LinphoneStreamTypeVideo);
 		if (device->getSsrc(LinphoneStreamTypeVideo) > 0) {
-			video.setSrcId(std::to_string(device->getSsrc(LinphoneStreamTypeVideo)));
+			video.srcId = std::to_string(device->getSsrc(LinphoneStreamTypeVideo));
 		}
 	}
-	video.setStatus(ServerConferenceEventHandler::mediaDirectionToMediaStatus(videoDirection));
-	if (isScreenSharing) {
-		const auto streamData = StreamData("slides");
-		auto &videoDOMDoc = video.getDomDocument();
-		::xercesc::DOMElement *e(videoDOMDoc.createElementNS(
-		    ::xsd::cxx::xml::string("linphone:xml:ns:conference-info-linphone-extension").c_str(),
-		    ::xsd::cxx::xml::string("linphone-cie:stream-data").c_str()));
-		*e << streamData;
-		video.getAny().push_back(e);
-	}
-	endpoint.getMedia().push_back(video);
+	media.push_back(std::move(video));
 
 	const auto &textDirection = device->getStreamCapability(LinphoneStreamTypeText);
-	MediaType text = MediaType("3");
-	text.setDisplayText("text");
-	text.setType("text");
-	text.setStatus(ServerConferenceEventHandler::mediaDirectionToMediaStatus(textDirection));
-	endpoint.getMedia().push_back(text);
-
-	MediaType screenSharing = MediaType("4");
-	screenSharing.setDisplayText("thumbnail");
-	screenSharing.setType("video");
+	media.push_back({"3", "text", "text", "", "", textDirection, nullptr});
 
 	const auto &thumbnailVideoDirection = device->getThumbnailStreamCapability();
+	EndpointMedia thumbnail{"4", "thumbnail", "video", "", "", thumbnailVideoDirection, "thumbnail"};
 	if (thumbnailVideoDirection != LinphoneMediaDirectionInactive) {
-		if (!device->getThumbnailStreamLabel().empty()) {
-			screenSharing.setLabel(device->getThumbnailStreamLabel());
-		}
+		thumbnail.label = device->getThumbnailStreamLabel();
 		if (device->getThumbnailStreamSsrc() > 0) {
-			screenSharing.setSrcId(std::to_string(device->getThumbnailStreamSsrc()));
+			thumbnail.srcId = std::to_string(device->getThumbnailStreamSsrc());
 		}
 	}
-	screenSharing.setStatus(ServerConferenceEventHandler::mediaDirectionToMediaStatus(thumbnailVideoDirection));
-	const auto streamData = StreamData("thumbnail");
-	auto &screenSharingDOMDoc = screenSharing.getDomDocument();
-	::xercesc::DOMElement *e(screenSharingDOMDoc.createElementNS(
-	    ::xsd::cxx::xml::string("linphone:xml:ns:conference-info-linphone-extension").c_str(),
-	    ::xsd::cxx::xml::string("linphone-cie:stream-data").c_str()));
-	*e << streamData;
-	screenSharing.getAny().push_back(e);
-	endpoint.getMedia().push_back(screenSharing);
+	media.push_back(std::move(thumbnail));
+
+	return media;
+}
+
+void ServerConferenceEventHandler::addMediaCapabilities(const std::shared_ptr<ParticipantDevice> &device,
+                                                        EndpointType &endpoint) {
+	for (const auto &medium : getEndpointMedia(device)) {
+		MediaType media = MediaType(medium.id);
+		media.setDisplayText(medium.displayText);
+		media.setType(medium.type);
+		if (!medium.label.empty()) {
+			media.setLabel(medium.label);
+		}
+		if (!medium.srcId.empty()) {
+			media.setSrcId(medium.srcId);
+		}
+		media.setStatus(mediaDirectionToMediaStatus(medium.direction));
+		if (medium.streamContent) {
+			const auto streamData = StreamData(medium.streamContent);
+			auto &mediaDOMDoc = media.getDomDocument();
+			::xercesc::DOMElement *e(mediaDOMDoc.createElementNS(
+			    ::xsd::cxx::xml::string("linphone:xml:ns:conference-info-linphone-extension").c_str(),
+			    ::xsd::cxx::xml::string("linphone-cie:stream-data").c_str()));
+			*e << streamData;
+			media.getAny().push_back(e);
+		}
+		endpoint.getMedia().push_back(media);
+	}
+}
+
+void ServerConferenceEventHandler::writeEndpoint(ConferenceInfoWriter &writer,
+                                                 const std::shared_ptr<Address> &dAddress,
+                                                 const std::shared_ptr<ParticipantDevice> &device,
+                                                 StateType::Value state) {
+	writer.startElement("endpoint");
+	writer.addAttribute("entity", dAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(state));
+	if (device) {
+		const string &displayName = device->getName();
+		if (!displayName.empty()) writer.writeElement("display-text", displayName);
+
+		writer.writeElement("status", getEndpointStatus(device));
+		writer.writeElement("joining-method", getEndpointJoiningMethod(device));
+		writer.startElement("joining-info");
+		auto joiningTime = device->getTimeOfJoining();
+		if (joiningTime >= 0) {
+			writer.writeElement("when", ConferenceInfoWriter::timeToDateTime(joiningTime));
+		}
+		writer.writeElement("reason", getEndpointJoiningReason(device));
+		writer.endElement();
+
+		for (const auto &medium : getEndpointMedia(device)) {
+			writer.startElement("media");
+			writer.addAttribute("id", medium.id);
+			writer.writeElement("display-text", medium.displayText);
+			writer.writeElement("type", medium.type);
+			if (!medium.label.empty()) writer.writeElement("label", medium.label);
+			if (!medium.srcId.empty()) writer.writeElement("src-id", medium.srcId);
+			writer.writeElement("status", mediaDirectionToMediaStatus(medium.direction));
+			if (medium.streamContent) {
+				writer.startElement("linphone-cie:stream-data");
+				writer.writeElement("linphone-cie:stream-content", medium.streamContent);
+				writer.endElement();
+			}
+			writer.endElement();
+		}
+
+		writeEndpointCallInfo(writer, device);
+	}
+	writer.endElement();
+}
+
+void ServerConferenceEventHandler::writeEndpointCallInfo(ConferenceInfoWriter &writer,
+                                                         const std::shared_ptr<ParticipantDevice> &device) {
+	if (!device->getCallId().empty() || !device->getFromTag().empty() || !device->getToTag().empty()) {
+		writer.startElement("call-info");
+		writer.startElement("sip");
+		writer.writeElement("call-id", device->getCallId());
+		writer.writeElement("from-tag", device->getFromTag());
+		writer.writeElement("to-tag", device->getToTag());
+		writer.endElement();
+		writer.endElement();
+	}
 }
 
 void ServerConferenceEventHandler::addProtocols(const std::shared_ptr<ParticipantDevice> &device,
@@ -582,49 +712,28 @@ string ServerConferenceEventHandler::createNotifyParticipantAdded(const std::sha
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-	UserType user = UserType();
-	UserRolesType roles;
-	UserType::EndpointSequence endpoints;
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::full));
 
 	shared_ptr<Participant> participant = conf->isMe(pAddress) ? conf->getMe() : conf->findParticipant(pAddress);
+	writer.startElement("roles");
+	writer.writeElement("entry", (participant && participant->isAdmin()) ? "admin" : "participant");
 	if (participant) {
-		for (const auto &device : participant->getDevices()) {
-			const string &gruu = device->getAddress()->asStringUriOnly();
-			EndpointType endpoint = EndpointType();
-			endpoint.setEntity(gruu);
-			const string &displayName = device->getName();
-			if (!displayName.empty()) endpoint.setDisplayText(displayName);
-
-			// Media capabilities
-			addMediaCapabilities(device, endpoint);
-
-			// Enpoint session info
-			addEndpointSessionInfo(device, endpoint);
-
-			// Call ID
-			addEndpointCallInfo(device, endpoint);
-
-			endpoint.setState(StateType::full);
-			user.getEndpoint().push_back(endpoint);
-		}
+		writer.writeElement("entry", Participant::roleToText(participant->getRole()));
 	}
+	writer.endElement();
 
-	user.setRoles(roles);
-	user.setEntity(pAddress->asStringUriOnly());
-	user.getRoles()->getEntry().push_back((participant && participant->isAdmin()) ? "admin" : "participant");
 	if (participant) {
-		user.getRoles()->getEntry().push_back(Participant::roleToText(participant->getRole()));
+		for (const auto &device : participant->getDevices()) {
+			writeEndpoint(writer, device->getAddress(), device, StateType::full);
+		}
 	}
-	user.setState(StateType::full);
-
-	confInfo.getUsers()->getUser().push_back(user);
 
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 string ServerConferenceEventHandler::createNotifyParticipantAdminStatusChanged(const std::shared_ptr<Address> &pAddress,
@@ -634,21 +743,16 @@ string ServerConferenceEventHandler::createNotifyParticipantAdminStatusChanged(c
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-
-	UserType user = UserType();
-	UserRolesType roles;
-	user.setRoles(roles);
-	user.setEntity(pAddress->asStringUriOnly());
-	user.getRoles()->getEntry().push_back(isAdmin ? "admin" : "participant");
-	user.setState(StateType::partial);
-	confInfo.getUsers()->getUser().push_back(user);
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::partial));
+	writer.startElement("roles");
+	writer.writeElement("entry", isAdmin ? "admin" : "participant");
 
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 string ServerConferenceEventHandler::createNotifyParticipantRemoved(const std::shared_ptr<Address> &pAddress) {
@@ -657,18 +761,14 @@ string ServerConferenceEventHandler::createNotifyParticipantRemoved(const std::s
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-
-	UserType user = UserType();
-	user.setEntity(pAddress->asStringUriOnly());
-	user.setState(StateType::deleted);
-	confInfo.getUsers()->getUser().push_back(user);
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::deleted));
 
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 MediaStatusType ServerConferenceEventHandler::mediaDirectionToMediaStatus(LinphoneMediaDirection direction) {
@@ -695,44 +795,18 @@ string ServerConferenceEventHandler::createNotifyParticipantDeviceAdded(const st
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-
-	UserType user = UserType();
-	UserType::EndpointSequence endpoints;
-	user.setEntity(pAddress->asStringUriOnly());
-	user.setState(StateType::partial);
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::partial));
 
-	EndpointType endpoint = EndpointType();
-	endpoint.setEntity(dAddress->asStringUriOnly());
 	shared_ptr<Participant> participant = conf->isMe(pAddress) ? conf->getMe() : conf->findParticipant(pAddress);
-	if (participant) {
-		shared_ptr<ParticipantDevice> participantDevice = participant->findDevice(dAddress);
-		if (participantDevice) {
-			const string &displayName = participantDevice->getName();
-			if (!displayName.empty()) endpoint.setDisplayText(displayName);
+	shared_ptr<ParticipantDevice> participantDevice = participant ? participant->findDevice(dAddress) : nullptr;
+	writeEndpoint(writer, dAddress, participantDevice, StateType::full);
 
-			addProtocols(participantDevice, endpoint);
-
-			// Media capabilities
-			addMediaCapabilities(participantDevice, endpoint);
-
-			// Enpoint session info
-			addEndpointSessionInfo(participantDevice, endpoint);
-
-			// Call ID
-			addEndpointCallInfo(participantDevice, endpoint);
-		}
-	}
-	endpoint.setState(StateType::full);
-	user.getEndpoint().push_back(endpoint);
-
-	confInfo.getUsers()->getUser().push_back(user);
-
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 string ServerConferenceEventHandler::createNotifyParticipantDeviceRemoved(const std::shared_ptr<Address> &pAddress,
@@ -742,21 +816,15 @@ string ServerConferenceEventHandler::createNotifyParticipantDeviceRemoved(const
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-
-	UserType user = UserType();
-	UserType::EndpointSequence endpoints;
-	user.setEntity(pAddress->asStringUriOnly());
-	user.setState(StateType::partial);
-
-	EndpointType endpoint = EndpointType();
-	endpoint.setEntity(dAddress->asStringUriOnly());
-
-	endpoint.setState(StateType::deleted);
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::partial));
+	writer.startElement("endpoint");
+	writer.addAttribute("entity", dAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::deleted));
 
 	shared_ptr<Participant> participant = conf->isMe(pAddress) ? conf->getMe() : conf->findParticipant(pAddress);
 	if (participant) {
@@ -764,42 +832,21 @@ string ServerConferenceEventHandler::createNotifyParticipantDeviceRemoved(const
 		if (participantDevice) {
 			const auto &timeOfDisconnection = participantDevice->getTimeOfDisconnection();
 			if (timeOfDisconnection > -1) {
-				ExecutionType disconnectionInfoType = ExecutionType();
-				disconnectionInfoType.setWhen(timeTToDateTime(timeOfDisconnection));
+				writer.writeElement("disconnection-method", getEndpointDisconnectionMethod(participantDevice));
+				writer.startElement("disconnection-info");
+				writer.writeElement("when", ConferenceInfoWriter::timeToDateTime(timeOfDisconnection));
 				const auto &reason = participantDevice->getDisconnectionReason();
 				if (!reason.empty()) {
-					disconnectionInfoType.setReason(reason);
-				}
-				endpoint.setDisconnectionInfo(disconnectionInfoType);
-
-				const auto disconnectionMethod = participantDevice->getDisconnectionMethod();
-				auto method = DisconnectionType::departed;
-				switch (disconnectionMethod) {
-					case ParticipantDevice::DisconnectionMethod::Booted:
-						method = DisconnectionType::booted;
-						break;
-					case ParticipantDevice::DisconnectionMethod::Departed:
-						method = DisconnectionType::departed;
-						break;
-					case ParticipantDevice::DisconnectionMethod::Failed:
-						method = DisconnectionType::failed;
-						break;
-					case ParticipantDevice::DisconnectionMethod::Busy:
-						method = DisconnectionType::busy;
-						break;
+					writer.writeElement("reason", reason);
 				}
-				DisconnectionType disconnectionMethodType = DisconnectionType(method);
-				endpoint.setDisconnectionMethod(disconnectionMethodType);
+				writer.endElement();
 			}
 
-			addEndpointCallInfo(participantDevice, endpoint);
+			writeEndpointCallInfo(writer, participantDevice);
 		}
 	}
 
-	user.getEndpoint().push_back(endpoint);
-	confInfo.getUsers()->getUser().push_back(user);
-
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 string
@@ -810,45 +857,21 @@ ServerConferenceEventHandler::createNotifyParticipantDeviceDataChanged(const std
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	UsersType users;
-	confInfo.setUsers(users);
-
-	UserType user = UserType();
-	UserType::EndpointSequence endpoints;
-	user.setEntity(pAddress->asStringUriOnly());
-	user.setState(StateType::partial);
+	ConferenceInfoWriter writer = startNotify(conf);
+	writer.startElement("users");
+	writer.addAttribute("state", StateType(StateType::full));
+	writer.startElement("user");
+	writer.addAttribute("entity", pAddress->asStringUriOnly());
+	writer.addAttribute("state", StateType(StateType::partial));
 
-	EndpointType endpoint = EndpointType();
-	endpoint.setEntity(dAddress->asStringUriOnly());
-	endpoint.setState(StateType::partial);
 	shared_ptr<Participant> participant = conf->isMe(pAddress) ? conf->getMe() : conf->findParticipant(pAddress);
-	if (participant) {
-		shared_ptr<ParticipantDevice> participantDevice = participant->findDevice(dAddress);
-		if (participantDevice) {
-			const string &displayName = participantDevice->getName();
-			if (!displayName.empty()) endpoint.setDisplayText(displayName);
-
-			// Media capabilities
-			addMediaCapabilities(participantDevice, endpoint);
-
-			// Enpoint session info
-			addEndpointSessionInfo(participantDevice, endpoint);
-
-			// Call ID
-			addEndpointCallInfo(participantDevice, endpoint);
-
-			const auto &state = participantDevice->getState();
-			endpoint.setState((state == ParticipantDevice::State::Left) ? StateType::deleted : StateType::partial);
-		}
-	}
-	user.getEndpoint().push_back(endpoint);
+	shared_ptr<ParticipantDevice> participantDevice = participant ? participant->findDevice(dAddress) : nullptr;
+	const auto state = (participantDevice && (participantDevice->getState() == ParticipantDevice::State::Left))
+	                       ? StateType::deleted
+	                       : StateType::partial;
+	writeEndpoint(writer, dAddress, participantDevice, state);
 
-	confInfo.getUsers()->getUser().push_back(user);
-
-	return createNotify(confInfo);
+	return writer.finish();
 }
 
 string ServerConferenceEventHandler::createNotifySubjectChanged() {
@@ -927,20 +950,26 @@ string ServerConferenceEventHandler::createNotify(ConferenceType confInfo, bool
 	return notify.str();
 }
 
+ConferenceInfoWriter ServerConferenceEventHandler::startNotify(const std::shared_ptr<Conference> &conf,
+                                                               const std::optional<std::string> &subject) {
+	// Same root and description as the ones createNotify() sets on partial state documents.
+	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
+	                                              : std::string("<unknown-conference-address>"));
+	ConferenceInfoWriter writer(entity, StateType(StateType::partial), conf->getLastNotify());
+	writer.startElement("conference-description");
+	if (subject) writer.writeElement("subject", *subject);
+	writer.writeElement("free-text", Utils::toString(static_cast<long>(time(nullptr))));
+	writer.endElement();
+	return writer;
+}
+
 string ServerConferenceEventHandler::createNotifySubjectChanged(const string &subject) {
 	auto conf = getConference();
 	if (!conf) {
 		return std::string();
 	}
 
-	string entity = (conf->getConferenceAddress() ? conf->getConferenceAddress()->asStringUriOnly()
-	                                              : std::string("<unknown-conference-address>"));
-	ConferenceType confInfo = ConferenceType(entity);
-	ConferenceDescriptionType confDescr = ConferenceDescriptionType();
-	confDescr.setSubject(subject);
-	confInfo.setConferenceDescription((const ConferenceDescriptionType)confDescr);
-
-	return createNotify(confInfo);
+	return startNotify(conf, subject).finish();
 }
 
 string ServerConferenceEventHandler::createNotifyEphemeralMode(const EventLog::Type &type) {
@@ -1178,10 +1207,7 @@ LinphoneStatus ServerConferenceEventHandler::subscribeReceived(const shared_ptr<
 		} else if (evLastNotify < lastNotify) {
 			lInfo() << "Sending all missed notify [" << evLastNotify << "-" << lastNotify << "] for conference ["
 			        << conferenceAddressString << "] to: " << *pAddress;
-			const int fullStateTrigger =
-			    linphone_config_get_int(linphone_core_get_config(conf->getCore()->getCCore()), "misc",
-			                            "full_state_trigger_due_to_missing_updates", 10);
-			bool forceFullState = static_cast<int>(lastNotify - evLastNotify) > fullStateTrigger;
+			bool forceFullState = static_cast<int>(lastNotify - evLastNotify) > getFullStateTrigger();
 			// FIXME: Temporary workaround until chatrooms and conference will be one single class with different
 			// capabilities. Every subscribe sent for a conference will be answered by a notify full state as events are
 			// not stored in the database
@@ -1189,7 +1215,7 @@ LinphoneStatus ServerConferenceEventHandler::subscribeReceived(const shared_ptr<
 			if ((conference && !conference->getCurrentParams()->chatEnabled()) || forceFullState) {
 				notifyFullState(createNotifyFullState(ev), device);
 			} else {
-				notifyParticipantDevice(createNotifyMultipart(static_cast<int>(evLastNotify)), device);
+				notifyParticipantDevice(createNotifyMissedUpdates(static_cast<int>(evLastNotify)), device);
 			}
 		} else if (evLastNotify > lastNotify) {
 			lWarning() << "Last notify received by client [" << evLastNotify << "] for conference ["
@@ -1231,16 +1257,17 @@ std::shared_ptr<Content> ServerConferenceEventHandler::getNotifyForId(int notify
 
 	unsigned int lastNotify = conf->getLastNotify();
 
-	const int fullStateTrigger = linphone_config_get_int(linphone_core_get_config(conf->getCore()->getCCore()), "misc",
-	                                                     "full_state_trigger_due_to_missing_updates", 10);
+	// Missed versions are replayed as long as they fit in the window of recently sent NOTIFYs, a full state is
+	// cheaper to send beyond it
 	bool forceFullState =
-	    (notifyId > static_cast<int>(lastNotify)) || (static_cast<int>(lastNotify) - notifyId) > fullStateTrigger;
+	    (notifyId > static_cast<int>(lastNotify)) || (static_cast<int>(lastNotify) - notifyId) > getFullStateTrigger();
 	if ((notifyId == 0) || forceFullState) {
 		auto content = createNotifyFullState(ev);
 		auto multipart = ContentManager::contentListToMultipart({content});
 		return Content::create(multipart);
 	} else if (notifyId < static_cast<int>(lastNotify)) {
-		return createNotifyMultipart(notifyId);
+		// The caller adds its own headers to the content: hand it a copy of the shared multipart
+		return Content::create(*createNotifyMissedUpdates(notifyId));
 	}
 
 	return Content::create();
@@ -1543,6 +1570,7 @@ void ServerConferenceEventHandler::onStateChanged(LinphonePrivate::ConferenceInt
 			break;
 		case ConferenceInterface::State::Terminated:
 			if (!textEnabled) conf->resetLastNotify();
+			clearSentNotifies();
 			break;
 		case ConferenceInterface::State::Deleted:
 			break;
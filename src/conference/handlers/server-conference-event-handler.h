@@ -21,8 +21,11 @@
 #ifndef _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 #define _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "linphone/types.h"
 
@@ -34,6 +37,7 @@
 #include "conference/conference-id.h"
 #include "conference/conference-interface.h"
 #include "conference/conference-listener.h"
+#include "conference/handlers/conference-info-writer.h"
 #include "xml/conference-info-linphone-extension.h"
 #include "xml/conference-info.h"
 
@@ -75,6 +79,7 @@ public:
 	void notifyAll(const std::shared_ptr<Content> &notify);
 	std::shared_ptr<Content> createNotifyFullState(const std::shared_ptr<EventSubscribe> &ev);
 	std::shared_ptr<Content> createNotifyMultipart(int notifyId);
+	std::shared_ptr<Content> createNotifyMissedUpdates(int notifyId);
 
 	// Conference
 	std::string createNotifyAvailableMediaChanged(const std::map<ConferenceMediaCapabilities, bool> mediaCapabilities);
@@ -227,6 +232,17 @@ private:
 	std::string createNotifyEphemeralLifetime(const long &lifetime);
 	std::string createNotifyEphemeralMode(const EventLog::Type &type);
 	std::shared_ptr<Content> makeContent(const std::string &xml);
+	void prepareFanOut(const std::shared_ptr<Content> &notify);
+	int getFullStateTrigger();
+
+	// Partial state NOTIFYs recently sent, kept to answer resynchronisations without reading the database.
+	struct SentNotify {
+		unsigned int version;
+		std::string body;
+	};
+	void recordSentNotify(const std::shared_ptr<Content> &notify);
+	void clearSentNotifies();
+	std::shared_ptr<Content> createNotifyMultipartFromSentNotifies(unsigned int notifyId);
 	void notifyParticipant(const std::shared_ptr<Content> &notify, const std::shared_ptr<Participant> &participant);
 	void notifyParticipantDevice(const std::shared_ptr<Content> &content,
 	                             const std::shared_ptr<ParticipantDevice> &device);
@@ -240,6 +256,33 @@ private:
 	                            Xsd::ConferenceInfo::EndpointType &endpoint);
 	void addEndpointCallInfo(const std::shared_ptr<ParticipantDevice> &device,
 	                         Xsd::ConferenceInfo::EndpointType &endpoint);
+
+	// Values of a media element of an endpoint, shared by the DOM and the streamed documents.
+	struct EndpointMedia {
+		const char *id;
+		const char *displayText;
+		const char *type;
+		std::string label;
+		std::string srcId;
+		LinphoneMediaDirection direction;
+		const char *streamContent;
+	};
+	static std::vector<EndpointMedia> getEndpointMedia(const std::shared_ptr<ParticipantDevice> &device);
+	static Xsd::ConferenceInfo::EndpointStatusType getEndpointStatus(const std::shared_ptr<ParticipantDevice> &device);
+	static Xsd::ConferenceInfo::JoiningType getEndpointJoiningMethod(const std::shared_ptr<ParticipantDevice> &device);
+	static std::string getEndpointJoiningReason(const std::shared_ptr<ParticipantDevice> &device);
+	static Xsd::ConferenceInfo::DisconnectionType
+	getEndpointDisconnectionMethod(const std::shared_ptr<ParticipantDevice> &device);
+
+	// Partial state documents of participant, device and subject events are streamed without a DOM.
+	static ConferenceInfoWriter startNotify(const std::shared_ptr<Conference> &conf,
+	                                        const std::optional<std::string> &subject = std::nullopt);
+	static void writeEndpoint(ConferenceInfoWriter &writer,
+	                          const std::shared_ptr<Address> &dAddress,
+	                          const std::shared_ptr<ParticipantDevice> &device,
+	                          Xsd::ConferenceInfo::StateType::Value state);
+	static void writeEndpointCallInfo(ConferenceInfoWriter &writer, const std::shared_ptr<ParticipantDevice> &device);
+
 	void addAvailableMediaCapabilities(const LinphoneMediaDirection audioDirection,
 	                                   const LinphoneMediaDirection videoDirection,
 	                                   const LinphoneMediaDirection textDirection,
@@ -248,6 +291,15 @@ private:
 	Xsd::XmlSchema::DateTime timeTToDateTime(const time_t &unixTime) const;
 
 	std::shared_ptr<Conference> getConference() const;
+
+	// Gapless sequence of the last versions sent, at most full_state_trigger_due_to_missing_updates long.
+	std::deque<SentNotify> sentNotifies;
+	// Last multipart built from sentNotifies, shared by the devices resynchronising from the same version.
+	std::shared_ptr<Content> replayedNotify;
+	unsigned int replayedNotifyFrom = 0;
+	unsigned int replayedNotifyTo = 0;
+	int fullStateTrigger = -1;
+
 	L_DISABLE_COPY(ServerConferenceEventHandler);
 };
 
@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -1592,7 +1594,7 @@ shared_ptr<Participant> ServerConference::addParticipantToList(BCTBX_UNUSED(cons
 		/* Case of participant that is still referenced in the chatroom, but no longer authorized because it has been
 		 * removed previously OR a totally new participant. */
 		if (findParticipant(addr) == nullptr) {
-			mParticipants.push_back(participant);
+			insertParticipant(participant);
 			shared_ptr<ConferenceParticipantEvent> event = notifyParticipantAdded(time(nullptr), false, participant);
 			getCore()->getPrivate()->mainDb->addEvent(event);
 		}
@@ -3273,13 +3275,21 @@ void ServerConference::updateParticipantDevices(
 		        << " participant device(s) for " << *participantAddress;
 
 		// Remove devices that are in the chatroom but no longer in the given list
+		// The registered devices are bucketed by their GRUU, then matched with Address::operator== as before.
+		auto gruuKey = [](const Address &address) { return Utils::stringToLower(address.getUriParamValue("gr")); };
+		unordered_multimap<string, const Address *> registeredDeviceAddresses;
+		for (const auto &deviceIdentity : devices) {
+			const auto &address = deviceIdentity->getAddress();
+			registeredDeviceAddresses.emplace(gruuKey(*address), address.get());
+		}
 		list<shared_ptr<ParticipantDevice>> devicesToRemove;
 		for (const auto &device : participant->getDevices()) {
-			auto predicate = [device](const shared_ptr<ParticipantDeviceIdentity> &deviceIdentity) {
-				return *device->getAddress() == *deviceIdentity->getAddress();
+			const auto &deviceAddress = *device->getAddress();
+			const auto range = registeredDeviceAddresses.equal_range(gruuKey(deviceAddress));
+			auto predicate = [&deviceAddress](const pair<const string, const Address *> &registeredDeviceAddress) {
+				return deviceAddress == *registeredDeviceAddress.second;
 			};
-			auto it = find_if(devices.cbegin(), devices.cend(), predicate);
-			if (it == devices.cend()) {
+			if (find_if(range.first, range.second, predicate) == range.second) {
 				lInfo() << "Conference " << *getConferenceAddress() << " Device " << *device->getAddress()
 				        << " is no longer registered, it will be removed from the chatroom.";
 				devicesToRemove.push_back(device);
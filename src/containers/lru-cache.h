@@ -33,14 +33,19 @@ LINPHONE_BEGIN_NAMESPACE
 template <typename Key, typename Value>
 class LruCache {
 public:
-	LruCache(int capacity = DefaultCapacity) : mCapacity(capacity) {
-		if (capacity < MinCapacity) capacity = MinCapacity;
+	LruCache(int capacity = DefaultCapacity) : mCapacity(capacity < MinCapacity ? MinCapacity : capacity) {
 	}
 
 	int getCapacity() const {
 		return mCapacity;
 	}
 
+	// Changing the capacity drops the cached entries.
+	void setCapacity(int capacity) {
+		clear();
+		mCapacity = capacity < MinCapacity ? MinCapacity : capacity;
+	}
+
 	int getSize() const {
 		return int(mKeyToPair.size());
 	}
@@ -55,6 +60,15 @@ public:
 		return it == mKeyToPair.cend() ? nullptr : &it->second.second;
 	}
 
+	// Same as operator[], but the entry also becomes the most recently used one.
+	Value *touch(const Key &key) {
+		auto it = mKeyToPair.find(key);
+		if (it == mKeyToPair.end()) return nullptr;
+
+		mKeys.splice(mKeys.begin(), mKeys, it->second.first);
+		return &it->second.second;
+	}
+
 	void insert(const Key &key, const Value &value) {
 		auto it = mKeyToPair.find(key);
 		if (it != mKeyToPair.end()) {
@@ -85,6 +99,14 @@ public:
 		mKeyToPair.insert({key, std::make_pair(mKeys.begin(), std::move(value))});
 	}
 
+	void erase(const Key &key) {
+		auto it = mKeyToPair.find(key);
+		if (it == mKeyToPair.end()) return;
+
+		mKeys.erase(it->second.first);
+		mKeyToPair.erase(it);
+	}
+
 	void clear() {
 		mKeyToPair.clear();
 		mKeys.clear();
@@ -96,7 +118,7 @@ public:
 private:
 	using Pair = std::pair<typename std::list<Key>::iterator, Value>;
 
-	const int mCapacity;
+	int mCapacity;
 
 	// See: https://stackoverflow.com/questions/16781886/can-we-store-unordered-maptiterator
 	// Do not store iterator key.
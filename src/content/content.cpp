@@ -94,6 +94,8 @@ Content::Content(Content &&other) noexcept : HybridObject(std::move(other)) {
 	mIsDirty = std::move(other.mIsDirty);
 	mBodyHandler = std::move(other.mBodyHandler);
 	other.mBodyHandler = nullptr;
+	mPreparedBodyHandler = std::move(other.mPreparedBodyHandler);
+	other.mPreparedBodyHandler = nullptr;
 }
 
 Content::Content(ContentType &&ct, const std::string &data) : mContentType(ct) {
@@ -111,6 +113,7 @@ Content::~Content() {
 	 */
 	mBody.assign(mBody.size(), 0);
 	if (mBodyHandler != nullptr) sal_body_handler_unref(mBodyHandler);
+	if (mPreparedBodyHandler != nullptr) sal_body_handler_unref(mPreparedBodyHandler);
 }
 
 Content &Content::operator=(const Content &other) {
@@ -133,6 +136,8 @@ Content &Content::operator=(Content &&other) noexcept {
 	mIsDirty = std::move(other.mIsDirty);
 	mBodyHandler = std::move(other.mBodyHandler);
 	other.mBodyHandler = nullptr;
+	mPreparedBodyHandler = std::move(other.mPreparedBodyHandler);
+	other.mPreparedBodyHandler = nullptr;
 	return *this;
 }
 
@@ -151,6 +156,7 @@ void Content::copy(const Content &other) {
 	mSize = other.mSize;
 	mCache = other.mCache;
 	if (!mIsDirty && mBodyHandler != nullptr) mBodyHandler = sal_body_handler_ref(other.mBodyHandler);
+	markAsDirty();
 }
 
 const ContentType &Content::getContentType() const {
@@ -162,6 +168,7 @@ ContentType &Content::getContentType() {
 }
 
 void Content::setContentType(const ContentType &contentType) {
+	markAsDirty();
 	mContentType = contentType;
 }
 
@@ -170,6 +177,7 @@ const ContentDisposition &Content::getContentDisposition() const {
 }
 
 void Content::setContentDisposition(const ContentDisposition &contentDisposition) {
+	markAsDirty();
 	mContentDisposition = contentDisposition;
 }
 
@@ -178,6 +186,7 @@ const string &Content::getContentEncoding() const {
 }
 
 void Content::setContentEncoding(const string &contentEncoding) {
+	markAsDirty();
 	mContentEncoding = contentEncoding;
 }
 
@@ -195,20 +204,23 @@ const string &Content::getBodyAsUtf8String() const {
 }
 
 void Content::setBody(const vector<uint8_t> &body) {
+	markAsDirty();
 	mBody = body;
 }
 
 void Content::setBody(vector<uint8_t> &&body) {
+	markAsDirty();
 	mBody = std::move(body);
 }
 
 void Content::setBodyFromLocale(const string &body) {
+	markAsDirty();
 	string toUtf8 = Utils::localeToUtf8(body);
 	mBody = vector<uint8_t>(toUtf8.cbegin(), toUtf8.cend());
 }
 
 void Content::setBody(const void *buffer, size_t size) {
-	mIsDirty = true;
+	markAsDirty();
 
 	const char *start = static_cast<const char *>(buffer);
 	if (start != nullptr) mBody = vector<uint8_t>(start, start + size);
@@ -216,7 +228,7 @@ void Content::setBody(const void *buffer, size_t size) {
 }
 
 void Content::setBodyFromUtf8(const string &body) {
-	mIsDirty = true;
+	markAsDirty();
 
 	mBody = vector<uint8_t>(body.cbegin(), body.cend());
 }
@@ -234,6 +246,7 @@ size_t Content::getSize() const {
 }
 
 void Content::setSize(size_t size) {
+	markAsDirty();
 	mSize = size;
 }
 
@@ -282,12 +295,14 @@ void Content::setFilePath(const std::string &path) {
 }
 
 void Content::addHeader(const string &headerName, const string &headerValue) {
+	markAsDirty();
 	removeHeader(headerName);
 	Header header = Header(headerName, headerValue);
 	mHeaders.push_back(header);
 }
 
 void Content::addHeader(const Header &header) {
+	markAsDirty();
 	removeHeader(header.getName());
 	mHeaders.push_back(header);
 }
@@ -305,6 +320,7 @@ const Header &Content::getHeader(const string &headerName) const {
 }
 
 void Content::removeHeader(const string &headerName) {
+	markAsDirty();
 	auto it = findHeader(headerName);
 	if (it != mHeaders.cend()) mHeaders.remove(*it);
 }
@@ -389,6 +405,29 @@ SalBodyHandler *Content::getBodyHandlerFromContent(const Content &content, bool
 	return bodyHandler;
 }
 
+void Content::prepareBodyHandler(void) {
+	if (mPreparedBodyHandler != nullptr) return;
+
+	SalBodyHandler *bodyHandler = (!mIsDirty && mBodyHandler != nullptr) ? sal_body_handler_clone(mBodyHandler)
+	                                                                     : getBodyHandlerFromContent(*this, false);
+	mPreparedBodyHandler = sal_body_handler_ref(bodyHandler);
+	// Encoded once here, the clones handed to the messages copy the encoded buffer.
+	if (!mContentEncoding.empty()) sal_body_handler_apply_encoding(mPreparedBodyHandler, mContentEncoding.c_str());
+}
+
+SalBodyHandler *Content::createPreparedBodyHandler(void) const {
+	// A body handler keeps the state of the transfer it is used for, so it cannot be shared between messages.
+	return mPreparedBodyHandler ? sal_body_handler_clone(mPreparedBodyHandler) : nullptr;
+}
+
+void Content::markAsDirty(void) {
+	mIsDirty = true;
+	if (mPreparedBodyHandler != nullptr) {
+		sal_body_handler_unref(mPreparedBodyHandler);
+		mPreparedBodyHandler = nullptr;
+	}
+}
+
 bool Content::isFileEncrypted(const string &filePath) const {
 	if (filePath.empty()) {
 		return false;
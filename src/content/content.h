@@ -115,6 +115,19 @@ public:
 
 	static SalBodyHandler *getBodyHandlerFromContent(const Content &content, bool parseMultipart = true);
 
+	/**
+	 * build the body of this complete content once and apply its content encoding, so that every message
+	 * sending it only copies the encoded buffer.
+	 * The setters drop the prepared body, but changes made in place through getContentType()
+	 * are not tracked: a prepared content must not be modified that way.
+	 */
+	void prepareBodyHandler(void);
+	/**
+	 * create a new body handler, owned by the caller, from the body built by prepareBodyHandler()
+	 * @return nullptr if the body is not prepared
+	 */
+	SalBodyHandler *createPreparedBodyHandler(void) const;
+
 	/**
 	 * compress this content
 	 * content size is modified and set the content-encoding to deflate
@@ -133,6 +146,9 @@ protected:
 	const std::string exportPlainFileFromEncryptedFile(const std::string &filePath) const;
 
 private:
+	// Called by the setters: the body handler of the content must be rebuilt and the prepared one is dropped.
+	void markAsDirty(void);
+
 	std::vector<uint8_t> mBody;
 	ContentType mContentType;
 	ContentDisposition mContentDisposition;
@@ -142,6 +158,8 @@ private:
 	void *mCryptoContext = nullptr; // Used to encrypt file for RCS file transfer.
 	bool mIsDirty = false;
 	SalBodyHandler *mBodyHandler = nullptr;
+	// Never sent, only cloned by createPreparedBodyHandler().
+	SalBodyHandler *mPreparedBodyHandler = nullptr;
 
 	struct Cache {
 		std::string name;
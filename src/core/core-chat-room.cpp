@@ -269,60 +269,113 @@ shared_ptr<AbstractChatRoom> CorePrivate::createBasicChatRoom(const ConferenceId
 	return chatRoom;
 }
 
-shared_ptr<AbstractChatRoom>
-CorePrivate::searchChatRoom(const shared_ptr<ConferenceParams> &params,
-                            const std::shared_ptr<const Address> &localAddress,
-                            const std::shared_ptr<const Address> &remoteAddress,
-                            const std::list<std::shared_ptr<Address>> &participants) const {
-	L_Q();
-	for (const auto &chatRoom : q->getRawChatRoomList()) {
-		if (params) {
-			const auto &chatRoomParams = chatRoom->getCurrentParams();
-			if (params->getChatParams()->getBackend() != chatRoomParams->getChatParams()->getBackend()) continue;
+// Weakly equal local and remote addresses of one-to-one chat rooms of a backend share the same key.
+static string
+getOneToOneChatRoomKey(ChatParams::Backend backend, const Address &localAddress, const Address &remoteAddress) {
+	string key = Utils::toString(static_cast<int>(backend));
+	key += '\n';
+	key += localAddress.getWeakKey();
+	key += '\n';
+	key += remoteAddress.getWeakKey();
+	return key;
+}
 
-			if (params->isGroup() != chatRoomParams->isGroup()) continue;
+// Remote address of a one-to-one chat room: its peer for a basic chat room, its only participant otherwise.
+static shared_ptr<Address> getOneToOneChatRoomRemoteAddress(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	if (chatRoom->getCurrentParams()->getChatParams()->getBackend() == ChatParams::Backend::Basic)
+		return chatRoom->getPeerAddress();
+	const auto &participants = chatRoom->getParticipants();
+	return participants.empty() ? nullptr : participants.front()->getAddress();
+}
 
-			if (params->isGroup() &&
-			    (chatRoomParams->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::Basic))
-				continue;
+static bool matchChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom,
+                          const shared_ptr<ConferenceParams> &params,
+                          const std::shared_ptr<const Address> &localAddress,
+                          const std::shared_ptr<const Address> &remoteAddress,
+                          const std::list<std::shared_ptr<Address>> &participants) {
+	if (params) {
+		const auto &chatRoomParams = chatRoom->getCurrentParams();
+		if (params->getChatParams()->getBackend() != chatRoomParams->getChatParams()->getBackend()) return false;
 
-			if (params->getChatParams()->isEncrypted() != chatRoomParams->getChatParams()->isEncrypted()) continue;
+		if (params->isGroup() != chatRoomParams->isGroup()) return false;
 
-			// Subject doesn't make any sense for basic chat room
-			if ((params->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::FlexisipChat) &&
-			    (!params->getSubject().empty() && params->getSubject() != chatRoom->getSubject()))
-				continue;
-		}
+		if (params->isGroup() &&
+		    (chatRoomParams->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::Basic))
+			return false;
 
-		std::shared_ptr<Address> curLocalAddress = chatRoom->getLocalAddress();
-		const auto curLocalAddressWithoutGruu = curLocalAddress->getUriWithoutGruu();
-		const auto localAddressWithoutGruu =
-		    (localAddress && localAddress->isValid()) ? localAddress->getUriWithoutGruu() : Address();
-		if (localAddressWithoutGruu.isValid() && (localAddressWithoutGruu != curLocalAddressWithoutGruu)) continue;
+		if (params->getChatParams()->isEncrypted() != chatRoomParams->getChatParams()->isEncrypted()) return false;
 
-		std::shared_ptr<Address> curRemoteAddress = chatRoom->getPeerAddress();
-		const auto curRemoteAddressWithoutGruu = curRemoteAddress->getUriWithoutGruu();
-		const auto remoteAddressWithoutGruu =
-		    (remoteAddress && remoteAddress->isValid()) ? remoteAddress->getUriWithoutGruu() : Address();
-		if (remoteAddressWithoutGruu.isValid() && (remoteAddressWithoutGruu != curRemoteAddressWithoutGruu)) continue;
+		// Subject doesn't make any sense for basic chat room
+		if ((params->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::FlexisipChat) &&
+		    (!params->getSubject().empty() && params->getSubject() != chatRoom->getSubject()))
+			return false;
+	}
 
-		bool allFound = true;
-		for (const auto &participant : participants) {
-			bool found = false;
-			for (const auto &p : chatRoom->getParticipants()) {
-				if (participant->weakEqual(*(p->getAddress()))) {
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
-				allFound = false;
+	std::shared_ptr<Address> curLocalAddress = chatRoom->getLocalAddress();
+	const auto curLocalAddressWithoutGruu = curLocalAddress->getUriWithoutGruu();
+	const auto localAddressWithoutGruu =
+	    (localAddress && localAddress->isValid()) ? localAddress->getUriWithoutGruu() : Address();
+	if (localAddressWithoutGruu.isValid() && (localAddressWithoutGruu != curLocalAddressWithoutGruu)) return false;
+
+	std::shared_ptr<Address> curRemoteAddress = chatRoom->getPeerAddress();
+	const auto curRemoteAddressWithoutGruu = curRemoteAddress->getUriWithoutGruu();
+	const auto remoteAddressWithoutGruu =
+	    (remoteAddress && remoteAddress->isValid()) ? remoteAddress->getUriWithoutGruu() : Address();
+	if (remoteAddressWithoutGruu.isValid() && (remoteAddressWithoutGruu != curRemoteAddressWithoutGruu)) return false;
+
+	for (const auto &participant : participants) {
+		bool found = false;
+		for (const auto &p : chatRoom->getParticipants()) {
+			if (participant->weakEqual(*(p->getAddress()))) {
+				found = true;
 				break;
 			}
 		}
-		if (!allFound) continue;
+		if (!found) return false;
+	}
+	return true;
+}
 
-		return chatRoom;
+shared_ptr<AbstractChatRoom>
+CorePrivate::searchChatRoom(const shared_ptr<ConferenceParams> &params,
+                            const std::shared_ptr<const Address> &localAddress,
+                            const std::shared_ptr<const Address> &remoteAddress,
+                            const std::list<std::shared_ptr<Address>> &participants) const {
+	L_Q();
+	if (localAddress && localAddress->isValid() && remoteAddress && remoteAddress->isValid()) {
+		// Chat rooms are registered under their conference ID: only the one registered under an ID weakly equal to
+		// the searched addresses can match.
+		const ConferenceId conferenceId(remoteAddress, localAddress);
+		const auto chatRoomIt = chatRoomsById.find(conferenceId);
+		if ((chatRoomIt != chatRoomsById.cend()) && chatRoomIt->second &&
+		    matchChatRoom(chatRoomIt->second, params, localAddress, remoteAddress, participants))
+			return chatRoomIt->second;
+		const auto conferenceIt = conferenceById.find(conferenceId);
+		if (conferenceIt != conferenceById.cend()) {
+			const auto &chatRoom = conferenceIt->second->getChatRoom();
+			if (chatRoom && matchChatRoom(chatRoom, params, localAddress, remoteAddress, participants))
+				return chatRoom;
+		}
+		return nullptr;
+	}
+
+	if (params && !params->isGroup() && (participants.size() == 1) && localAddress && localAddress->isValid() &&
+	    !(remoteAddress && remoteAddress->isValid())) {
+		// A one-to-one chat room can only match if it is indexed with the searched local address and participant.
+		const auto key = getOneToOneChatRoomKey(params->getChatParams()->getBackend(), *localAddress,
+		                                        *participants.front());
+		const auto range = oneToOneChatRoomsByAddresses.equal_range(key);
+		for (auto it = range.first; it != range.second; ++it) {
+			const auto chatRoom = it->second.lock();
+			if (chatRoom && isChatRoomRegistered(chatRoom) &&
+			    matchChatRoom(chatRoom, params, localAddress, remoteAddress, participants))
+				return chatRoom;
+		}
+		return nullptr;
+	}
+
+	for (const auto &chatRoom : q->getRawChatRoomList()) {
+		if (matchChatRoom(chatRoom, params, localAddress, remoteAddress, participants)) return chatRoom;
 	}
 	return nullptr;
 }
@@ -464,6 +517,119 @@ void CorePrivate::insertChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
 		}
 		chatRoomsById[conferenceId] = chatRoom;
 	}
+	indexChatRoom(chatRoom);
+}
+
+// Adds the chat room under the key unless it is already there, dropping the entries of deleted chat rooms.
+template <typename Index, typename Key>
+static void addChatRoomIndexEntry(Index &index, const Key &key, const shared_ptr<AbstractChatRoom> &chatRoom) {
+	const auto range = index.equal_range(key);
+	bool found = false;
+	for (auto it = range.first; it != range.second;) {
+		const auto indexedChatRoom = it->second.lock();
+		if (!indexedChatRoom) {
+			it = index.erase(it);
+			continue;
+		}
+		if (indexedChatRoom == chatRoom) found = true;
+		++it;
+	}
+	if (!found) index.emplace(key, chatRoom);
+}
+
+void CorePrivate::indexChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	const auto &chatRoomParams = chatRoom->getCurrentParams();
+	const auto &localAddress = chatRoom->getLocalAddress();
+	if (chatRoomParams && !chatRoomParams->isGroup() && localAddress) {
+		const auto remoteAddress = getOneToOneChatRoomRemoteAddress(chatRoom);
+		if (remoteAddress) {
+			const auto key =
+			    getOneToOneChatRoomKey(chatRoomParams->getChatParams()->getBackend(), *localAddress, *remoteAddress);
+			addChatRoomIndexEntry(oneToOneChatRoomsByAddresses, key, chatRoom);
+		}
+	}
+
+#ifdef HAVE_ADVANCED_IM
+	const auto clientChatRoom = dynamic_pointer_cast<ClientChatRoom>(chatRoom);
+	if (clientChatRoom) {
+		for (const auto &previousId : clientChatRoom->getPreviousConferenceIds())
+			addChatRoomIndexEntry(chatRoomsByPreviousConferenceId, previousId, chatRoom);
+	}
+#endif
+}
+
+// Removes the entries of the chat room under the key, along with the entries of deleted chat rooms.
+template <typename Index, typename Key>
+static void removeChatRoomIndexEntry(Index &index, const Key &key, const shared_ptr<AbstractChatRoom> &chatRoom) {
+	const auto range = index.equal_range(key);
+	for (auto it = range.first; it != range.second;) {
+		const auto indexedChatRoom = it->second.lock();
+		if (!indexedChatRoom || (indexedChatRoom == chatRoom)) it = index.erase(it);
+		else ++it;
+	}
+}
+
+void CorePrivate::unindexChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
+	const auto &chatRoomParams = chatRoom->getCurrentParams();
+	const auto &localAddress = chatRoom->getLocalAddress();
+	if (chatRoomParams && !chatRoomParams->isGroup() && localAddress) {
+		const auto remoteAddress = getOneToOneChatRoomRemoteAddress(chatRoom);
+		if (remoteAddress) {
+			const auto key =
+			    getOneToOneChatRoomKey(chatRoomParams->getChatParams()->getBackend(), *localAddress, *remoteAddress);
+			removeChatRoomIndexEntry(oneToOneChatRoomsByAddresses, key, chatRoom);
+		}
+	}
+
+#ifdef HAVE_ADVANCED_IM
+	const auto clientChatRoom = dynamic_pointer_cast<ClientChatRoom>(chatRoom);
+	if (clientChatRoom) {
+		for (const auto &previousId : clientChatRoom->getPreviousConferenceIds())
+			unindexPreviousConferenceId(previousId, chatRoom);
+	}
+#endif
+}
+
+void CorePrivate::unindexPreviousConferenceId(const ConferenceId &previousId,
+                                              const shared_ptr<AbstractChatRoom> &chatRoom) {
+	removeChatRoomIndexEntry(chatRoomsByPreviousConferenceId, previousId, chatRoom);
+}
+
+void CorePrivate::clearChatRoomIndexes() {
+	oneToOneChatRoomsByAddresses.clear();
+	chatRoomsByPreviousConferenceId.clear();
+}
+
+bool CorePrivate::isChatRoomRegistered(const shared_ptr<AbstractChatRoom> &chatRoom) const {
+	const ConferenceId &conferenceId = chatRoom->getConferenceId();
+	const auto chatRoomIt = chatRoomsById.find(conferenceId);
+	if ((chatRoomIt != chatRoomsById.cend()) && (chatRoomIt->second == chatRoom)) return true;
+	const auto conferenceIt = conferenceById.find(conferenceId);
+	return (conferenceIt != conferenceById.cend()) && (conferenceIt->second->getChatRoom() == chatRoom);
+}
+
+shared_ptr<AbstractChatRoom> CorePrivate::findOneToOneChatRoom(ChatParams::Backend backend,
+                                                               const std::shared_ptr<const Address> &localAddress,
+                                                               const std::shared_ptr<const Address> &remoteAddress,
+                                                               bool encrypted) const {
+	if (!localAddress || !remoteAddress) return nullptr;
+	const auto range =
+	    oneToOneChatRoomsByAddresses.equal_range(getOneToOneChatRoomKey(backend, *localAddress, *remoteAddress));
+	for (auto it = range.first; it != range.second; ++it) {
+		const auto chatRoom = it->second.lock();
+		if (!chatRoom || !isChatRoomRegistered(chatRoom)) continue;
+
+		const auto &chatRoomParams = chatRoom->getCurrentParams();
+		if (chatRoomParams->isGroup() || (encrypted != chatRoomParams->getChatParams()->isEncrypted()) ||
+		    (chatRoomParams->getChatParams()->getBackend() != backend))
+			continue;
+
+		const auto chatRoomRemoteAddress = getOneToOneChatRoomRemoteAddress(chatRoom);
+		if (chatRoomRemoteAddress && localAddress->weakEqual(*chatRoom->getLocalAddress()) &&
+		    remoteAddress->weakEqual(*chatRoomRemoteAddress))
+			return chatRoom;
+	}
+	return nullptr;
 }
 
 void CorePrivate::insertChatRoomWithDb(const shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId) {
@@ -473,36 +639,43 @@ void CorePrivate::insertChatRoomWithDb(const shared_ptr<AbstractChatRoom> &chatR
 
 void CorePrivate::loadChatRooms() {
 	chatRoomsById.clear();
+	clearChatRoomIndexes();
 #ifdef HAVE_ADVANCED_IM
 	if (clientListEventHandler) clientListEventHandler->clearHandlers();
 #endif
 	if (!mainDb->isInitialized()) return;
 	for (auto &chatRoom : mainDb->getChatRooms()) {
 		const auto &chatRoomParams = chatRoom->getCurrentParams();
+		const auto &conference = chatRoom->getConference();
 		// We are looking for a one to one chatroom which isn't basic
 		if (chatRoomParams->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::Basic) {
 			insertChatRoom(chatRoom);
 		} else {
-			const auto &conference = chatRoom->getConference();
 			const ConferenceId &conferenceId = conference->getConferenceId();
 			conferenceById.insert(std::make_pair(conferenceId, conference));
+			indexChatRoom(chatRoom);
 		}
 
-		// TODO FIXME: Remove later when devices for friends will be notified through presence
-		for (const auto &p : chatRoom->getParticipants()) {
-			auto devices = mainDb->getDevices(p->getAddress());
-			if (devices.empty()) {
-				for (const auto &d : p->getDevices()) {
-					auto gruu = d->getAddress();
-					auto name = d->getName();
-					lDebug() << "[Friend] Inserting existing device with name [" << name << "] and address ["
-					         << gruu->asStringUriOnly() << "]";
-					mainDb->insertDevice(gruu, name);
-				}
+		// Participants of chat rooms loaded lazily are handled when they are loaded.
+		if (!conference || conference->participantsLoaded()) insertFriendDevices(chatRoom->getParticipants());
+	}
+	sendDeliveryNotifications();
+}
+
+// TODO FIXME: Remove later when devices for friends will be notified through presence
+void CorePrivate::insertFriendDevices(const list<shared_ptr<Participant>> &participants) {
+	for (const auto &p : participants) {
+		auto devices = mainDb->getDevices(p->getAddress());
+		if (devices.empty()) {
+			for (const auto &d : p->getDevices()) {
+				auto gruu = d->getAddress();
+				auto name = d->getName();
+				lDebug() << "[Friend] Inserting existing device with name [" << name << "] and address ["
+				         << gruu->asStringUriOnly() << "]";
+				mainDb->insertDevice(gruu, name);
 			}
 		}
 	}
-	sendDeliveryNotifications();
 }
 
 void CorePrivate::handleEphemeralMessages(time_t currentTime) {
@@ -606,24 +779,11 @@ CorePrivate::findExhumableOneToOneChatRoom(const std::shared_ptr<Address> &local
                                            const std::shared_ptr<Address> &participantAddress,
                                            bool encrypted) const {
 #ifdef HAVE_ADVANCED_IM
-	L_Q();
-
 	lInfo() << "Looking for exhumable 1-1 chat room with local address [" << *localAddress << "] and participant ["
 	        << *participantAddress << "]";
-	for (const auto &chatRoom : q->getRawChatRoomList()) {
-		const std::shared_ptr<Address> &curLocalAddress = chatRoom->getLocalAddress();
-		const auto &chatRoomParams = chatRoom->getCurrentParams();
-		// Don't check if terminated, it can be exhumed before the BYE has been received
-		if (/*chatRoom->getState() == ChatRoom::State::Terminated
-		        && */
-		    (chatRoomParams->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::FlexisipChat) &&
-		    !chatRoomParams->isGroup() && (encrypted == chatRoomParams->getChatParams()->isEncrypted())) {
-			if (chatRoom->getParticipants().size() > 0 && localAddress->weakEqual(*curLocalAddress) &&
-			    participantAddress->weakEqual(*chatRoom->getParticipants().front()->getAddress())) {
-				return chatRoom;
-			}
-		}
-	}
+	// Don't check if terminated, it can be exhumed before the BYE has been received
+	auto chatRoom = findOneToOneChatRoom(ChatParams::Backend::FlexisipChat, localAddress, participantAddress, encrypted);
+	if (chatRoom) return chatRoom;
 
 	lInfo() << "Unable to find exhumable 1-1 chat room with local address [" << localAddress->toString()
 	        << "] and participant [" << participantAddress->toString() << "]";
@@ -641,8 +801,11 @@ CorePrivate::findExhumableOneToOneChatRoom(const std::shared_ptr<Address> &local
 shared_ptr<AbstractChatRoom>
 CorePrivate::findExumedChatRoomFromPreviousConferenceId(const ConferenceId conferenceId) const {
 #ifdef HAVE_ADVANCED_IM
-	L_Q();
-	for (const auto &chatRoom : q->getRawChatRoomList()) {
+	const auto range = chatRoomsByPreviousConferenceId.equal_range(conferenceId);
+	for (auto it = range.first; it != range.second; ++it) {
+		const auto chatRoom = it->second.lock();
+		if (!chatRoom || !isChatRoomRegistered(chatRoom)) continue;
+
 		const auto &chatRoomParams = chatRoom->getCurrentParams();
 		// We are looking for a one to one chatroom which isn't basic
 		if ((chatRoomParams->getChatParams()->getBackend() == LinphonePrivate::ChatParams::Backend::Basic) &&
@@ -679,6 +842,7 @@ void CorePrivate::updateChatRoomConferenceId(const shared_ptr<AbstractChatRoom>
 
 	conferenceById.erase(oldConferenceId);
 	conferenceById[newConferenceId] = chatRoom->getConference();
+	indexChatRoom(chatRoom);
 
 	mainDb->updateChatRoomConferenceId(oldConferenceId, newConferenceId);
 #endif
@@ -818,31 +982,23 @@ shared_ptr<AbstractChatRoom> Core::findOneToOneChatRoom(const std::shared_ptr<co
                                                         bool basicOnly,
                                                         bool conferenceOnly,
                                                         bool encrypted) const {
-	for (const auto &chatRoom : getRawChatRoomList()) {
-		const std::shared_ptr<Address> &curLocalAddress = chatRoom->getLocalAddress();
-		const auto &chatRoomParams = chatRoom->getCurrentParams();
-
-		// We are looking for a one to one chatroom
-		// Do not return a group chat room that everyone except one person has left
-		if (chatRoomParams->isGroup()) continue;
+	L_D();
+	// We are looking for a one to one chatroom
+	// Do not return a group chat room that everyone except one person has left
+	shared_ptr<AbstractChatRoom> chatRoom;
 
-		if (encrypted != chatRoomParams->getChatParams()->isEncrypted()) continue;
+	// One to one client group chat room
+	// The only participant's address must match the participantAddress argument
+	if (!basicOnly)
+		chatRoom =
+		    d->findOneToOneChatRoom(ChatParams::Backend::FlexisipChat, localAddress, participantAddress, encrypted);
 
-		const auto chatBackend = chatRoomParams->getChatParams()->getBackend();
-		// One to one client group chat room
-		// The only participant's address must match the participantAddress argument
-		if (!basicOnly && (chatBackend == LinphonePrivate::ChatParams::Backend::FlexisipChat) &&
-		    !chatRoom->getParticipants().empty() && localAddress->weakEqual(*curLocalAddress) &&
-		    participantAddress->weakEqual(*chatRoom->getParticipants().front()->getAddress()))
-			return chatRoom;
+	// One to one basic chat room (addresses without gruu)
+	// The peer address must match the participantAddress argument
+	if (!chatRoom && !conferenceOnly)
+		chatRoom = d->findOneToOneChatRoom(ChatParams::Backend::Basic, localAddress, participantAddress, encrypted);
 
-		// One to one basic chat room (addresses without gruu)
-		// The peer address must match the participantAddress argument
-		if (!conferenceOnly && (chatBackend == LinphonePrivate::ChatParams::Backend::Basic) &&
-		    localAddress->weakEqual(*curLocalAddress) && participantAddress->weakEqual(*chatRoom->getPeerAddress()))
-			return chatRoom;
-	}
-	return nullptr;
+	return chatRoom;
 }
 
 shared_ptr<AbstractChatRoom> Core::getOrCreateBasicChatRoom(const ConferenceId &conferenceId) {
@@ -903,6 +1059,7 @@ void Core::deleteChatRoom(const shared_ptr<AbstractChatRoom> &chatRoom) {
 	auto chatRoomInCoreMap = core->findChatRoom(conferenceId);
 	if (chatRoomInCoreMap) {
 		CorePrivate *d = core->getPrivate();
+		d->unindexChatRoom(chatRoomInCoreMap);
 		if (d->mainDb->isInitialized()) d->mainDb->deleteChatRoom(conferenceId);
 	} else {
 		lError() << "Unable to delete chat room with conference ID " << conferenceId << " because it cannot be found.";
@@ -97,12 +97,20 @@ public:
 	bool setInputAudioDevice(const std::shared_ptr<AudioDevice> &audioDevice);
 
 	void loadChatRooms();
+	// Chat rooms loaded lazily call it when their participants are loaded.
+	void insertFriendDevices(const std::list<std::shared_ptr<Participant>> &participants);
 	void handleEphemeralMessages(time_t currentTime);
 	void initEphemeralMessages();
 	void updateEphemeralMessages(const std::shared_ptr<ChatMessage> &message);
 	void sendDeliveryNotifications();
 	void insertChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
 	void insertChatRoomWithDb(const std::shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId = 0);
+	// Adds the chat room to the secondary indexes, to be called each time its addresses or participants change.
+	void indexChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	// Removes the chat room from the secondary indexes, to be called when it is deleted.
+	void unindexChatRoom(const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	void unindexPreviousConferenceId(const ConferenceId &previousId, const std::shared_ptr<AbstractChatRoom> &chatRoom);
+	void clearChatRoomIndexes();
 	std::shared_ptr<AbstractChatRoom> createBasicChatRoom(const ConferenceId &conferenceId,
 	                                                      const std::shared_ptr<ConferenceParams> &params);
 
@@ -153,6 +161,10 @@ public:
 	                                                                const std::shared_ptr<Address> &participantAddress,
 	                                                                bool encrypted) const;
 	std::shared_ptr<AbstractChatRoom> findExumedChatRoomFromPreviousConferenceId(const ConferenceId conferenceId) const;
+	std::shared_ptr<AbstractChatRoom> findOneToOneChatRoom(ChatParams::Backend backend,
+	                                                       const std::shared_ptr<const Address> &localAddress,
+	                                                       const std::shared_ptr<const Address> &remoteAddress,
+	                                                       bool encrypted) const;
 
 	void stopChatMessagesAggregationTimer();
 
@@ -201,6 +213,16 @@ private:
 	std::unordered_map<ConferenceId, std::shared_ptr<Conference>, ConferenceId::WeakHash, ConferenceId::WeakEqual>
 	    conferenceById;
 
+	// Secondary indexes of the chat rooms of chatRoomsById and conferenceById. Their entries are only candidates,
+	// checked against the chat room on lookup, so entries left behind by a chat room that changed are harmless.
+	bool isChatRoomRegistered(const std::shared_ptr<AbstractChatRoom> &chatRoom) const;
+	std::unordered_multimap<std::string, std::weak_ptr<AbstractChatRoom>> oneToOneChatRoomsByAddresses;
+	std::unordered_multimap<ConferenceId,
+	                        std::weak_ptr<AbstractChatRoom>,
+	                        ConferenceId::WeakHash,
+	                        ConferenceId::WeakEqual>
+	    chatRoomsByPreviousConferenceId;
+
 	std::unique_ptr<EncryptionEngine> imee;
 
 	std::map<std::string, std::string> specs;
@@ -40,6 +40,7 @@
 #include "bctoolbox/crypto.hh"
 #include "bctoolbox/defs.h"
 #include "bctoolbox/utils.hh"
+#include "bctoolbox/vfs_encrypted.hh"
 
 #include "json/json.h"
 
@@ -178,6 +179,21 @@ void CorePrivate::init() {
 				lInfo() << "Setting sqlite3 synchronous mode to OFF.";
 				uri += " synchronous=OFF";
 			}
+			if (backend == MainDb::Sqlite3 &&
+			    linphone_config_get_bool(linphone_core_get_config(lc), "storage", "sqlite3_wal_enabled", FALSE)) {
+				// The WAL journal mode needs the shared memory primitives of the native VFS, which does not encrypt
+				// the database: WAL is refused when the encrypted bctbx VFS is set up, so the database stays
+				// encrypted and in its previous journal mode.
+				if (bctoolbox::VfsEncryption::openCallbackGet() != nullptr) {
+					lWarning() << "Not enabling sqlite3 WAL journal mode: it is not supported by the encrypted VFS";
+				} else {
+#ifdef _WIN32
+					uri += " vfs=win32";
+#else
+					uri += " vfs=unix";
+#endif
+				}
+			}
 			lInfo() << "Opening linphone database " << uri << " with backend " << backend;
 			uri = LinphonePrivate::Utils::localeToUtf8(uri); // `mainDb->connect` take a UTF8 string.
 			auto startMs = bctbx_get_cur_time_ms();
@@ -399,6 +415,7 @@ void CorePrivate::uninit() {
 	}
 
 	chatRoomsById.clear();
+	clearChatRoomIndexes();
 
 	// https://gcc.gnu.org/bugzilla/show_bug.cgi?format=multiple&id=81767
 #if __GNUC__ == 7
@@ -1785,6 +1802,8 @@ void Core::insertConference(const shared_ptr<Conference> conference) {
 		           << conf << " with " << conference << ". This might happen if your database has been corrupted";
 		d->conferenceById[conferenceId] = conference;
 	}
+	const auto &chatRoom = conference->getChatRoom();
+	if (chatRoom) d->indexChatRoom(chatRoom);
 }
 
 void Core::deleteConference(const ConferenceId &conferenceId) {
@@ -1792,6 +1811,8 @@ void Core::deleteConference(const ConferenceId &conferenceId) {
 	auto it = d->conferenceById.find(conferenceId);
 	if (it != d->conferenceById.cend()) {
 		lInfo() << "Delete audio video conference in RAM with conference ID " << conferenceId << ".";
+		const auto chatRoom = it->second->getChatRoom();
+		if (chatRoom) d->unindexChatRoom(chatRoom);
 		d->conferenceById.erase(it);
 	}
 }
@@ -1802,6 +1823,8 @@ void Core::deleteConference(const shared_ptr<const Conference> &conference) {
 	auto it = d->conferenceById.find(conferenceId);
 	if (it != d->conferenceById.cend()) {
 		lInfo() << "Delete audio video conference in RAM with conference ID " << conferenceId << ".";
+		const auto chatRoom = it->second->getChatRoom();
+		if (chatRoom) d->unindexChatRoom(chatRoom);
 		d->conferenceById.erase(it);
 	}
 }
@@ -39,12 +39,20 @@ class AbstractDbPrivate : public ObjectPrivate {
 public:
 #ifdef HAVE_DB_STORAGE
 	DbSession dbSession;
+	// Optional second connection used by read-only queries, see AbstractDb::openReadSession().
+	DbSession readDbSession;
+
+	// Returns the read connection if one is opened, the main one otherwise.
+	virtual soci::session *getReadSession() const {
+		return readDbSession ? readDbSession.getBackendSession() : dbSession.getBackendSession();
+	}
 #endif
 
 private:
 	void safeInit();
 
 	AbstractDb::Backend backend;
+	std::string connectionParams;
 	bool initialized = false;
 
 	L_DECLARE_PUBLIC(AbstractDb);
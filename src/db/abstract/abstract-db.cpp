@@ -54,6 +54,8 @@ void AbstractDbPrivate::safeInit() {
 	L_Q();
 	dbSession.enableForeignKeys(false);
 	q->init();
+	// Schema updates may have altered the tables the statements were prepared against.
+	dbSession.clearPreparedStatements();
 	dbSession.enableForeignKeys(true);
 	initialized = true;
 #endif
@@ -90,6 +92,8 @@ bool AbstractDb::connect(Backend backend, const string &nameParams) {
 	registerBackend(backend);
 
 	d->backend = backend;
+	d->connectionParams = nameParams;
+	d->readDbSession = DbSession();
 	d->dbSession = DbSession((backend == Mysql ? "mysql://" : "sqlite3://") + nameParams);
 
 	if (d->dbSession) {
@@ -122,6 +126,8 @@ bool AbstractDb::connect(Backend backend, const string &nameParams) {
 void AbstractDb::disconnect() {
 #ifdef HAVE_DB_STORAGE
 	L_D();
+	if (d->dbSession) flushPendingWrites();
+	d->readDbSession = DbSession();
 	d->dbSession = DbSession();
 #endif
 }
@@ -137,10 +143,16 @@ bool AbstractDb::forceReconnect() {
 	constexpr int retryCount = 2;
 	lInfo() << "Trying sql backend reconnect...";
 
+	// Deferred writes are lost if the connection is really broken, but do not drop them on an explicit reconnect.
+	flushPendingWrites();
+
 	try {
 		for (int i = 0; i < retryCount; ++i) {
 			try {
 				lInfo() << "Reconnect... Try: " << i;
+				// Reopened by init() if still wanted.
+				closeReadSession();
+				d->dbSession.clearPreparedStatements();
 				d->dbSession.getBackendSession()->reconnect(); // Equivalent to close and connect.
 				d->safeInit();
 				lInfo() << "Database reconnection successful!";
@@ -169,12 +181,40 @@ bool AbstractDb::import(Backend, const string &) {
 	return false;
 }
 
+bool AbstractDb::flushPendingWrites() {
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 
 void AbstractDb::init() {
 	// Nothing.
 }
 
+bool AbstractDb::openReadSession() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	if (d->readDbSession) return true;
+
+	d->readDbSession = DbSession((d->backend == Mysql ? "mysql://" : "sqlite3://") + d->connectionParams);
+	if (!d->readDbSession) {
+		lWarning() << "Unable to open read connection on database, main connection will be used for reads.";
+		return false;
+	}
+	lInfo() << "Read connection opened on database.";
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AbstractDb::closeReadSession() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	d->readDbSession = DbSession();
+#endif
+}
+
 bool AbstractDb::isInitialized() const {
 	L_D();
 	return d->initialized;
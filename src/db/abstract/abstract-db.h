@@ -50,6 +50,9 @@ public:
 
 	bool forceReconnect();
 
+	// Commits the writes an implementation may have deferred. Always called before the connection is closed.
+	virtual bool flushPendingWrites();
+
 	Backend getBackend() const;
 
 	virtual bool import(Backend backend, const std::string &parameters);
@@ -63,6 +66,11 @@ protected:
 
 	virtual void init();
 
+	// Opens a second connection on the same database, to be used by read-only queries. Only meaningful if the
+	// backend allows readers to run concurrently with a writer (e.g. sqlite3 in WAL mode).
+	bool openReadSession();
+	void closeReadSession();
+
 private:
 	L_DECLARE_PRIVATE(AbstractDb);
 	L_DISABLE_COPY(AbstractDb);
@@ -37,16 +37,17 @@ LINPHONE_BEGIN_NAMESPACE
 
 class SmartTransaction {
 public:
-	SmartTransaction(soci::session *session, const char *name) : mSession(session), mName(name), mIsCommitted(false) {
+	SmartTransaction(const MainDbPrivate *mainDbPrivate, const char *name)
+	    : mMainDbPrivate(mainDbPrivate), mName(name), mIsCommitted(false) {
 		lDebug() << "Start transaction " << this << " in MainDb::" << mName << ".";
-		mSession->begin();
+		mSavepoint = mMainDbPrivate->beginTransaction();
 	}
 
 	~SmartTransaction() {
 		if (!mIsCommitted) {
 			lDebug() << "Rollback transaction " << this << " in MainDb::" << mName << ".";
 			try {
-				mSession->rollback();
+				mMainDbPrivate->rollbackTransaction(mSavepoint);
 			} catch (std::runtime_error &e) {
 				lError() << "Error during rollback transaction " << this << " in MainDb::" << mName
 				         << ". Error : " << e.what();
@@ -62,11 +63,12 @@ public:
 
 		lDebug() << "Commit transaction " << this << " in MainDb::" << mName << ".";
 		mIsCommitted = true;
-		mSession->commit();
+		mMainDbPrivate->commitTransaction(mSavepoint);
 	}
 
 private:
-	soci::session *mSession;
+	const MainDbPrivate *mMainDbPrivate;
+	std::string mSavepoint;
 	const char *mName;
 	bool mIsCommitted;
 
@@ -96,10 +98,10 @@ public:
 	DbTransaction(DbTransactionInfo &info, Function &&function) : mFunction(std::move(function)) {
 		MainDb *mainDb = info.mainDb;
 		const char *name = info.name;
-		soci::session *session = mainDb->getPrivate()->dbSession.getBackendSession();
+		const MainDbPrivate *mainDbPrivate = mainDb->getPrivate();
 
 		try {
-			SmartTransaction tr(session, name);
+			SmartTransaction tr(mainDbPrivate, name);
 			mResult = exec<InternalReturnType>(tr);
 		} catch (const soci::soci_error &e) {
 			lWarning() << "Caught exception in MainDb::" << name << "(" << e.what() << ").";
@@ -107,7 +109,7 @@ public:
 			if ((category == soci::soci_error::connection_error || category == soci::soci_error::unknown) &&
 			    mainDb->forceReconnect()) {
 				try {
-					SmartTransaction tr(session, name);
+					SmartTransaction tr(mainDbPrivate, name);
 					mResult = exec<InternalReturnType>(tr);
 				} catch (const std::exception &e) {
 					lError() << "Unable to execute query after reconnect in MainDb::" << name << "(" << e.what()
@@ -47,6 +47,15 @@ enum Insert { InsertOneToOneChatRoom, InsertCount };
 
 const char *get(Select selectStmt);
 const char *get(Insert insertStmt, AbstractDb::Backend backend);
+
+// Keys under which prepared statements are cached in a DbSession, unique across statement kinds.
+constexpr int getKey(Select selectStmt) {
+	return int(selectStmt);
+}
+
+constexpr int getKey(Insert insertStmt) {
+	return int(SelectCount) + int(insertStmt);
+}
 } // namespace Statements
 
 LINPHONE_END_NAMESPACE
@@ -22,6 +22,7 @@
 #define _L_MAIN_DB_P_H_
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "linphone/utils/utils.h"
 
@@ -45,6 +46,40 @@ public:
 	mutable std::unordered_map<long long, std::weak_ptr<CallLog>> storageIdToCallLog;
 	mutable std::unordered_map<long long, std::weak_ptr<ConferenceInfo>> storageIdToConferenceInfo;
 
+	// ---------------------------------------------------------------------------
+	// Sip address cache API.
+	// ---------------------------------------------------------------------------
+
+	// Rows of the sip_address table are never deleted and their value never changes, so a cached id stays valid as
+	// long as the transaction that created it is committed. These must be called by the transaction owner.
+	void commitSipAddressCache() const;
+	void rollbackSipAddressCache() const;
+	void clearSipAddressCache() const;
+
+	mutable unsigned long sipAddressCacheHits = 0;
+	mutable unsigned long sipAddressCacheMisses = 0;
+
+	// Runs a passive WAL checkpoint if the configured interval has elapsed. Called after each commit.
+	void checkpointWalIfNeeded() const;
+
+	// ---------------------------------------------------------------------------
+	// Transactions API.
+	// ---------------------------------------------------------------------------
+
+	// Starts a transaction, or a savepoint if a write-behind batch is pending. Returns the savepoint name, or an empty
+	// string for a real transaction. Must be paired with commitTransaction() or rollbackTransaction().
+	std::string beginTransaction() const;
+	void commitTransaction(const std::string &savepoint) const;
+	void rollbackTransaction(const std::string &savepoint) const;
+
+	// Commits the pending write-behind batch, if any.
+	bool commitWriteBehindBatch() const;
+	// Removes the events recorded by the innermost transaction or savepoint, and returns them.
+	std::unordered_set<long long> popTransactionEventIds() const;
+
+	// Uncommitted writes of a pending batch are only visible from the main connection.
+	soci::session *getReadSession() const override;
+
 private:
 	// ---------------------------------------------------------------------------
 	// Misc helpers.
@@ -53,6 +88,14 @@ private:
 	std::shared_ptr<AbstractChatRoom> findChatRoom(const ConferenceId &conferenceId) const;
 	std::shared_ptr<Conference> findConference(const ConferenceId &conferenceId) const;
 
+	// Removes the participant matching the local address of the conference from the list, and returns it.
+	static std::shared_ptr<Participant> extractMe(std::list<std::shared_ptr<Participant>> &participants,
+	                                              const ConferenceId &conferenceId);
+	// Loads the participants of a chat room restored without them by MainDb::getChatRooms().
+	static std::function<void()> createParticipantsLoader(const std::shared_ptr<Conference> &conference,
+	                                                      const ConferenceId &conferenceId,
+	                                                      long long dbChatRoomId);
+
 	// ---------------------------------------------------------------------------
 	// Low level API.
 	// ---------------------------------------------------------------------------
@@ -102,6 +145,11 @@ private:
 	long long selectSipAddressId(const std::string &sipAddress) const;
 	long long selectSipAddressId(const std::shared_ptr<Address> &address) const;
 	std::string selectSipAddressFromId(long long sipAddressId) const;
+	// Contents of the chat messages whose event ids are in the comma separated list, by event id.
+	std::unordered_map<long long, std::list<std::shared_ptr<Content>>>
+	selectChatMessagesContents(const std::string &eventIdList) const;
+	// Comma separated ids of the sip addresses equal to `sipAddress` or only extending it with uri parameters.
+	std::string selectSipAddressIdList(const std::string &sipAddress) const;
 	long long selectChatRoomId(long long peerSipAddressId, long long localSipAddressId) const;
 	long long selectChatRoomId(const ConferenceId &conferenceId) const;
 	ConferenceId selectConferenceId(const long long chatRoomId) const;
@@ -166,6 +214,9 @@ private:
 
 	std::shared_ptr<EventLog>
 	selectConferenceSubjectEvent(const ConferenceId &conferenceId, EventLog::Type type, const soci::row &row) const;
+
+	// Must be called within a transaction. Does not look up the event cache.
+	std::shared_ptr<EventLog> selectConferenceEventFromStorageId(long long storageId) const;
 #endif
 
 	long long insertEvent(const std::shared_ptr<EventLog> &eventLog);
@@ -236,6 +287,32 @@ private:
 
 	void invalidConferenceEventsFromQuery(const std::string &query, long long chatRoomId);
 
+	// Events inserted or updated by the current transaction, whose commit may be deferred to a write-behind batch.
+	void recordBatchEvent(long long eventId) const;
+	// Called when writes are rolled back: events inserted by them lose their storage id, and all the events they
+	// touched are dropped from the caches to be reloaded from the database.
+	void discardBatchEvents(const std::unordered_set<long long> &eventIds) const;
+
+	void cacheSipAddress(const std::string &sipAddress, long long sipAddressId) const;
+	void cacheSipAddressDisplayName(const std::string &sipAddress, const std::string &displayName) const;
+
+	// ---------------------------------------------------------------------------
+	// Sqlite3 storage profile.
+	// ---------------------------------------------------------------------------
+
+	void configureSqliteStorage();
+	void openSqliteReadSession();
+
+	// ---------------------------------------------------------------------------
+	// Chat message search.
+	// ---------------------------------------------------------------------------
+
+	void createChatMessageSearchIndex();
+	void indexChatMessageText(long long chatMessageId, const std::string &text);
+	void unindexChatMessages(const std::string &eventIdsQuery, long long id);
+	long long getChatMessageSearchBackfillBound();
+	void setChatMessageSearchBackfillBound(long long bound);
+
 	// ---------------------------------------------------------------------------
 	// Versions.
 	// ---------------------------------------------------------------------------
@@ -258,6 +335,43 @@ private:
 
 	mutable LruCache<ConferenceId, int> unreadChatMessageCountCache;
 
+	struct SipAddressCacheEntry {
+		long long id;
+		std::string displayName;
+		bool displayNameKnown;
+	};
+
+	mutable LruCache<std::string, SipAddressCacheEntry> sipAddressToIdCache;
+	mutable LruCache<long long, std::string> idToSipAddressCache;
+	// Entries cached during the current transaction, dropped on rollback if the transaction wrote to sip_address.
+	mutable std::unordered_map<std::string, long long> uncommittedSipAddresses;
+	mutable bool sipAddressesWritten = false;
+
+	bool walEnabled = false;
+	int walCheckpointInterval = 0;
+	mutable time_t lastWalCheckpoint = 0;
+
+	bool writeBehindEnabled = false;
+	int writeBehindMaxDelay = 0;
+	int writeBehindMaxTransactions = 0;
+	mutable bool writeBehindBatchPending = false;
+	mutable uint64_t writeBehindBatchStartTime = 0;
+	mutable int writeBehindBatchSize = 0;
+	mutable int savepointDepth = 0;
+	int writeBatchDepth = 0;
+	mutable std::unordered_set<long long> writeBehindBatchEventIds;
+	// Events recorded by each opened transaction or savepoint, innermost last.
+	mutable std::vector<std::unordered_set<long long>> transactionEventIds;
+
+	// True if the FTS5 index of chat message texts is available (Sqlite3 only).
+	bool chatMessageSearchIndexEnabled = false;
+	bool chatMessageSearchBackfillScheduled = false;
+
+	bool historyContentsPrefetchEnabled = true;
+
+	// Participants of group chat rooms are only loaded when first accessed.
+	bool lazyChatRoomLoadingEnabled = false;
+
 	L_DECLARE_PUBLIC(MainDb);
 };
 
@@ -82,6 +82,9 @@ constexpr unsigned int ModuleVersionLegacyFriendsImport = makeVersion(1, 0, 0);
 constexpr unsigned int ModuleVersionLegacyHistoryImport = makeVersion(1, 0, 0);
 constexpr unsigned int ModuleVersionLegacyCallLogsImport = makeVersion(1, 0, 0);
 
+// Number of messages indexed per core iteration while backfilling the chat message search index.
+constexpr unsigned int ChatMessageSearchBackfillChunkSize = 500;
+
 constexpr int LegacyFriendListColId = 0;
 constexpr int LegacyFriendListColName = 1;
 constexpr int LegacyFriendListColRlsUri = 2;
@@ -299,6 +302,53 @@ shared_ptr<Conference> MainDbPrivate::findConference(const ConferenceId &confere
 	if (!conference) lError() << "Unable to find audio video conference: " << conferenceId << ".";
 	return conference;
 }
+
+shared_ptr<Participant> MainDbPrivate::extractMe(list<shared_ptr<Participant>> &participants,
+                                                 const ConferenceId &conferenceId) {
+	const auto &localAddress = conferenceId.getLocalAddress();
+	const auto meIt = std::find_if(participants.begin(), participants.end(), [&localAddress](const auto &participant) {
+		return (participant->getAddress()->weakEqual(*localAddress));
+	});
+	if (meIt == participants.end()) return nullptr;
+	shared_ptr<Participant> me = *meIt;
+	participants.erase(meIt);
+	return me;
+}
+
+std::function<void()> MainDbPrivate::createParticipantsLoader(const shared_ptr<Conference> &conference,
+                                                              const ConferenceId &conferenceId,
+                                                              long long dbChatRoomId) {
+	return [weakConference = weak_ptr<Conference>(conference), conferenceId, dbChatRoomId]() {
+		shared_ptr<Conference> conference = weakConference.lock();
+		if (!conference) return;
+		shared_ptr<Core> core;
+		try {
+			core = conference->getCore();
+		} catch (const bad_weak_ptr &) {
+			return;
+		}
+		const auto &mainDb = core->getPrivate()->mainDb;
+		if (!mainDb || !mainDb->isInitialized()) return;
+
+		DurationLogger durationLogger("Load participants of chat room.");
+		list<shared_ptr<Participant>> participants = mainDb->selectChatRoomParticipants(dbChatRoomId);
+		shared_ptr<Participant> me = extractMe(participants, conferenceId);
+		if (me) {
+			const auto &localMe = conference->getMe();
+			localMe->setAdmin(me->isAdmin());
+			for (const auto &device : me->getDevices()) {
+				localMe->addDevice(device);
+			}
+		} else {
+			lError() << "Unable to find me in: " << conferenceId;
+		}
+		conference->setParticipants(std::move(participants));
+		for (auto participant : conference->getParticipants()) {
+			participant->setConference(conference);
+		}
+		core->getPrivate()->insertFriendDevices(conference->getParticipants());
+	};
+}
 // -----------------------------------------------------------------------------
 // Low level API.
 // -----------------------------------------------------------------------------
@@ -318,12 +368,22 @@ long long MainDbPrivate::insertSipAddress(BCTBX_UNUSED(const std::shared_ptr<Add
 		    << "INSERT INTO sip_address (value, display_name) VALUES (:sipAddress, :displayName)",
 		    soci::use(sipAddress), soci::use(displayName, displayNameInd);
 
-		return dbSession.getLastInsertId();
+		sipAddressesWritten = true;
+		sipAddressId = dbSession.getLastInsertId();
+		cacheSipAddress(sipAddress, sipAddressId);
+		cacheSipAddressDisplayName(sipAddress, displayName);
+		return sipAddressId;
 	} else if (sipAddressId >= 0 && !displayName.empty()) {
+		const SipAddressCacheEntry *entry = sipAddressToIdCache[sipAddress];
+		if (entry && entry->displayNameKnown && entry->displayName == displayName) return sipAddressId;
+
 		lInfo() << "Updating sip address display name in database: `" << sipAddress << "`.";
 
 		*dbSession.getBackendSession() << "UPDATE sip_address SET display_name = :displayName WHERE id = :id",
 		    soci::use(displayName), soci::use(sipAddressId);
+
+		sipAddressesWritten = true;
+		cacheSipAddressDisplayName(sipAddress, displayName);
 	}
 
 	return sipAddressId;
@@ -359,6 +419,8 @@ void MainDbPrivate::insertContent(long long chatMessageId, const Content &conten
 		            " (:chatMessageContentId, :name, :data)",
 		    soci::use(chatMessageContentId), soci::use(property.first), soci::use(property.second.getValue<string>());
 	}
+
+	if (content.getContentType() == ContentType::PlainText) indexChatMessageText(chatMessageId, body);
 #endif
 }
 
@@ -920,23 +982,26 @@ long long MainDbPrivate::insertOrUpdateFriendList(const std::shared_ptr<FriendLi
 	std::string syncUri = list->getUri();
 	int revision = list->mRevision;
 	int type = list->getType();
+	std::string syncToken = list->mSyncToken;
 
 	if (friendListId > 0) {
 		*dbSession.getBackendSession()
 		    << "UPDATE friends_list SET "
-		       "name = :name, rls_uri = :rlsUri, sync_uri = :syncUri, revision = :revision, type = :type "
+		       "name = :name, rls_uri = :rlsUri, sync_uri = :syncUri, revision = :revision, type = :type, "
+		       "sync_token = :syncToken "
 		       "WHERE id = :friendListId",
 		    soci::use(name), soci::use(rlsUri), soci::use(syncUri), soci::use(revision), soci::use(type),
-		    soci::use(friendListId);
+		    soci::use(syncToken), soci::use(friendListId);
 	} else {
 		lInfo() << "Insert new friend list in database: " << name;
 
 		*dbSession.getBackendSession() << "INSERT INTO friends_list ("
-		                                  "name, rls_uri, sync_uri, revision, type"
+		                                  "name, rls_uri, sync_uri, revision, type, sync_token"
 		                                  ") VALUES ("
-		                                  ":name, :rlsUri, :syncUri, :revision, :type"
+		                                  ":name, :rlsUri, :syncUri, :revision, :type, :syncToken"
 		                                  ")",
-		    soci::use(name), soci::use(rlsUri), soci::use(syncUri), soci::use(revision), soci::use(type);
+		    soci::use(name), soci::use(rlsUri), soci::use(syncUri), soci::use(revision), soci::use(type),
+		    soci::use(syncToken);
 
 		friendListId = dbSession.getLastInsertId();
 	}
@@ -1004,12 +1069,25 @@ long long MainDbPrivate::selectSipAddressId(const std::shared_ptr<Address> &addr
 
 long long MainDbPrivate::selectSipAddressId(const string &sipAddress) const {
 #ifdef HAVE_DB_STORAGE
-	long long sipAddressId;
+	const SipAddressCacheEntry *entry = sipAddressToIdCache.touch(sipAddress);
+	if (entry) {
+		sipAddressCacheHits++;
+		return entry->id;
+	}
+	sipAddressCacheMisses++;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectSipAddressId), soci::use(sipAddress), soci::into(sipAddressId);
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectSipAddressId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectSipAddressId),
+		                                soci::use(stmt.text), soci::into(stmt.resultId)));
+	    });
+	statement.text = sipAddress;
+
+	if (!statement.execute()) return -1;
 
-	return session->got_data() ? sipAddressId : -1;
+	cacheSipAddress(sipAddress, statement.resultId);
+	return statement.resultId;
 #else
 	return -1;
 #endif
@@ -1017,26 +1095,64 @@ long long MainDbPrivate::selectSipAddressId(const string &sipAddress) const {
 
 std::string MainDbPrivate::selectSipAddressFromId(long long sipAddressId) const {
 #ifdef HAVE_DB_STORAGE
-	std::string sipAddress;
+	const string *sipAddress = idToSipAddressCache.touch(sipAddressId);
+	if (sipAddress) {
+		sipAddressCacheHits++;
+		return *sipAddress;
+	}
+	sipAddressCacheMisses++;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectSipAddressFromId), soci::use(sipAddressId), soci::into(sipAddress);
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectSipAddressFromId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectSipAddressFromId),
+		                                soci::use(stmt.ids[0]), soci::into(stmt.resultText)));
+	    });
+	statement.ids[0] = sipAddressId;
 
-	return session->got_data() ? sipAddress : std::string();
+	if (!statement.execute()) return std::string();
+
+	cacheSipAddress(statement.resultText, sipAddressId);
+	return statement.resultText;
 #else
 	return std::string();
 #endif
 }
 
-long long MainDbPrivate::selectChatRoomId(long long peerSipAddressId, long long localSipAddressId) const {
+string MainDbPrivate::selectSipAddressIdList(const string &sipAddress) const {
 #ifdef HAVE_DB_STORAGE
-	long long chatRoomId;
+	// Parameters of ordered uris start with ';', so "sip:a@b;..." sorts between "sip:a@b;" and "sip:a@b<". Unlike a
+	// LIKE pattern, this range is resolved from the unique index on sip_address.value.
+	const string paramsBegin = sipAddress + ";";
+	const string paramsEnd = sipAddress + "<";
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomId), soci::use(peerSipAddressId),
-	    soci::use(localSipAddressId), soci::into(chatRoomId);
+	string idList;
+	soci::rowset<soci::row> rows =
+	    (getReadSession()->prepare << "SELECT id FROM sip_address"
+	                                  " WHERE value = :sipAddress OR (value > :paramsBegin AND value < :paramsEnd)",
+	     soci::use(sipAddress), soci::use(paramsBegin), soci::use(paramsEnd));
+	for (const auto &row : rows) {
+		if (!idList.empty()) idList += ",";
+		idList += Utils::toString(dbSession.resolveId(row, 0));
+	}
+	return idList;
+#else
+	return std::string();
+#endif
+}
+
+long long MainDbPrivate::selectChatRoomId(long long peerSipAddressId, long long localSipAddressId) const {
+#ifdef HAVE_DB_STORAGE
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectChatRoomId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectChatRoomId),
+		                                soci::use(stmt.ids[0]), soci::use(stmt.ids[1]), soci::into(stmt.resultId)));
+	    });
+	statement.ids[0] = peerSipAddressId;
+	statement.ids[1] = localSipAddressId;
 
-	return session->got_data() ? chatRoomId : -1;
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1085,13 +1201,16 @@ ConferenceId MainDbPrivate::selectConferenceId(const long long chatRoomId) const
 
 long long MainDbPrivate::selectChatRoomParticipantId(long long chatRoomId, long long participantSipAddressId) const {
 #ifdef HAVE_DB_STORAGE
-	long long chatRoomParticipantId;
-
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomParticipantId), soci::use(chatRoomId),
-	    soci::use(participantSipAddressId), soci::into(chatRoomParticipantId);
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectChatRoomParticipantId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectChatRoomParticipantId),
+		                                soci::use(stmt.ids[0]), soci::use(stmt.ids[1]), soci::into(stmt.resultId)));
+	    });
+	statement.ids[0] = chatRoomId;
+	statement.ids[1] = participantSipAddressId;
 
-	return session->got_data() ? chatRoomParticipantId : -1;
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1100,16 +1219,23 @@ long long MainDbPrivate::selectChatRoomParticipantId(long long chatRoomId, long
 long long
 MainDbPrivate::selectOneToOneChatRoomId(long long sipAddressIdA, long long sipAddressIdB, bool encrypted) const {
 #ifdef HAVE_DB_STORAGE
-	long long chatRoomId;
 	const int encryptedCapability = int(ChatRoom::Capabilities::Encrypted);
 	const int expectedCapabilities = encrypted ? encryptedCapability : 0;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectOneToOneChatRoomId), soci::use(sipAddressIdA, "1"),
-	    soci::use(sipAddressIdB, "2"), soci::use(encryptedCapability, "3"), soci::use(expectedCapabilities, "4"),
-	    soci::into(chatRoomId);
-
-	return session->got_data() ? chatRoomId : -1;
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectOneToOneChatRoomId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectOneToOneChatRoomId),
+		                                soci::use(stmt.ids[0], "1"), soci::use(stmt.ids[1], "2"),
+		                                soci::use(stmt.ids[2], "3"), soci::use(stmt.ids[3], "4"),
+		                                soci::into(stmt.resultId)));
+	    });
+	statement.ids[0] = sipAddressIdA;
+	statement.ids[1] = sipAddressIdB;
+	statement.ids[2] = encryptedCapability;
+	statement.ids[3] = expectedCapabilities;
+
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1117,13 +1243,15 @@ MainDbPrivate::selectOneToOneChatRoomId(long long sipAddressIdA, long long sipAd
 
 long long MainDbPrivate::selectConferenceInfoId(long long uriSipAddressId) {
 #ifdef HAVE_DB_STORAGE
-	long long conferenceInfoId;
-
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceInfoId), soci::use(uriSipAddressId),
-	    soci::into(conferenceInfoId);
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectConferenceInfoId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectConferenceInfoId),
+		                                soci::use(stmt.ids[0]), soci::into(stmt.resultId)));
+	    });
+	statement.ids[0] = uriSipAddressId;
 
-	return session->got_data() ? conferenceInfoId : -1;
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1132,13 +1260,17 @@ long long MainDbPrivate::selectConferenceInfoId(long long uriSipAddressId) {
 long long MainDbPrivate::selectConferenceInfoParticipantId(long long conferenceInfoId,
                                                            long long participantSipAddressId) const {
 #ifdef HAVE_DB_STORAGE
-	long long conferenceInfoParticipantId;
-
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceInfoParticipantId), soci::use(conferenceInfoId),
-	    soci::use(participantSipAddressId), soci::into(conferenceInfoParticipantId);
-
-	return session->got_data() ? conferenceInfoParticipantId : -1;
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectConferenceInfoParticipantId),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement(
+		        (session->prepare << Statements::get(Statements::SelectConferenceInfoParticipantId),
+		         soci::use(stmt.ids[0]), soci::use(stmt.ids[1]), soci::into(stmt.resultId)));
+	    });
+	statement.ids[0] = conferenceInfoId;
+	statement.ids[1] = participantSipAddressId;
+
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1146,12 +1278,15 @@ long long MainDbPrivate::selectConferenceInfoParticipantId(long long conferenceI
 
 long long MainDbPrivate::selectConferenceCallId(const std::string &callId) {
 #ifdef HAVE_DB_STORAGE
-	long long conferenceCallId;
+	DbSession::PreparedStatement &statement = dbSession.getPreparedStatement(
+	    Statements::getKey(Statements::SelectConferenceCall),
+	    [](soci::session *session, DbSession::PreparedStatement &stmt) {
+		    return new soci::statement((session->prepare << Statements::get(Statements::SelectConferenceCall),
+		                                soci::use(stmt.text), soci::into(stmt.resultId)));
+	    });
+	statement.text = callId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectConferenceCall), soci::use(callId), soci::into(conferenceCallId);
-
-	return session->got_data() ? conferenceCallId : -1;
+	return statement.execute() ? statement.resultId : -1;
 #else
 	return -1;
 #endif
@@ -1163,6 +1298,7 @@ void MainDbPrivate::deleteContents(long long chatMessageId) {
 #ifdef HAVE_DB_STORAGE
 	*dbSession.getBackendSession() << "DELETE FROM chat_message_content WHERE event_id = :chatMessageId",
 	    soci::use(chatMessageId);
+	unindexChatMessages("SELECT :chatMessageId", chatMessageId);
 #endif
 }
 
@@ -1396,6 +1532,21 @@ shared_ptr<EventLog> MainDbPrivate::selectConferenceSubjectEvent(const Conferenc
 	event->setNotifyId(getConferenceEventNotifyIdFromRow(row));
 	return event;
 }
+
+shared_ptr<EventLog> MainDbPrivate::selectConferenceEventFromStorageId(long long storageId) const {
+	// TODO: Improve. Deal with all events in the future.
+	soci::session *session = dbSession.getBackendSession();
+	soci::row row;
+	*session << Statements::get(Statements::SelectConferenceEvent), soci::into(row), soci::use(storageId);
+	if (!session->got_data()) return nullptr;
+
+	ConferenceId conferenceId(Address::create(row.get<string>(16))->getSharedFromThis(),
+	                          Address::create(row.get<string>(17)));
+	shared_ptr<AbstractChatRoom> chatRoom = findChatRoom(conferenceId);
+	if (!chatRoom) return nullptr;
+
+	return selectGenericConferenceEvent(chatRoom, row);
+}
 #endif
 
 // -----------------------------------------------------------------------------
@@ -1624,6 +1775,7 @@ void MainDbPrivate::updateConferenceChatMessageEvent(const shared_ptr<EventLog>
 	MainDbKeyPrivate *dEventKey = static_cast<MainDbKey &>(dEventLog->dbKey).getPrivate();
 	const long long &eventId = dEventKey->storageId;
 	soci::session *session = dbSession.getBackendSession();
+	recordBatchEvent(eventId);
 
 	// 1. Get current chat message state and database state.
 	const ChatMessage::State state = chatMessage->getState();
@@ -1944,14 +2096,15 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 	const long long &eventId = dEventKey->storageId;
 	auto participantAddressWithoutGruu = Address::create(participantAddress->getUriWithoutGruu());
 	long long participantSipAddressId = selectSipAddressId(participantAddressWithoutGruu);
-	long long nbEntries;
-	*dbSession.getBackendSession() << "SELECT count(*) FROM chat_message_participant WHERE event_id = :eventId AND "
-	                                  "participant_sip_address_id = :participantSipAddressId",
-	    soci::into(nbEntries), soci::use(eventId), soci::use(participantSipAddressId);
+	soci::session *session = dbSession.getBackendSession();
+	int intState = 0;
+	*session << "SELECT state FROM chat_message_participant WHERE event_id = :eventId AND "
+	            "participant_sip_address_id = :participantSipAddressId",
+	    soci::into(intState), soci::use(eventId), soci::use(participantSipAddressId);
 
 	int stateInt = int(state);
 
-	if (nbEntries == 0) {
+	if (!session->got_data()) {
 		if (participantSipAddressId <= 0) {
 			// If the address is not found in the DB, add it
 			participantSipAddressId = insertSipAddress(participantAddressWithoutGruu);
@@ -1962,10 +2115,6 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 		/* setChatMessageParticipantState can be called by updateConferenceChatMessageEvent, which try to update
 		 participant state by message state. However, we can not change state Displayed/DeliveredToUser to
 		 Delivered/NotDelivered. */
-		int intState;
-		*dbSession.getBackendSession() << "SELECT state FROM chat_message_participant WHERE event_id = :eventId AND "
-		                                  "participant_sip_address_id = :participantSipAddressId",
-		    soci::into(intState), soci::use(eventId), soci::use(participantSipAddressId);
 		ChatMessage::State dbState = ChatMessage::State(intState);
 
 		if (int(state) < intState &&
@@ -1975,10 +2124,9 @@ void MainDbPrivate::setChatMessageParticipantState(const shared_ptr<EventLog> &e
 		}
 
 		auto stateChangeTm = dbSession.getTimeWithSociIndicator(stateChangeTime);
-		*dbSession.getBackendSession()
-		    << "UPDATE chat_message_participant SET state = :state,"
-		       " state_change_time = :stateChangeTm"
-		       " WHERE event_id = :eventId AND participant_sip_address_id = :participantSipAddressId",
+		*session << "UPDATE chat_message_participant SET state = :state,"
+		            " state_change_time = :stateChangeTm"
+		            " WHERE event_id = :eventId AND participant_sip_address_id = :participantSipAddressId",
 		    soci::use(stateInt), soci::use(stateChangeTm.first, stateChangeTm.second), soci::use(eventId),
 		    soci::use(participantSipAddressId);
 	}
@@ -2297,6 +2445,7 @@ std::shared_ptr<FriendList> MainDbPrivate::selectFriendList(const soci::row &row
 	friendList->setUri(row.get<string>(3));
 	friendList->mRevision = row.get<int>(4);
 	friendList->setType((LinphoneFriendListType)row.get<int>(5));
+	friendList->mSyncToken = row.get<string>(6, "");
 
 	return friendList;
 }
@@ -2410,6 +2559,46 @@ void MainDbPrivate::cache(const std::shared_ptr<ConferenceInfo> &conferenceInfo,
 #endif
 }
 
+void MainDbPrivate::cacheSipAddress(const string &sipAddress, long long sipAddressId) const {
+	if (!sipAddressToIdCache[sipAddress]) sipAddressToIdCache.insert(sipAddress, {sipAddressId, string(), false});
+	idToSipAddressCache.insert(sipAddressId, sipAddress);
+	uncommittedSipAddresses[sipAddress] = sipAddressId;
+}
+
+void MainDbPrivate::cacheSipAddressDisplayName(const string &sipAddress, const string &displayName) const {
+	SipAddressCacheEntry *entry = sipAddressToIdCache[sipAddress];
+	if (!entry) return;
+
+	entry->displayName = displayName;
+	entry->displayNameKnown = true;
+	uncommittedSipAddresses[sipAddress] = entry->id;
+}
+
+void MainDbPrivate::commitSipAddressCache() const {
+	uncommittedSipAddresses.clear();
+	sipAddressesWritten = false;
+}
+
+void MainDbPrivate::rollbackSipAddressCache() const {
+	// Read-only transactions are never committed, what they cached comes from committed rows and can be kept.
+	if (sipAddressesWritten) {
+		for (const auto &sipAddress : uncommittedSipAddresses) {
+			sipAddressToIdCache.erase(sipAddress.first);
+			idToSipAddressCache.erase(sipAddress.second);
+		}
+	}
+	commitSipAddressCache();
+}
+
+void MainDbPrivate::clearSipAddressCache() const {
+	if (sipAddressCacheHits + sipAddressCacheMisses > 0)
+		lInfo() << "Clearing sip address cache (hits: " << sipAddressCacheHits
+		        << ", misses: " << sipAddressCacheMisses << ")";
+	sipAddressToIdCache.clear();
+	idToSipAddressCache.clear();
+	commitSipAddressCache();
+}
+
 void MainDbPrivate::invalidConferenceEventsFromQuery(const string &query, long long chatRoomId) {
 #ifdef HAVE_DB_STORAGE
 	soci::rowset<soci::row> rows = (dbSession.getBackendSession()->prepare << query, soci::use(chatRoomId));
@@ -2432,6 +2621,364 @@ void MainDbPrivate::invalidConferenceEventsFromQuery(const string &query, long l
 #endif
 }
 
+void MainDbPrivate::recordBatchEvent(long long eventId) const {
+#ifdef HAVE_DB_STORAGE
+	if ((!writeBehindEnabled && writeBatchDepth == 0) || transactionEventIds.empty()) return;
+	transactionEventIds.back().insert(eventId);
+#endif
+}
+
+void MainDbPrivate::discardBatchEvents(const unordered_set<long long> &eventIds) const {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+	for (const long long eventId : eventIds) {
+		int count = 0;
+		try {
+			*session << "SELECT COUNT(*) FROM event WHERE id = :eventId", soci::use(eventId), soci::into(count);
+		} catch (const soci::soci_error &e) {
+			lWarning() << "Unable to check if event " << eventId << " is still stored: " << e.what();
+		}
+		const auto eventIt = storageIdToEvent.find(eventId);
+		if (eventIt != storageIdToEvent.end()) {
+			shared_ptr<EventLog> eventLog = eventIt->second.lock();
+			if (count == 0 && eventLog && eventLog->getPrivate()->dbKey.isValid())
+				const_cast<EventLogPrivate *>(eventLog->getPrivate())->resetStorageId();
+			storageIdToEvent.erase(eventIt);
+		}
+		const auto chatMessageIt = storageIdToChatMessage.find(eventId);
+		if (chatMessageIt != storageIdToChatMessage.end()) {
+			shared_ptr<ChatMessage> chatMessage = chatMessageIt->second.lock();
+			if (count == 0 && chatMessage && chatMessage->isValid()) chatMessage->getPrivate()->resetStorageId();
+			storageIdToChatMessage.erase(chatMessageIt);
+		}
+	}
+	unreadChatMessageCountCache.clear();
+	// Ids of rows created by the discarded writes may have been cached.
+	clearSipAddressCache();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Sqlite3 storage profile.
+// -----------------------------------------------------------------------------
+
+#ifdef HAVE_DB_STORAGE
+// Pragma values cannot be bound, so only accept the documented ones.
+static bool isValidSqliteSynchronousLevel(const string &level) {
+	static const vector<string> levels = {"off", "normal", "full", "extra", "0", "1", "2", "3"};
+	return find(levels.cbegin(), levels.cend(), level) != levels.cend();
+}
+
+static void applySqliteCachePragmas(soci::session *session, const LinphoneConfig *config) {
+	const int cacheSize = linphone_config_get_int(config, "storage", "sqlite3_cache_size", 0);
+	if (cacheSize != 0) *session << "PRAGMA cache_size = " + Utils::toString(cacheSize);
+
+	const int mmapSize = linphone_config_get_int(config, "storage", "sqlite3_mmap_size", -1);
+	if (mmapSize >= 0) *session << "PRAGMA mmap_size = " + Utils::toString(mmapSize);
+}
+#endif
+
+// Must be called outside of any transaction: the journal mode cannot be changed within one.
+void MainDbPrivate::configureSqliteStorage() {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	q->closeReadSession();
+	walEnabled = false;
+
+	const LinphoneConfig *config = linphone_core_get_config(q->getCore()->getCCore());
+	soci::session *session = dbSession.getBackendSession();
+
+	string journalMode;
+	*session << "PRAGMA journal_mode", soci::into(journalMode);
+	journalMode = Utils::stringToLower(journalMode);
+
+	const bool wantWal = !!linphone_config_get_bool(config, "storage", "sqlite3_wal_enabled", FALSE);
+	if (wantWal && journalMode != "wal") {
+		*session << "PRAGMA journal_mode = WAL", soci::into(journalMode);
+		journalMode = Utils::stringToLower(journalMode);
+		// SQLite silently keeps the previous mode if the VFS does not provide shared memory primitives, which is the
+		// case of the bctbx VFS: the core only opens the database with the native VFS if WAL is enabled at startup.
+		if (journalMode != "wal") lWarning() << "Unable to enable sqlite3 WAL journal mode, using: " << journalMode;
+	} else if (!wantWal && journalMode == "wal") {
+		*session << "PRAGMA journal_mode = DELETE", soci::into(journalMode);
+		journalMode = Utils::stringToLower(journalMode);
+	}
+	walEnabled = (journalMode == "wal");
+	lInfo() << "Sqlite3 journal mode: " << journalMode;
+
+	const string synchronous =
+	    Utils::stringToLower(linphone_config_get_string(config, "storage", "sqlite3_synchronous", ""));
+	if (!synchronous.empty()) {
+		if (isValidSqliteSynchronousLevel(synchronous)) *session << "PRAGMA synchronous = " + synchronous;
+		else lWarning() << "Ignoring invalid sqlite3 synchronous level: " << synchronous;
+	}
+
+	applySqliteCachePragmas(session, config);
+
+	walCheckpointInterval = linphone_config_get_int(config, "storage", "sqlite3_wal_checkpoint_interval", 60);
+	lastWalCheckpoint = std::time(nullptr);
+#endif
+}
+
+// Readers do not block the writer (and vice versa) only in WAL mode, otherwise the main connection is kept for reads.
+void MainDbPrivate::openSqliteReadSession() {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	if (!walEnabled) return;
+
+	const LinphoneConfig *config = linphone_core_get_config(q->getCore()->getCCore());
+	if (!linphone_config_get_bool(config, "storage", "sqlite3_read_connection_enabled", TRUE)) return;
+	if (!q->openReadSession()) return;
+
+	try {
+		soci::session *session = readDbSession.getBackendSession();
+		*session << "PRAGMA query_only = ON";
+		applySqliteCachePragmas(session, config);
+	} catch (const soci::soci_error &e) {
+		lWarning() << "Unable to configure sqlite3 read connection, closing it: " << e.what();
+		q->closeReadSession();
+	}
+#endif
+}
+
+void MainDbPrivate::checkpointWalIfNeeded() const {
+#ifdef HAVE_DB_STORAGE
+	if (!walEnabled || walCheckpointInterval <= 0) return;
+
+	const time_t now = std::time(nullptr);
+	if (now - lastWalCheckpoint < walCheckpointInterval) return;
+	lastWalCheckpoint = now;
+
+	// Passive: never waits for readers, the remaining frames are copied by a later checkpoint.
+	try {
+		int busy = 0, logFrames = 0, checkpointedFrames = 0;
+		*dbSession.getBackendSession() << "PRAGMA wal_checkpoint(PASSIVE)", soci::into(busy), soci::into(logFrames),
+		    soci::into(checkpointedFrames);
+		lDebug() << "Sqlite3 WAL checkpoint: " << checkpointedFrames << "/" << logFrames << " frames.";
+	} catch (const soci::soci_error &e) {
+		lWarning() << "Sqlite3 WAL checkpoint failed: " << e.what();
+	}
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Transactions.
+// -----------------------------------------------------------------------------
+
+string MainDbPrivate::beginTransaction() const {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+	if (!writeBehindBatchPending) {
+		session->begin();
+		transactionEventIds.emplace_back();
+		return string();
+	}
+
+	// Savepoint names are unique per depth: MySQL replaces a savepoint that has the same name.
+	const string savepoint = "write_behind_" + Utils::toString(++savepointDepth);
+	*session << "SAVEPOINT " + savepoint;
+	transactionEventIds.emplace_back();
+	return savepoint;
+#else
+	return string();
+#endif
+}
+
+void MainDbPrivate::commitTransaction(const string &savepoint) const {
+#ifdef HAVE_DB_STORAGE
+	unordered_set<long long> eventIds = popTransactionEventIds();
+
+	soci::session *session = dbSession.getBackendSession();
+	try {
+		if (!savepoint.empty()) {
+			*session << "RELEASE SAVEPOINT " + savepoint;
+			--savepointDepth;
+		} else if (!writeBehindEnabled && writeBatchDepth == 0) {
+			session->commit();
+		}
+	} catch (const std::exception &) {
+		rollbackSipAddressCache();
+		throw;
+	}
+	commitSipAddressCache();
+
+	if (!writeBehindEnabled && writeBatchDepth == 0) {
+		checkpointWalIfNeeded();
+		return;
+	}
+
+	// The events written by a released savepoint are still undone if the enclosing transaction is rolled back.
+	unordered_set<long long> &pendingEventIds =
+	    transactionEventIds.empty() ? writeBehindBatchEventIds : transactionEventIds.back();
+	pendingEventIds.insert(eventIds.begin(), eventIds.end());
+
+	// The transaction is kept opened and becomes the batch that the next transactions are appended to.
+	if (!writeBehindBatchPending) {
+		writeBehindBatchPending = true;
+		writeBehindBatchStartTime = bctbx_get_cur_time_ms();
+		writeBehindBatchSize = 0;
+	}
+	if (++writeBehindBatchSize >= writeBehindMaxTransactions && savepointDepth == 0) commitWriteBehindBatch();
+#endif
+}
+
+void MainDbPrivate::rollbackTransaction(const string &savepoint) const {
+#ifdef HAVE_DB_STORAGE
+	rollbackSipAddressCache();
+	const unordered_set<long long> eventIds = popTransactionEventIds();
+
+	soci::session *session = dbSession.getBackendSession();
+	if (savepoint.empty()) {
+		session->rollback();
+	} else {
+		// Only undo this transaction, the batch it belongs to stays pending.
+		--savepointDepth;
+		*session << "ROLLBACK TO SAVEPOINT " + savepoint;
+		*session << "RELEASE SAVEPOINT " + savepoint;
+	}
+
+	// Read-only transactions never record events, their rollback keeps the caches intact.
+	if (!eventIds.empty()) discardBatchEvents(eventIds);
+#endif
+}
+
+unordered_set<long long> MainDbPrivate::popTransactionEventIds() const {
+	unordered_set<long long> eventIds;
+	if (!transactionEventIds.empty()) {
+		eventIds = std::move(transactionEventIds.back());
+		transactionEventIds.pop_back();
+	}
+	return eventIds;
+}
+
+bool MainDbPrivate::commitWriteBehindBatch() const {
+#ifdef HAVE_DB_STORAGE
+	if (!writeBehindBatchPending) return true;
+
+	writeBehindBatchPending = false;
+	savepointDepth = 0;
+
+	soci::session *session = dbSession.getBackendSession();
+	try {
+		session->commit();
+	} catch (const soci::soci_error &e) {
+		lError() << "Unable to commit " << writeBehindBatchSize << " batched transactions: " << e.what();
+		try {
+			session->rollback();
+		} catch (const soci::soci_error &) {
+		}
+		discardBatchEvents(writeBehindBatchEventIds);
+		writeBehindBatchEventIds.clear();
+		return false;
+	}
+	writeBehindBatchEventIds.clear();
+
+	lDebug() << "Committed " << writeBehindBatchSize << " batched transactions after "
+	         << (bctbx_get_cur_time_ms() - writeBehindBatchStartTime) << "ms.";
+	checkpointWalIfNeeded();
+	return true;
+#else
+	return true;
+#endif
+}
+
+soci::session *MainDbPrivate::getReadSession() const {
+#ifdef HAVE_DB_STORAGE
+	return writeBehindBatchPending ? dbSession.getBackendSession() : AbstractDbPrivate::getReadSession();
+#else
+	return nullptr;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Chat message search.
+// -----------------------------------------------------------------------------
+
+// The index holds one row per chat message, its rowid being the event id and its body the concatenation of the
+// message's text/plain contents. It is maintained by insertContent()/deleteContents() and the event deletion paths.
+void MainDbPrivate::createChatMessageSearchIndex() {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	chatMessageSearchIndexEnabled = false;
+	if (q->getBackend() != MainDb::Backend::Sqlite3) return;
+
+	soci::session *session = dbSession.getBackendSession();
+	try {
+		// Event ids are 64-bit, so the backfill bound cannot be stored as a db_module_version version.
+		*session << "CREATE TABLE IF NOT EXISTS chat_message_fts_backfill ("
+		            "  id INTEGER PRIMARY KEY,"
+		            "  bound BIGINT NOT NULL"
+		            ")";
+		if (!dbSession.checkTableExists("chat_message_content_fts")) {
+			*session << "CREATE VIRTUAL TABLE chat_message_content_fts USING fts5("
+			            "body, tokenize = 'unicode61 remove_diacritics 2')";
+
+			// Messages stored before this point are indexed in background by backfillChatMessageSearchIndex().
+			long long backfillBound;
+			*session << "SELECT IFNULL(MAX(event_id), 0) + 1 FROM chat_message_content", soci::into(backfillBound);
+			setChatMessageSearchBackfillBound(backfillBound);
+		}
+		// Fails if the table exists but the fts5 module is not available.
+		*session << "SELECT rowid FROM chat_message_content_fts LIMIT 0";
+		chatMessageSearchIndexEnabled = true;
+	} catch (const soci::soci_error &e) {
+		lWarning() << "Chat message full-text search index is not available: " << e.what();
+	}
+#endif
+}
+
+void MainDbPrivate::indexChatMessageText(long long chatMessageId, const string &text) {
+#ifdef HAVE_DB_STORAGE
+	if (!chatMessageSearchIndexEnabled) return;
+
+	soci::session *session = dbSession.getBackendSession();
+	string indexedText;
+	*session << "SELECT body FROM chat_message_content_fts WHERE rowid = :chatMessageId", soci::into(indexedText),
+	    soci::use(chatMessageId);
+	if (session->got_data()) {
+		indexedText += "\n" + text;
+		*session << "UPDATE chat_message_content_fts SET body = :body WHERE rowid = :chatMessageId",
+		    soci::use(indexedText), soci::use(chatMessageId);
+	} else {
+		*session << "INSERT INTO chat_message_content_fts (rowid, body) VALUES (:chatMessageId, :body)",
+		    soci::use(chatMessageId), soci::use(text);
+	}
+#endif
+}
+
+// Removes the messages whose event ids are returned by `eventIdsQuery`, which takes `id` as only parameter.
+void MainDbPrivate::unindexChatMessages(const string &eventIdsQuery, long long id) {
+#ifdef HAVE_DB_STORAGE
+	if (!chatMessageSearchIndexEnabled) return;
+
+	*dbSession.getBackendSession() << "DELETE FROM chat_message_content_fts WHERE rowid IN (" + eventIdsQuery + ")",
+	    soci::use(id);
+#endif
+}
+
+// Messages with an event id lower than the bound have not been indexed yet. 0 means the backfill is done.
+long long MainDbPrivate::getChatMessageSearchBackfillBound() {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+
+	long long bound;
+	*session << "SELECT bound FROM chat_message_fts_backfill WHERE id = 1", soci::into(bound);
+	return session->got_data() ? bound : 0;
+#else
+	return 0;
+#endif
+}
+
+void MainDbPrivate::setChatMessageSearchBackfillBound(long long bound) {
+#ifdef HAVE_DB_STORAGE
+	*dbSession.getBackendSession() << "REPLACE INTO chat_message_fts_backfill (id, bound) VALUES (1, :bound)",
+	    soci::use(bound);
+#endif
+}
+
 // -----------------------------------------------------------------------------
 // Versions.
 // -----------------------------------------------------------------------------
@@ -2841,6 +3388,12 @@ void MainDbPrivate::updateSchema() {
 		lDebug() << "Caught exception " << e.what() << ": Column 'type' already exists in table 'friends_list'";
 	}
 
+	try {
+		*session << "ALTER TABLE friends_list ADD COLUMN sync_token VARCHAR(2047) DEFAULT ''";
+	} catch (const soci::soci_error &e) {
+		lDebug() << "Caught exception " << e.what() << ": Column 'sync_token' already exists in table 'friends_list'";
+	}
+
 	try {
 		*session << "ALTER TABLE conference_info_participant ADD COLUMN is_organizer BOOLEAN NOT NULL DEFAULT 0";
 		// We must recreate table conference_info_participant to change the UNIQUE constraint.
@@ -2903,6 +3456,30 @@ void MainDbPrivate::updateSchema() {
 		         << ": Column 'is_organizer' already exists in table 'conference_info_participant'";
 	}
 
+	try {
+		*session << "CREATE INDEX conference_event_chat_room_index ON conference_event (chat_room_id, event_id)";
+	} catch (const soci::soci_error &e) {
+		lDebug() << "Caught exception " << e.what()
+		         << ": Index 'conference_event_chat_room_index' already exists on table 'conference_event'";
+	}
+
+	// Call history lookups filter on the sip address ids of a call. MySQL already indexes foreign keys.
+	if (backend == MainDb::Backend::Sqlite3) {
+		try {
+			*session << "CREATE INDEX conference_call_from_sip_address_index ON conference_call (from_sip_address_id)";
+		} catch (const soci::soci_error &e) {
+			lDebug() << "Caught exception " << e.what()
+			         << ": Index 'conference_call_from_sip_address_index' already exists on table 'conference_call'";
+		}
+
+		try {
+			*session << "CREATE INDEX conference_call_to_sip_address_index ON conference_call (to_sip_address_id)";
+		} catch (const soci::soci_error &e) {
+			lDebug() << "Caught exception " << e.what()
+			         << ": Index 'conference_call_to_sip_address_index' already exists on table 'conference_call'";
+		}
+	}
+
 	// /!\ Warning : if varchar columns < 255 were to be indexed, their size must be set back to 191 = max indexable
 	// (KEY or UNIQUE) varchar size for mysql < 5.7 with charset utf8mb4 (both here and in column creation)
 	//
@@ -3303,10 +3880,37 @@ void MainDbPrivate::importLegacyCallLogs(DbSession &inDbSession) {
 MainDb::MainDb(const shared_ptr<Core> &core) : AbstractDb(*new MainDbPrivate), CoreAccessor(core) {
 }
 
+MainDb::~MainDb() {
+	flushPendingWrites();
+}
+
 void MainDb::init() {
 #ifdef HAVE_DB_STORAGE
 	L_D();
 
+	// The database may have been modified behind our back while disconnected.
+	d->clearSipAddressCache();
+	const int sipAddressCacheSize =
+	    linphone_config_get_int(linphone_core_get_config(getCore()->getCCore()), "storage", "sip_address_cache_size",
+	                            LruCache<string, MainDbPrivate::SipAddressCacheEntry>::DefaultCapacity);
+	d->sipAddressToIdCache.setCapacity(sipAddressCacheSize);
+	d->idToSipAddressCache.setCapacity(sipAddressCacheSize);
+
+	const LinphoneConfig *config = linphone_core_get_config(getCore()->getCCore());
+	d->writeBehindEnabled = !!linphone_config_get_bool(config, "storage", "write_behind_enabled", FALSE);
+	d->writeBehindMaxDelay = linphone_config_get_int(config, "storage", "write_behind_max_delay_ms", 0);
+	d->writeBehindMaxTransactions = linphone_config_get_int(config, "storage", "write_behind_max_transactions", 500);
+	// A batch still pending here was started on a previous connection.
+	d->writeBehindBatchPending = false;
+	d->savepointDepth = 0;
+	d->writeBehindBatchEventIds.clear();
+	d->transactionEventIds.clear();
+
+	d->historyContentsPrefetchEnabled =
+	    !!linphone_config_get_bool(config, "storage", "history_contents_prefetch_enabled", TRUE);
+	d->lazyChatRoomLoadingEnabled =
+	    !!linphone_config_get_bool(config, "storage", "lazy_chat_room_loading_enabled", FALSE);
+
 	Backend backend = getBackend();
 	const string charset = backend == Mysql ? "DEFAULT CHARSET=utf8mb4" : "";
 	soci::session *session = d->dbSession.getBackendSession();
@@ -3317,6 +3921,8 @@ void MainDb::init() {
 	auto timestampType = bind(&DbSession::timestampType, &d->dbSession);
 	auto varcharPrimaryKeyStr = bind(&DbSession::varcharPrimaryKeyStr, &d->dbSession, _1);
 
+	if (backend == Sqlite3) d->configureSqliteStorage();
+
 	initCleanup();
 
 	session->begin();
@@ -4068,6 +4674,7 @@ void MainDb::init() {
 		                charset;
 
 		d->updateSchema();
+		d->createChatMessageSearchIndex();
 
 		d->updateModuleVersion("events", ModuleVersionEvents);
 		d->updateModuleVersion("friends", ModuleVersionFriends);
@@ -4081,6 +4688,10 @@ void MainDb::init() {
 	session->commit();
 
 	initCleanup();
+
+	if (backend == Sqlite3) d->openSqliteReadSession();
+	if (d->chatMessageSearchIndexEnabled && d->getChatMessageSearchBackfillBound() > 0)
+		scheduleChatMessageSearchBackfill();
 #endif
 }
 
@@ -4188,6 +4799,7 @@ bool MainDb::addEvent(const shared_ptr<EventLog> &eventLog) {
 		}
 
 		if (eventId >= 0) {
+			d->recordBatchEvent(eventId);
 			tr.commit();
 			d->cache(eventLog, eventId);
 
@@ -4278,6 +4890,7 @@ bool MainDb::deleteEvent(const shared_ptr<const EventLog> &eventLog) {
 		MainDbPrivate *const d = mainDb.getPrivate();
 		soci::session *session = d->dbSession.getBackendSession();
 		*session << "DELETE FROM event WHERE id = :id", soci::use(dEventKey->storageId);
+		d->unindexChatMessages("SELECT :id", dEventKey->storageId);
 
 		if (eventLog->getType() == EventLog::Type::ConferenceChatMessage) {
 			shared_ptr<ChatMessage> chatMessage(
@@ -4350,17 +4963,7 @@ shared_ptr<EventLog> MainDb::getEvent(const unique_ptr<MainDb> &mainDb, const lo
 	if (event) return event;
 
 	return L_DB_TRANSACTION_C(mainDb.get()) {
-		// TODO: Improve. Deal with all events in the future.
-		soci::row row;
-		*d->dbSession.getBackendSession() << Statements::get(Statements::SelectConferenceEvent), soci::into(row),
-		    soci::use(storageId);
-
-		ConferenceId conferenceId(Address::create(row.get<string>(16))->getSharedFromThis(),
-		                          Address::create(row.get<string>(17)));
-		shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
-		if (!chatRoom) return shared_ptr<EventLog>();
-
-		return d->selectGenericConferenceEvent(chatRoom, row);
+		return d->selectConferenceEventFromStorageId(storageId);
 	};
 #else
 	return nullptr;
@@ -5100,6 +5703,197 @@ list<shared_ptr<ChatMessage>> MainDb::findChatMessagesToBeNotifiedAsDelivered()
 #endif
 }
 
+#ifdef HAVE_DB_STORAGE
+// Quotes each word of the user text so that FTS5 operators are matched literally. The last word is a prefix unless
+// the text ends with a space, so that results can be refreshed while typing.
+static string buildChatMessageSearchMatchExpression(const string &text) {
+	string expression;
+	istringstream stream(text);
+	string word;
+	while (stream >> word) {
+		if (!expression.empty()) expression += " ";
+		expression += "\"";
+		for (const char c : word) {
+			if (c == '"') expression += '"';
+			expression += c;
+		}
+		expression += "\"";
+	}
+	if (!expression.empty() && !isspace(static_cast<unsigned char>(text.back()))) expression += "*";
+	return expression;
+}
+
+static string buildChatMessageSearchLikePattern(const string &text) {
+	string pattern = "%";
+	for (const char c : text) {
+		if (c == '%' || c == '_' || c == '!') pattern += '!';
+		pattern += c;
+	}
+	return pattern + "%";
+}
+#endif
+
+list<shared_ptr<ChatMessage>> MainDb::searchChatMessages(const string &text,
+                                                         const ConferenceId &conferenceId,
+                                                         unsigned int limit,
+                                                         unsigned int cursor) const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	const string trimmedText = Utils::trim(text);
+	if (trimmedText.empty() || limit == 0) return list<shared_ptr<ChatMessage>>();
+
+	const bool filterChatRoom = conferenceId.isValid();
+	string pattern;
+	string query;
+	if (d->chatMessageSearchIndexEnabled) {
+		pattern = buildChatMessageSearchMatchExpression(text);
+		query = "SELECT chat_message_content_fts.rowid FROM chat_message_content_fts";
+		if (filterChatRoom)
+			query += " JOIN conference_event ON conference_event.event_id = chat_message_content_fts.rowid";
+		query += " WHERE chat_message_content_fts MATCH :pattern";
+		if (filterChatRoom) query += " AND conference_event.chat_room_id = :chatRoomId";
+		query += " ORDER BY chat_message_content_fts.rank";
+	} else {
+		// No index (MySQL or Sqlite3 without FTS5): substring match on the text contents, most recent first.
+		pattern = buildChatMessageSearchLikePattern(trimmedText);
+		query = "SELECT DISTINCT chat_message_content.event_id FROM chat_message_content"
+		        " JOIN content_type ON content_type.id = chat_message_content.content_type_id";
+		if (filterChatRoom)
+			query += " JOIN conference_event ON conference_event.event_id = chat_message_content.event_id";
+		query += " WHERE content_type.value = 'text/plain' AND chat_message_content.body LIKE :pattern ESCAPE '!'";
+		if (filterChatRoom) query += " AND conference_event.chat_room_id = :chatRoomId";
+		query += " ORDER BY chat_message_content.event_id DESC";
+	}
+	query += " LIMIT " + Utils::toString(limit) + " OFFSET " + Utils::toString(cursor);
+
+	return L_DB_TRANSACTION {
+		L_D();
+
+		list<shared_ptr<ChatMessage>> chatMessages;
+		long long dbChatRoomId = -1;
+		if (filterChatRoom) {
+			dbChatRoomId = d->selectChatRoomId(conferenceId);
+			if (dbChatRoomId < 0) return chatMessages;
+		}
+
+		vector<long long> eventIds;
+		soci::session *session = d->getReadSession();
+		if (filterChatRoom) {
+			soci::rowset<soci::row> rows = (session->prepare << query, soci::use(pattern), soci::use(dbChatRoomId));
+			for (const auto &row : rows)
+				eventIds.push_back(d->dbSession.resolveId(row, 0));
+		} else {
+			soci::rowset<soci::row> rows = (session->prepare << query, soci::use(pattern));
+			for (const auto &row : rows)
+				eventIds.push_back(d->dbSession.resolveId(row, 0));
+		}
+
+		for (const long long &eventId : eventIds) {
+			shared_ptr<EventLog> event = d->getEventFromCache(eventId);
+			if (!event) event = d->selectConferenceEventFromStorageId(eventId);
+			if (event && event->getType() == EventLog::Type::ConferenceChatMessage)
+				chatMessages.push_back(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
+		}
+
+		return chatMessages;
+	};
+#else
+	return list<shared_ptr<ChatMessage>>();
+#endif
+}
+
+bool MainDb::backfillChatMessageSearchIndex(unsigned int count) {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!d->chatMessageSearchIndexEnabled || count == 0) return false;
+
+	static const string eventIdsQuery =
+	    "SELECT DISTINCT chat_message_content.event_id FROM chat_message_content"
+	    " JOIN content_type ON content_type.id = chat_message_content.content_type_id"
+	    " WHERE content_type.value = 'text/plain' AND chat_message_content.event_id < :bound"
+	    " ORDER BY chat_message_content.event_id DESC";
+
+	static const string contentsQuery =
+	    "SELECT chat_message_content.event_id, chat_message_content.body FROM chat_message_content"
+	    " JOIN content_type ON content_type.id = chat_message_content.content_type_id"
+	    " WHERE content_type.value = 'text/plain'"
+	    " AND chat_message_content.event_id BETWEEN :lowestEventId AND :highestEventId"
+	    " ORDER BY chat_message_content.id";
+
+	return L_DB_TRANSACTION {
+		L_D();
+
+		soci::session *session = d->dbSession.getBackendSession();
+		const long long bound = d->getChatMessageSearchBackfillBound();
+		if (bound <= 0) return false;
+
+		// Whole messages are indexed at once, so select the chunk boundaries before the contents.
+		long long lowestEventId = -1;
+		long long highestEventId = -1;
+		unsigned int eventCount = 0;
+		soci::rowset<soci::row> eventRows =
+		    (session->prepare << eventIdsQuery + " LIMIT " + Utils::toString(count), soci::use(bound));
+		for (const auto &row : eventRows) {
+			lowestEventId = d->dbSession.resolveId(row, 0);
+			if (highestEventId < 0) highestEventId = lowestEventId;
+			++eventCount;
+		}
+
+		if (eventCount > 0) {
+			map<long long, string> texts;
+			soci::rowset<soci::row> contentRows =
+			    (session->prepare << contentsQuery, soci::use(lowestEventId), soci::use(highestEventId));
+			for (const auto &row : contentRows) {
+				string &text = texts[d->dbSession.resolveId(row, 0)];
+				if (!text.empty()) text += "\n";
+				text += row.get<string>(1);
+			}
+
+			// A message may already have been indexed if its contents were updated since the index creation.
+			for (const auto &text : texts) {
+				*session << "DELETE FROM chat_message_content_fts WHERE rowid = :eventId", soci::use(text.first);
+				*session << "INSERT INTO chat_message_content_fts (rowid, body) VALUES (:eventId, :body)",
+				    soci::use(text.first), soci::use(text.second);
+			}
+		}
+
+		const long long newBound = eventCount < count ? 0 : lowestEventId;
+		d->setChatMessageSearchBackfillBound(newBound);
+		tr.commit();
+
+		if (newBound == 0) lInfo() << "Chat message search index backfill done.";
+		return newBound != 0;
+	};
+#else
+	return false;
+#endif
+}
+
+void MainDb::scheduleChatMessageSearchBackfill() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (d->chatMessageSearchBackfillScheduled) return;
+	d->chatMessageSearchBackfillScheduled = true;
+
+	// Index one chunk per core iteration so that a large history does not block the startup.
+	weak_ptr<Core> weakCore = getCore();
+	getCore()->doLater([weakCore]() {
+		shared_ptr<Core> core = weakCore.lock();
+		if (!core) return;
+
+		const unique_ptr<MainDb> &mainDb = core->getPrivate()->mainDb;
+		if (!mainDb || !mainDb->isInitialized()) return;
+
+		mainDb->getPrivate()->chatMessageSearchBackfillScheduled = false;
+		if (mainDb->backfillChatMessageSearchIndex(ChatMessageSearchBackfillChunkSize))
+			mainDb->scheduleChatMessageSearchBackfill();
+	});
+#endif
+}
+
 list<shared_ptr<EventLog>> MainDb::getHistory(const ConferenceId &conferenceId, int nLast, FilterMask mask) const {
 #ifdef HAVE_DB_STORAGE
 	return getHistoryRange(conferenceId, 0, nLast, mask);
@@ -5140,14 +5934,14 @@ MainDb::getHistoryRange(const ConferenceId &conferenceId, int begin, int end, Fi
 	);
 	*/
 
-	return L_DB_TRANSACTION {
+	events = L_DB_TRANSACTION {
 		L_D();
 
 		shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
 		if (!chatRoom) return events;
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-		soci::rowset<soci::row> rows = (d->dbSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId));
+		soci::rowset<soci::row> rows = (d->getReadSession()->prepare << query, soci::use(dbChatRoomId));
 		for (const auto &row : rows) {
 			shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
 			if (event) events.push_front(event);
@@ -5155,6 +5949,87 @@ MainDb::getHistoryRange(const ConferenceId &conferenceId, int begin, int end, Fi
 
 		return events;
 	};
+
+	if (d->historyContentsPrefetchEnabled) prefetchChatMessageContents(events);
+	return events;
+#else
+	return list<shared_ptr<EventLog>>();
+#endif
+}
+
+list<shared_ptr<EventLog>> MainDb::getHistoryRangeNear(const ConferenceId &conferenceId,
+                                                      unsigned int before,
+                                                      unsigned int after,
+                                                      const shared_ptr<const EventLog> &event,
+                                                      FilterMask mask) const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	list<shared_ptr<EventLog>> events;
+	if (!event) {
+		// getHistory() returns the whole history when asked for 0 events.
+		if (before == 0) return events;
+		return getHistory(conferenceId, int(before), mask);
+	}
+
+	const EventLogPrivate *dEventLog = event->getPrivate();
+	if (!dEventLog->dbKey.isValid()) {
+		lWarning() << "Unable to get history near an event that is not stored in database.";
+		return events;
+	}
+	const long long eventId = static_cast<MainDbKey &>(dEventLog->dbKey).getPrivate()->storageId;
+
+	// Seek from the anchor event instead of using an OFFSET, so that the cost of a page does not depend on how deep
+	// it is in the history.
+	const string query = Statements::get(Statements::SelectConferenceEvents) +
+	                     buildSqlEventFilter({ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter,
+	                                          ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter},
+	                                         mask, "AND");
+	const string beforeQuery =
+	    query + " AND conference_event_view.id < :2 ORDER BY event_id DESC LIMIT " + Utils::toString(before);
+	const string afterQuery =
+	    query + " AND conference_event_view.id > :2 ORDER BY event_id ASC LIMIT " + Utils::toString(after);
+
+	events = L_DB_TRANSACTION {
+		L_D();
+
+		shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
+		if (!chatRoom) return events;
+
+		soci::session *session = d->getReadSession();
+		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
+
+		long long anchorChatRoomId = -1;
+		*session << "SELECT chat_room_id FROM conference_event WHERE event_id = :eventId", soci::use(eventId),
+		    soci::into(anchorChatRoomId);
+		if (!session->got_data() || anchorChatRoomId != dbChatRoomId) {
+			lWarning() << "Unable to get history near an event that does not belong to: " << conferenceId << ".";
+			return events;
+		}
+
+		if (before > 0) {
+			soci::rowset<soci::row> rows =
+			    (session->prepare << beforeQuery, soci::use(dbChatRoomId), soci::use(eventId));
+			for (const auto &row : rows) {
+				shared_ptr<EventLog> rowEvent = d->selectGenericConferenceEvent(chatRoom, row);
+				if (rowEvent) events.push_front(rowEvent);
+			}
+		}
+
+		if (after > 0) {
+			soci::rowset<soci::row> rows =
+			    (session->prepare << afterQuery, soci::use(dbChatRoomId), soci::use(eventId));
+			for (const auto &row : rows) {
+				shared_ptr<EventLog> rowEvent = d->selectGenericConferenceEvent(chatRoom, row);
+				if (rowEvent) events.push_back(rowEvent);
+			}
+		}
+
+		return events;
+	};
+
+	if (d->historyContentsPrefetchEnabled) prefetchChatMessageContents(events);
+	return events;
 #else
 	return list<shared_ptr<EventLog>>();
 #endif
@@ -5206,6 +6081,7 @@ void MainDb::cleanHistory(const ConferenceId &conferenceId, FilterMask mask) {
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
 
 		d->invalidConferenceEventsFromQuery(query, dbChatRoomId);
+		d->unindexChatMessages(query, dbChatRoomId);
 		*d->dbSession.getBackendSession() << "DELETE FROM event WHERE id IN (" + query + ")", soci::use(dbChatRoomId);
 		*d->dbSession.getBackendSession() << query2, soci::use(dbChatRoomId);
 		tr.commit();
@@ -5219,89 +6095,126 @@ void MainDb::cleanHistory(const ConferenceId &conferenceId, FilterMask mask) {
 
 #ifdef HAVE_DB_STORAGE
 template <typename T>
-static void fetchContentAppData(soci::session *session, Content &content, long long contentId, T &data) {
-	static const string query = "SELECT name, data FROM chat_message_content_app_data"
-	                            " WHERE chat_message_content_id = :contentId";
-
+static void fetchContentsAppData(soci::session *session,
+                                 const string &eventIdList,
+                                 const unordered_map<long long, shared_ptr<Content>> &contentsById,
+                                 T &data) {
+	const string query = "SELECT chat_message_content_app_data.chat_message_content_id,"
+	                     " chat_message_content_app_data.name, chat_message_content_app_data.data"
+	                     " FROM chat_message_content_app_data, chat_message_content"
+	                     " WHERE chat_message_content.id = chat_message_content_app_data.chat_message_content_id"
+	                     " AND chat_message_content.event_id IN (" +
+	                     eventIdList + ")";
+
+	long long contentId;
 	string name;
-	soci::statement statement = (session->prepare << query, soci::use(contentId), soci::into(name), soci::into(data));
+	soci::statement statement =
+	    (session->prepare << query, soci::into(contentId), soci::into(name), soci::into(data));
 	statement.execute();
-	while (statement.fetch())
-		content.setProperty(name, Variant{blobToString(data)});
+	while (statement.fetch()) {
+		auto it = contentsById.find(contentId);
+		if (it != contentsById.cend()) it->second->setProperty(name, Variant{blobToString(data)});
+	}
 }
 #endif
 
-void MainDb::loadChatMessageContents(const shared_ptr<ChatMessage> &chatMessage) {
+unordered_map<long long, list<shared_ptr<Content>>>
+MainDbPrivate::selectChatMessagesContents(const string &eventIdList) const {
+	unordered_map<long long, list<shared_ptr<Content>>> contentsByEventId;
 #ifdef HAVE_DB_STORAGE
-	L_DB_TRANSACTION {
-		L_D();
+	L_Q();
 
-		soci::session *session = d->dbSession.getBackendSession();
+	soci::session *session = dbSession.getBackendSession();
 
-		bool hasFileTransferContent = false;
+	// 1 - Fetch contents with their file information if they exist.
+	const string query =
+	    "SELECT chat_message_content.id, chat_message_content.event_id, content_type.value, body, body_encoding_type,"
+	    " chat_message_file_content.name, chat_message_file_content.size, chat_message_file_content.path,"
+	    " chat_message_file_content.duration"
+	    " FROM chat_message_content"
+	    " JOIN content_type ON content_type.id = chat_message_content.content_type_id"
+	    " LEFT JOIN chat_message_file_content"
+	    " ON chat_message_file_content.chat_message_content_id = chat_message_content.id"
+	    " WHERE chat_message_content.event_id IN (" +
+	    eventIdList + ") ORDER BY chat_message_content.id";
+
+	unordered_map<long long, shared_ptr<Content>> contentsById;
+	soci::rowset<soci::row> rows = (session->prepare << query);
+	for (const auto &row : rows) {
+		ContentType contentType(row.get<string>(2));
+		shared_ptr<Content> content;
 
-		ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
-		const long long &eventId = chatMessage->getStorageId();
+		if (contentType == ContentType::FileTransfer) {
+			content = FileTransferContent::create<FileTransferContent>();
+		} else if (row.get_indicator(5) != soci::i_null) {
+			auto fileContent = FileContent::create<FileContent>();
+			fileContent->setFileName(row.get<string>(5));
+			fileContent->setFileSize(size_t(dbSession.getUnsignedInt(row, 6, 0)));
+			fileContent->setFilePath(row.get<string>(7));
+			fileContent->setFileDuration(row.get<int>(8));
+			content = fileContent;
+		} else {
+			content = Content::create();
+		}
 
-		static const string query =
-		    "SELECT chat_message_content.id, content_type.id, content_type.value, body, body_encoding_type"
-		    " FROM chat_message_content, content_type"
-		    " WHERE event_id = :eventId AND content_type_id = content_type.id";
-		soci::rowset<soci::row> rows = (session->prepare << query, soci::use(eventId));
-		for (const auto &row : rows) {
-			ContentType contentType(row.get<string>(2));
-			const long long &contentId = d->dbSession.resolveId(row, 0);
-			shared_ptr<Content> content;
-			int bodyEncodingType = row.get<int>(4);
+		content->setContentType(contentType);
+		if (row.get<int>(4) == 1) content->setBodyFromUtf8(row.get<string>(3));
+		else content->setBodyFromLocale(row.get<string>(3));
 
-			if (contentType == ContentType::FileTransfer) {
-				hasFileTransferContent = true;
-				content = FileTransferContent::create<FileTransferContent>();
-			} else {
-				// 1.1 - Fetch contents' file information if they exist
-				string name;
-				int size;
-				string path;
-				int duration;
-
-				*session << "SELECT name, size, path, duration FROM chat_message_file_content"
-				            " WHERE chat_message_content_id = :contentId",
-				    soci::into(name), soci::into(size), soci::into(path), soci::into(duration), soci::use(contentId);
-				if (session->got_data()) {
-					auto fileContent = FileContent::create<FileContent>();
-					fileContent->setFileName(name);
-					fileContent->setFileSize(size_t(size));
-					fileContent->setFilePath(path);
-					fileContent->setFileDuration(duration);
-					fileContent->setCreationTimestamp(chatMessage->getTime());
-					content = fileContent;
-				} else {
-					content = Content::create();
-				}
-			}
+		contentsById[dbSession.resolveId(row, 0)] = content;
+		contentsByEventId[dbSession.resolveId(row, 1)].push_back(content);
+	}
 
-			content->setContentType(contentType);
-			if (bodyEncodingType == 1) content->setBodyFromUtf8(row.get<string>(3));
-			else content->setBodyFromLocale(row.get<string>(3));
+	if (contentsById.empty()) return contentsByEventId;
 
-			// 1.2 - Fetch contents' app data.
-			// TODO: Do not test backend, encapsulate!!!
-			if (getBackend() == MainDb::Backend::Sqlite3) {
-				soci::blob data(*session);
-				fetchContentAppData(session, *content, contentId, data);
-			} else {
-				string data;
-				fetchContentAppData(session, *content, contentId, data);
-			}
-			chatMessage->addContent(content);
-		}
+	// 2 - Fetch contents' app data.
+	// TODO: Do not test backend, encapsulate!!!
+	if (q->getBackend() == MainDb::Backend::Sqlite3) {
+		soci::blob data(*session);
+		fetchContentsAppData(session, eventIdList, contentsById, data);
+	} else {
+		string data;
+		fetchContentsAppData(session, eventIdList, contentsById, data);
+	}
+#endif
+	return contentsByEventId;
+}
+
+void MainDb::loadChatMessageContents(const shared_ptr<ChatMessage> &chatMessage) {
+	loadChatMessagesContents(list<shared_ptr<ChatMessage>>{chatMessage});
+}
+
+void MainDb::loadChatMessagesContents(const list<shared_ptr<ChatMessage>> &chatMessages) const {
+#ifdef HAVE_DB_STORAGE
+	string eventIdList;
+	list<shared_ptr<ChatMessage>> messagesToLoad;
+	for (const auto &chatMessage : chatMessages) {
+		if (!chatMessage->getPrivate()->hasContentsNotLoadedFromDatabase()) continue;
+		if (!eventIdList.empty()) eventIdList += ",";
+		eventIdList += Utils::toString(chatMessage->getStorageId());
+		messagesToLoad.push_back(chatMessage);
+	}
+	if (messagesToLoad.empty()) return;
 
-		// 2 - Load external body url from body into FileTransferContent if needed.
-		if (hasFileTransferContent) dChatMessage->loadFileTransferUrlFromBodyToContent();
+	unordered_map<long long, list<shared_ptr<Content>>> contentsByEventId = L_DB_TRANSACTION {
+		L_D();
+		return d->selectChatMessagesContents(eventIdList);
 	};
+
+	for (const auto &chatMessage : messagesToLoad)
+		chatMessage->getPrivate()->setContentsFromDatabase(contentsByEventId[chatMessage->getStorageId()]);
 #endif
 }
 
+void MainDb::prefetchChatMessageContents(const list<shared_ptr<EventLog>> &events) const {
+	list<shared_ptr<ChatMessage>> chatMessages;
+	for (const auto &event : events) {
+		if (event->getType() == EventLog::Type::ConferenceChatMessage)
+			chatMessages.push_back(static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage());
+	}
+	loadChatMessagesContents(chatMessages);
+}
+
 list<shared_ptr<ChatMessageReaction>> MainDb::getChatMessageReactions(const shared_ptr<ChatMessage> &chatMessage) {
 	list<shared_ptr<ChatMessageReaction>> reactions;
 #ifdef HAVE_DB_STORAGE
@@ -5486,6 +6399,8 @@ shared_ptr<AbstractChatRoom> MainDb::mergeChatRooms(const shared_ptr<AbstractCha
 	if (dbChatRoomToRemoveId != -1) {
 		lInfo() << "Deleting chatroom with ID " << dbChatRoomToRemoveId << " (conference id: " << conferenceIdToRemove
 		        << ")";
+		d->unindexChatMessages("SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId",
+		                       dbChatRoomToRemoveId);
 		*session << "DELETE FROM chat_room WHERE id = :chatRoomId", soci::use(dbChatRoomToRemoveId);
 	}
 	return chatRoomToAdd;
@@ -5524,7 +6439,7 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 
 		soci::session *session = d->dbSession.getBackendSession();
 
-		soci::rowset<soci::row> rows = (session->prepare << query);
+		soci::rowset<soci::row> rows = (d->getReadSession()->prepare << query);
 		// SOCI uses a hack for sqlite3:
 		// "sqlite3 type system does not have a date or time field.  Also it does not reliably id other data types.
 		// It has a tendency to see everything as text.
@@ -5575,16 +6490,17 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 			} else if (backend == ChatParams::Backend::FlexisipChat) {
 #ifdef HAVE_ADVANCED_IM
 				unsigned int lastNotifyId = d->dbSession.getUnsignedInt(row, 7, 0);
-				list<shared_ptr<Participant>> participants = selectChatRoomParticipants(dbChatRoomId);
-				const auto meIt =
-				    std::find_if(participants.begin(), participants.end(),
-				                 [&localAddress = conferenceId.getLocalAddress()](const auto &participant) {
-					                 return (participant->getAddress()->weakEqual(*localAddress));
-				                 });
+				bool serverMode = linphone_core_conference_server_enabled(core->getCCore());
+				bool hasBeenLeft = !!row.get<int>(8, 0);
+				// One-to-one chat rooms are indexed by their participant so they are always loaded.
+				const bool lazy = d->lazyChatRoomLoadingEnabled && !serverMode && !hasBeenLeft && params->isGroup();
+				list<shared_ptr<Participant>> participants;
 				shared_ptr<Participant> me;
-				if (meIt != participants.end()) {
-					me = *meIt;
-					participants.erase(meIt);
+				if (lazy) {
+					me = Participant::create(Address::create(conferenceId.getLocalAddress()->getUriWithoutGruu()));
+				} else {
+					participants = selectChatRoomParticipants(dbChatRoomId);
+					me = d->extractMe(participants, conferenceId);
 				}
 
 				params->setUtf8Subject(subject);
@@ -5592,21 +6508,24 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 				params->getChatParams()->enableEphemeral(!!row.get<int>(10, 0));
 				params->setConferenceAddress(conferenceId.getPeerAddress());
 
-				bool serverMode = linphone_core_conference_server_enabled(core->getCCore());
 				std::shared_ptr<Conference> conference = nullptr;
 				if (!serverMode) {
 					if (!me) {
 						lError() << "Unable to find me in: " << conferenceId;
 						continue;
 					}
-					bool hasBeenLeft = !!row.get<int>(8, 0);
 					conference = (new ClientConference(core, me->getAddress(), nullptr, params))->toSharedPtr();
 					conference->initFromDb(me, conferenceId, lastNotifyId, hasBeenLeft);
 					chatRoom = conference->getChatRoom();
 					if (hasBeenLeft) {
 						conference->setState(ConferenceInterface::State::Terminated);
 					} else {
-						conference->setParticipants(std::move(participants));
+						if (lazy) {
+							conference->setParticipantsLoader(
+							    d->createParticipantsLoader(conference, conferenceId, dbChatRoomId));
+						} else {
+							conference->setParticipants(std::move(participants));
+						}
 						conference->setState(ConferenceInterface::State::Created);
 					}
 					if (!params->isGroup()) {
@@ -5641,8 +6560,10 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms() const {
 					conference->setState(ConferenceInterface::State::Instantiated);
 					conference->setState(ConferenceInterface::State::Created);
 				}
-				for (auto participant : conference->getParticipants()) {
-					participant->setConference(conference);
+				if (conference->participantsLoaded()) {
+					for (auto participant : conference->getParticipants()) {
+						participant->setConference(conference);
+					}
 				}
 #else
 				lWarning() << "Advanced IM such as group chat is disabled!";
@@ -5747,8 +6668,9 @@ void MainDb::deleteChatRoom(const ConferenceId &conferenceId) {
 
 		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
 
-		d->invalidConferenceEventsFromQuery("SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId",
-		                                    dbChatRoomId);
+		const string query = "SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId";
+		d->invalidConferenceEventsFromQuery(query, dbChatRoomId);
+		d->unindexChatMessages(query, dbChatRoomId);
 
 		*d->dbSession.getBackendSession() << "DELETE FROM chat_room WHERE id = :chatRoomId", soci::use(dbChatRoomId);
 
@@ -5920,8 +6842,18 @@ void MainDb::insertOneToOneConferenceChatRoom(const shared_ptr<AbstractChatRoom>
 		    d->selectOneToOneChatRoomId(participantASipAddressId, participantBSipAddressId, encrypted);
 		if (chatRoomId == -1) {
 			chatRoomId = d->selectChatRoomId(chatRoom->getConferenceId());
-			*d->dbSession.getBackendSession() << Statements::get(Statements::InsertOneToOneChatRoom, getBackend()),
-			    soci::use(chatRoomId), soci::use(participantASipAddressId), soci::use(participantBSipAddressId);
+			const Backend backend = getBackend();
+			DbSession::PreparedStatement &statement = d->dbSession.getPreparedStatement(
+			    Statements::getKey(Statements::InsertOneToOneChatRoom),
+			    [backend](soci::session *session, DbSession::PreparedStatement &stmt) {
+				    return new soci::statement(
+				        (session->prepare << Statements::get(Statements::InsertOneToOneChatRoom, backend),
+				         soci::use(stmt.ids[0]), soci::use(stmt.ids[1]), soci::use(stmt.ids[2])));
+			    });
+			statement.ids[0] = chatRoomId;
+			statement.ids[1] = participantASipAddressId;
+			statement.ids[2] = participantBSipAddressId;
+			statement.execute();
 		}
 
 		tr.commit();
@@ -6059,7 +6991,7 @@ std::list<std::shared_ptr<ConferenceInfo>> MainDb::getConferenceInfos(time_t aft
 
 		list<shared_ptr<ConferenceInfo>> conferenceInfos;
 
-		soci::session *session = d->dbSession.getBackendSession();
+		soci::session *session = d->getReadSession();
 
 		// We cannot create an empty rowset so each "if" will make one
 		if (afterThisTime > -1) {
@@ -6322,7 +7254,7 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
 
 		list<shared_ptr<CallLog>> clList;
 
-		soci::session *session = d->dbSession.getBackendSession();
+		soci::session *session = d->getReadSession();
 
 		soci::rowset<soci::row> rows = (session->prepare << query);
 		for (const auto &row : rows) {
@@ -6342,22 +7274,7 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(int limit) {
 std::list<std::shared_ptr<CallLog>> MainDb::getCallHistoryForLocalAddress(const std::shared_ptr<Address> &localAddress,
                                                                           int limit) {
 #ifdef HAVE_DB_STORAGE
-	string query = "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
-	               "to_sip_address.value, to_sip_address.display_name,"
-	               "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
-	               "refkey, conference_info_id"
-	               " FROM conference_call, sip_address AS from_sip_address, sip_address AS to_sip_address"
-	               " WHERE conference_call.from_sip_address_id = from_sip_address.id AND "
-	               "conference_call.to_sip_address_id = to_sip_address.id"
-	               "  AND ((from_sip_address.value LIKE '%%" +
-	               localAddress->toStringUriOnlyOrdered() +
-	               "%%' AND direction = 0) OR" // 0 == outgoing
-	               "  (to_sip_address.value LIKE '%%" +
-	               localAddress->toStringUriOnlyOrdered() +
-	               "%%' AND direction = 1))" // 1 == incoming
-	               " ORDER BY conference_call.id DESC";
-
-	if (limit > 0) query += " LIMIT " + to_string(limit);
+	const string localUri = localAddress->toStringUriOnlyOrdered();
 
 	DurationLogger durationLogger("Get call history.");
 
@@ -6366,7 +7283,27 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistoryForLocalAddress(const
 
 		list<shared_ptr<CallLog>> clList;
 
-		soci::session *session = d->dbSession.getBackendSession();
+		const string localIds = d->selectSipAddressIdList(localUri);
+		if (localIds.empty()) return clList;
+
+		string query = "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
+		               "to_sip_address.value, to_sip_address.display_name,"
+		               "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
+		               "refkey, conference_info_id"
+		               " FROM conference_call, sip_address AS from_sip_address, sip_address AS to_sip_address"
+		               " WHERE conference_call.from_sip_address_id = from_sip_address.id AND "
+		               "conference_call.to_sip_address_id = to_sip_address.id"
+		               "  AND ((from_sip_address_id IN (" +
+		               localIds +
+		               ") AND direction = 0) OR" // 0 == outgoing
+		               "  (to_sip_address_id IN (" +
+		               localIds +
+		               ") AND direction = 1))" // 1 == incoming
+		               " ORDER BY conference_call.id DESC";
+
+		if (limit > 0) query += " LIMIT " + to_string(limit);
+
+		soci::session *session = d->getReadSession();
 
 		soci::rowset<soci::row> rows = (session->prepare << query);
 		for (const auto &row : rows) {
@@ -6387,23 +7324,8 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(const std::shared_ptr
                                                            const std::shared_ptr<const Address> &local,
                                                            int limit) {
 #ifdef HAVE_DB_STORAGE
-	string query =
-	    "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
-	    "to_sip_address.value, to_sip_address.display_name,"
-	    "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
-	    "refkey, conference_info_id"
-	    " FROM conference_call, sip_address AS from_sip_address, sip_address AS to_sip_address"
-	    " WHERE conference_call.from_sip_address_id = from_sip_address.id AND "
-	    "conference_call.to_sip_address_id = to_sip_address.id"
-	    "  AND ((from_sip_address.value LIKE '%%" +
-	    local->toStringUriOnlyOrdered() + "%%' AND to_sip_address.value LIKE '%%" + peer->toStringUriOnlyOrdered() +
-	    "%%' AND direction = 0) OR" // 0 == outgoing
-	    "  (from_sip_address.value LIKE '%%" +
-	    peer->toStringUriOnlyOrdered() + "%%' AND to_sip_address.value LIKE '%%" + local->toStringUriOnlyOrdered() +
-	    "%%' AND direction = 1))" // 1 == incoming
-	    " ORDER BY conference_call.id DESC";
-
-	if (limit > 0) query += " LIMIT " + to_string(limit);
+	const string peerUri = peer->toStringUriOnlyOrdered();
+	const string localUri = local->toStringUriOnlyOrdered();
 
 	DurationLogger durationLogger("Get call history 2.");
 
@@ -6412,7 +7334,28 @@ std::list<std::shared_ptr<CallLog>> MainDb::getCallHistory(const std::shared_ptr
 
 		list<shared_ptr<CallLog>> clList;
 
-		soci::session *session = d->dbSession.getBackendSession();
+		const string peerIds = d->selectSipAddressIdList(peerUri);
+		const string localIds = d->selectSipAddressIdList(localUri);
+		if (peerIds.empty() || localIds.empty()) return clList;
+
+		string query = "SELECT conference_call.id, from_sip_address.value, from_sip_address.display_name, "
+		               "to_sip_address.value, to_sip_address.display_name,"
+		               "  direction, duration, start_time, connected_time, status, video_enabled, quality, call_id, "
+		               "refkey, conference_info_id"
+		               " FROM conference_call, sip_address AS from_sip_address, sip_address AS to_sip_address"
+		               " WHERE conference_call.from_sip_address_id = from_sip_address.id AND "
+		               "conference_call.to_sip_address_id = to_sip_address.id"
+		               "  AND ((from_sip_address_id IN (" +
+		               localIds + ") AND to_sip_address_id IN (" + peerIds +
+		               ") AND direction = 0) OR" // 0 == outgoing
+		               "  (from_sip_address_id IN (" +
+		               peerIds + ") AND to_sip_address_id IN (" + localIds +
+		               ") AND direction = 1))" // 1 == incoming
+		               " ORDER BY conference_call.id DESC";
+
+		if (limit > 0) query += " LIMIT " + to_string(limit);
+
+		soci::session *session = d->getReadSession();
 
 		soci::rowset<soci::row> rows = (session->prepare << query);
 		for (const auto &row : rows) {
@@ -6643,7 +7586,8 @@ std::list<std::shared_ptr<FriendList>> MainDb::getFriendLists() {
 		soci::session *session = d->dbSession.getBackendSession();
 
 		soci::rowset<soci::row> rows =
-		    (session->prepare << "SELECT id, name, rls_uri, sync_uri, revision, type FROM friends_list ORDER BY id");
+		    (session->prepare << "SELECT id, name, rls_uri, sync_uri, revision, type, sync_token FROM friends_list "
+		                         "ORDER BY id");
 		for (const auto &row : rows) {
 			auto list = d->selectFriendList(row);
 			list->setCore(getCore());
@@ -6733,6 +7677,59 @@ std::list<std::shared_ptr<FriendDevice>> MainDb::getDevices(BCTBX_UNUSED(const s
 
 // -----------------------------------------------------------------------------
 
+bool MainDb::flushPendingWrites() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->commitWriteBehindBatch();
+#else
+	return true;
+#endif
+}
+
+void MainDb::flushPendingWritesIfNeeded() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	if (!d->writeBehindBatchPending) return;
+	if (d->writeBehindMaxDelay > 0 &&
+	    bctbx_get_cur_time_ms() - d->writeBehindBatchStartTime < (uint64_t)d->writeBehindMaxDelay)
+		return;
+	d->commitWriteBehindBatch();
+#endif
+}
+
+MainDb::WriteBatch::WriteBatch(const unique_ptr<MainDb> &mainDb) : mMainDb(mainDb.get()) {
+	if (mMainDb) mMainDb->beginWriteBatch();
+}
+
+MainDb::WriteBatch::~WriteBatch() {
+	if (mMainDb) mMainDb->endWriteBatch();
+}
+
+void MainDb::beginWriteBatch() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	d->writeBatchDepth++;
+#endif
+}
+
+void MainDb::endWriteBatch() {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	if (--d->writeBatchDepth == 0 && !d->writeBehindEnabled) d->commitWriteBehindBatch();
+#endif
+}
+
+bool MainDb::hasPendingWrites() const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	return d->writeBehindBatchPending;
+#else
+	return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
 bool MainDb::import(Backend, const string &parameters) {
 #ifdef HAVE_DB_STORAGE
 	L_D();
@@ -71,6 +71,18 @@ public:
 
 	typedef EnumMask<Filter> FilterMask;
 
+	// Commits all the transactions made during its lifetime at once, even if write-behind is disabled.
+	class WriteBatch {
+	public:
+		explicit WriteBatch(const std::unique_ptr<MainDb> &mainDb);
+		~WriteBatch();
+
+	private:
+		MainDb *mMainDb;
+
+		L_DISABLE_COPY(WriteBatch);
+	};
+
 	struct ParticipantState {
 		ParticipantState(const std::shared_ptr<Address> &address, ChatMessage::State state, time_t timestamp)
 		    : address(address), state(state), timestamp(timestamp) {
@@ -82,6 +94,7 @@ public:
 	};
 
 	MainDb(const std::shared_ptr<Core> &core);
+	~MainDb();
 
 	// ---------------------------------------------------------------------------
 	// Generic.
@@ -146,6 +159,16 @@ public:
 
 	std::list<std::shared_ptr<ChatMessage>> findChatMessagesToBeNotifiedAsDelivered() const;
 
+	// Full-text search over the text/plain contents of chat messages, best matches first. Searches all chat rooms if
+	// conferenceId is invalid. `cursor` is the number of results already fetched by previous calls.
+	std::list<std::shared_ptr<ChatMessage>> searchChatMessages(const std::string &text,
+	                                                           const ConferenceId &conferenceId = ConferenceId(),
+	                                                           unsigned int limit = 50,
+	                                                           unsigned int cursor = 0) const;
+
+	// Indexes at most `count` messages stored before the search index existed. Returns true if more remain.
+	bool backfillChatMessageSearchIndex(unsigned int count);
+
 	// ---------------------------------------------------------------------------
 	// Conference events.
 	// ---------------------------------------------------------------------------
@@ -154,6 +177,13 @@ public:
 	getHistory(const ConferenceId &conferenceId, int nLast, FilterMask mask = NoFilter) const;
 	std::list<std::shared_ptr<EventLog>>
 	getHistoryRange(const ConferenceId &conferenceId, int begin, int end, FilterMask mask = NoFilter) const;
+	// Keyset paginated history: returns at most `before` events older than `event` and at most `after` events
+	// newer than it, sorted from oldest to most recent. The anchor event itself is not part of the result.
+	std::list<std::shared_ptr<EventLog>> getHistoryRangeNear(const ConferenceId &conferenceId,
+	                                                         unsigned int before,
+	                                                         unsigned int after,
+	                                                         const std::shared_ptr<const EventLog> &event,
+	                                                         FilterMask mask = NoFilter) const;
 
 	int getHistorySize(const ConferenceId &conferenceId, FilterMask mask = NoFilter) const;
 
@@ -164,6 +194,10 @@ public:
 	// ---------------------------------------------------------------------------
 
 	void loadChatMessageContents(const std::shared_ptr<ChatMessage> &chatMessage);
+	// Loads the contents of all the given messages that are not loaded yet with a constant number of queries.
+	void loadChatMessagesContents(const std::list<std::shared_ptr<ChatMessage>> &chatMessages) const;
+	// Done by getHistoryRange() and getHistoryRangeNear() unless [storage] history_contents_prefetch_enabled is 0.
+	void prefetchChatMessageContents(const std::list<std::shared_ptr<EventLog>> &events) const;
 	std::list<std::shared_ptr<ChatMessageReaction>>
 	getChatMessageReactions(const std::shared_ptr<ChatMessage> &chatMessage);
 	void removeConferenceChatMessageReactionEvent(const std::string &messageId,
@@ -265,6 +299,13 @@ public:
 	// Import legacy calls/messages from old db.
 	bool import(Backend backend, const std::string &parameters) override;
 
+	// With [storage] write_behind_enabled, transactions are not committed one by one but batched until the next core
+	// iterate, or until write_behind_max_delay_ms has elapsed. The batch is visible to all MainDb requests before
+	// being committed. flushPendingWrites() commits it immediately.
+	bool flushPendingWrites() override;
+	void flushPendingWritesIfNeeded();
+	bool hasPendingWrites() const;
+
 protected:
 	void init() override;
 
@@ -274,6 +315,9 @@ private:
 	using ChatRoomWeakCompareMap = std::
 	    unordered_map<ConferenceId, std::shared_ptr<AbstractChatRoom>, ConferenceId::WeakHash, ConferenceId::WeakEqual>;
 	void initCleanup();
+	void beginWriteBatch();
+	void endWriteBatch();
+	void scheduleChatMessageSearchBackfill();
 	void addChatroomToList(ChatRoomWeakCompareMap &chatRoomsMap,
 	                       const std::shared_ptr<AbstractChatRoom> &chatRoom) const;
 	std::shared_ptr<AbstractChatRoom> mergeChatRooms(const std::shared_ptr<AbstractChatRoom> chatRoom1,
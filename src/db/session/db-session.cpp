@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
+
 #include "linphone/utils/utils.h"
 
 #include "db-session.h"
@@ -35,6 +37,11 @@ public:
 	enum class Backend { None, Mysql, Sqlite3 } backend = Backend::None;
 
 	std::unique_ptr<soci::session> backendSession;
+
+	// Declared after the backend session so that statements are released before the connection is closed.
+	mutable std::unordered_map<int, std::unique_ptr<DbSession::PreparedStatement>> preparedStatements;
+	mutable unsigned long preparedStatementHits = 0;
+	mutable unsigned long preparedStatementMisses = 0;
 };
 
 DbSession::DbSession() : mPrivate(new DbSessionPrivate) {
@@ -58,7 +65,8 @@ DbSession::DbSession(const string &uri) : DbSession() {
 					               "db="); // insert just after "sqlite3://" position +10, before the opening "
 				}
 			}
-			uriArgs.append(" vfs=").append(BCTBX_SQLITE3_VFS);
+			// Unless another VFS is requested, e.g. for the WAL journal mode which the bctbx VFS does not support.
+			if (uriArgs.find(" vfs=") == std::string::npos) uriArgs.append(" vfs=").append(BCTBX_SQLITE3_VFS);
 			d->backendSession = makeUnique<soci::session>(uriArgs);
 		} else {
 			d->backendSession = makeUnique<soci::session>(uri);
@@ -328,4 +336,40 @@ pair<tm, soci::indicator> DbSession::getTimeWithSociIndicator(time_t t) const {
 	return dataInDb;
 }
 
+DbSession::PreparedStatement &DbSession::getPreparedStatement(int key, const PreparedStatementBuilder &builder) const {
+	L_D();
+
+	auto it = d->preparedStatements.find(key);
+	if (it != d->preparedStatements.end()) {
+		d->preparedStatementHits++;
+		return *it->second;
+	}
+
+	d->preparedStatementMisses++;
+	auto preparedStatement = makeUnique<PreparedStatement>();
+	preparedStatement->statement.reset(builder(d->backendSession.get(), *preparedStatement));
+	return *d->preparedStatements.emplace(key, std::move(preparedStatement)).first->second;
+}
+
+void DbSession::clearPreparedStatements() {
+	L_D();
+
+	if (d->preparedStatements.empty()) return;
+
+	lInfo() << "Releasing " << d->preparedStatements.size()
+	        << " prepared statements (hits: " << d->preparedStatementHits
+	        << ", misses: " << d->preparedStatementMisses << ")";
+	d->preparedStatements.clear();
+}
+
+unsigned long DbSession::getPreparedStatementHits() const {
+	L_D();
+	return d->preparedStatementHits;
+}
+
+unsigned long DbSession::getPreparedStatementMisses() const {
+	L_D();
+	return d->preparedStatementMisses;
+}
+
 LINPHONE_END_NAMESPACE
@@ -21,6 +21,9 @@
 #ifndef _L_DB_SESSION_H_
 #define _L_DB_SESSION_H_
 
+#include <functional>
+#include <memory>
+
 #include <soci/soci.h>
 
 #include "linphone/utils/general.h"
@@ -33,6 +36,34 @@ class DbSessionPrivate;
 
 class DbSession {
 public:
+	// A statement prepared once per session. The bound variables live next to the statement so that their address
+	// stays valid: callers rebind by assigning the inputs before each execution and read the outputs afterwards.
+	struct PreparedStatement {
+		std::unique_ptr<soci::statement> statement;
+
+		long long ids[4] = {0, 0, 0, 0};
+		std::string text;
+
+		long long resultId = -1;
+		std::string resultText;
+
+		bool execute() {
+			if (!statement->execute(true)) return false;
+
+			// Only the first row is used, but a statement that isn't run to completion keeps its read transaction
+			// opened until its next execution.
+			const long long id = resultId;
+			std::string text = resultText;
+			while (statement->fetch()) {
+			}
+			resultId = id;
+			resultText = std::move(text);
+			return true;
+		}
+	};
+
+	using PreparedStatementBuilder = std::function<soci::statement *(soci::session *session, PreparedStatement &)>;
+
 	DbSession();
 	explicit DbSession(const std::string &uri);
 	DbSession(DbSession &&other);
@@ -66,6 +97,14 @@ public:
 
 	unsigned int getUnsignedInt(const soci::row &row, std::size_t col, const unsigned int def = 0) const;
 
+	// Returns the statement cached under `key`, calling `builder` to prepare it on first use.
+	PreparedStatement &getPreparedStatement(int key, const PreparedStatementBuilder &builder) const;
+	// Must be called whenever the backend session is reconnected, prepared statements do not survive it.
+	void clearPreparedStatements();
+
+	unsigned long getPreparedStatementHits() const;
+	unsigned long getPreparedStatementMisses() const;
+
 private:
 	DbSessionPrivate *mPrivate;
 
@@ -186,8 +186,11 @@ LinphoneStatus EventSubscribe::notify(const std::shared_ptr<const Content> &body
 		ms_error("EventSubscribe::notify(): cannot notify if not an incoming subscription.");
 		return -1;
 	}
-	const LinphoneContent *cBody = (body && !body->isEmpty()) ? body->toC() : nullptr;
-	body_handler = sal_body_handler_from_content(cBody, false);
+	body_handler = (body && !body->isEmpty()) ? body->createPreparedBodyHandler() : nullptr;
+	if (!body_handler) {
+		const LinphoneContent *cBody = (body && !body->isEmpty()) ? body->toC() : nullptr;
+		body_handler = sal_body_handler_from_content(cBody, false);
+	}
 	auto subscribeOp = dynamic_cast<SalSubscribeOp *>(mOp);
 	return subscribeOp->notify(body_handler);
 }
@@ -18,8 +18,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include <fstream>
 #include <set>
+#include <unordered_map>
 
 #include "bctoolbox/list.h"
 #include <bctoolbox/defs.h>
@@ -45,7 +47,7 @@
 #include "vcard/vcard-context.h"
 #include "vcard/vcard.h"
 #ifdef HAVE_XML2
-#include "xml/xml-parsing-context.h"
+#include <libxml/xmlreader.h>
 #endif // HAVE_XML2
 
 // =============================================================================
@@ -152,6 +154,10 @@ bool FriendList::isSubscriptionBodyless() const {
 	return mBodylessSubscription;
 }
 
+FriendSearchIndex &FriendList::getSearchIndex() const {
+	return mSearchIndex;
+}
+
 // -----------------------------------------------------------------------------
 
 LinphoneFriendListStatus FriendList::addFriend(const std::shared_ptr<Friend> &lf) {
@@ -617,6 +623,7 @@ LinphoneFriendListStatus FriendList::importFriend(const std::shared_ptr<Friend>
 	lf->mFriendList = this;
 	mFriends.push_front(lf);
 	lf->addAddressesAndNumbersIntoMaps(getSharedFromThis());
+	mSearchIndex.markAddedToFront(lf);
 	if (synchronize) {
 		mDirtyFriendsToUpdate.push_front(lf);
 		mBctbxDirtyFriendsToUpdate = bctbx_list_prepend(mBctbxDirtyFriendsToUpdate, lf->toC());
@@ -694,143 +701,198 @@ private:
 	const char *mMessage;
 };
 
+// Resource element of a rlmi+xml body, as collected by the streaming reader.
+struct RlmiResource {
+	std::string uri;
+	std::string name;
+	std::string activeCid;
+	bool hasName = false;
+};
+
+static void rlmiReaderErrorHandler(BCTBX_UNUSED(void *arg),
+                                   const char *msg,
+                                   BCTBX_UNUSED(xmlParserSeverities severity),
+                                   BCTBX_UNUSED(xmlTextReaderLocatorPtr locator)) {
+	lWarning() << "rlmi+xml: " << msg;
+}
+
+static std::string getRlmiReaderAttribute(xmlTextReaderPtr reader, const char *name) {
+	std::string result;
+	xmlChar *value = xmlTextReaderGetAttribute(reader, reinterpret_cast<const xmlChar *>(name));
+	if (value) {
+		result = reinterpret_cast<const char *>(value);
+		xmlFree(value);
+	}
+	return result;
+}
+
+static bool isRlmiElement(xmlTextReaderPtr reader, const char *localName) {
+	const xmlChar *ns = xmlTextReaderConstNamespaceUri(reader);
+	const xmlChar *name = xmlTextReaderConstLocalName(reader);
+	return ns && name && (strcmp(reinterpret_cast<const char *>(ns), "urn:ietf:params:xml:ns:rlmi") == 0) &&
+	       (strcmp(reinterpret_cast<const char *>(name), localName) == 0);
+}
+
 void FriendList::parseMultipartRelatedBody(const std::shared_ptr<const Content> &content,
                                            const std::string &firstPartBody) {
-	try {
-		XmlParsingContext xmlCtx(firstPartBody);
-		if (!xmlCtx.isValid()) {
-			stringstream ss;
-			ss << "Wrongly formatted rlmi+xml body: " << xmlCtx.getError();
-			throw FriendListXmlException(ss.str().c_str());
+	// Index the parts by Content-Id once, so that each resource finds its presence document in constant time.
+	std::unordered_map<std::string, std::shared_ptr<Content>> partsByCid;
+	bctbx_list_t *parts = linphone_content_get_parts(content->toC());
+	for (bctbx_list_t *it = parts; it != nullptr; it = bctbx_list_next(it)) {
+		LinphoneContent *part = (LinphoneContent *)it->data;
+		const char *header = linphone_content_get_custom_header(part, "Content-Id");
+		if (header) partsByCid.emplace(header, Content::toCpp(part)->getSharedFromThis());
+	}
+	bctbx_list_free_with_data(parts, (void (*)(void *))linphone_content_unref);
+
+	std::set<std::shared_ptr<Friend>> listFriendsPresenceReceived;
+	auto processResource = [&](const RlmiResource &resource) {
+		if (resource.uri.empty()) return;
+		if (resource.hasName) {
+			std::shared_ptr<Address> addr = Address::create(resource.uri);
+			if (addr) {
+				std::shared_ptr<Friend> lf = findFriendByAddress(addr);
+				if (!lf && mBodylessSubscription) {
+					lf = Friend::create(getCore(), resource.uri);
+					addFriend(lf);
+				}
+				if (lf && !resource.name.empty()) lf->setName(resource.name);
+			}
 		}
+		if (resource.activeCid.empty()) return;
 
-		xmlXPathRegisterNs(xmlCtx.getXpathContext(), reinterpret_cast<const xmlChar *>("rlmi"),
-		                   reinterpret_cast<const xmlChar *>("urn:ietf:params:xml:ns:rlmi"));
-		std::string versionStr = xmlCtx.getAttributeTextContent("/rlmi:list", "version");
-		if (versionStr.empty()) throw FriendListXmlException("rlmi+xml: No version attribute in list");
-		int version = atoi(versionStr.c_str());
-		if (version < mExpectedNotificationVersion) {
-			// No longer an error as dialog may be silently restarting by the refresher
-			lWarning() << "rlmi+xml: Received notification with version " << version << " expected was "
-			           << mExpectedNotificationVersion << ", dialog may have been reseted";
-		}
-		std::string fullStateStr = xmlCtx.getAttributeTextContent("/rlmi:list", "fullState");
-		if (fullStateStr.empty()) throw FriendListXmlException("rlmi+xml: No fullState attribute in list");
-		bool fullState = false;
-		std::string fullStateString(fullStateStr);
-		if ((fullStateString == "true") || (fullStateString == "1")) {
-			fullState = true;
-			for (const auto &lf : mFriends)
-				lf->clearPresenceModels();
+		const auto partIt = partsByCid.find(resource.activeCid);
+		if (partIt == partsByCid.end()) {
+			lWarning() << "rlmi+xml: Cannot find part with Content-Id: " << resource.activeCid;
+			return;
 		}
-		if ((mExpectedNotificationVersion == 0) && !fullState)
-			throw FriendListXmlException("rlmi+xml: Notification with version 0 is not full state, this is not valid");
-		mExpectedNotificationVersion = version + 1;
-
-		xmlXPathObjectPtr nameObject = xmlCtx.getXpathObjectForNodeList("/rlmi:list/rlmi:resource/rlmi:name/..");
-		if (nameObject && nameObject->nodesetval) {
-			for (int i = 1; i <= nameObject->nodesetval->nodeNr; i++) {
-				xmlCtx.setXpathContextNode(xmlXPathNodeSetItem(nameObject->nodesetval, i - 1));
-				std::string name = xmlCtx.getTextContent("./rlmi:name");
-				std::string uri = xmlCtx.getTextContent("./@uri");
-				if (uri.empty()) continue;
-				std::shared_ptr<Address> addr = Address::create(uri);
-				if (!addr) continue;
-				std::shared_ptr<Friend> lf = findFriendByAddress(addr);
-				if (!lf && mBodylessSubscription) {
-					lf = Friend::create(getCore(), uri);
+		const std::shared_ptr<Content> &presencePart = partIt->second;
+		SalPresenceModel *presence = nullptr;
+		const ContentType &presencePartContentType = presencePart->getContentType();
+		PresenceModel::parsePresence(presencePartContentType.getType(), presencePartContentType.getSubType(),
+		                             presencePart->getBodyAsUtf8String(), &presence);
+		if (!presence) return;
+
+		// Try to reduce CPU cost of linphone_address_new and find_friend_by_address by only doing
+		// it when we know for sure we have a presence to notify
+		std::shared_ptr<Address> addr = Address::create(resource.uri);
+		if (addr) {
+			// Clean the URI
+			if (addr->hasUriParam("gr")) addr->removeUriParam("gr");
+			std::string uri = addr->asStringUriOnly();
+
+			const auto [first, last] = mFriendsMapByUri.equal_range(uri);
+			if (first == last) {
+				if (mBodylessSubscription) {
+					std::shared_ptr<Friend> lf = Friend::create(getCore(), uri);
 					addFriend(lf);
+					lf->presenceReceived(getSharedFromThis(), uri,
+					                     PresenceModel::toCpp((LinphonePresenceModel *)presence)->getSharedFromThis());
+					listFriendsPresenceReceived.insert(lf);
+				}
+			} else {
+				// Save the equal_range iterators for looping because mFriendsMapByUri might
+				// change during the loop, leading to wrong presence notifications
+				std::list<std::multimap<std::string, std::shared_ptr<Friend>>::iterator> its;
+				for (auto it = first; it != last; it++)
+					its.push_back(it);
+				for (const auto &it : its) {
+					it->second->presenceReceived(
+					    getSharedFromThis(), uri,
+					    PresenceModel::toCpp((LinphonePresenceModel *)presence)->getSharedFromThis());
+					listFriendsPresenceReceived.insert(it->second);
 				}
-				if (!name.empty()) lf->setName(name);
 			}
 		}
-		if (nameObject) xmlXPathFreeObject(nameObject);
-
-		std::set<std::shared_ptr<Friend>> listFriendsPresenceReceived;
-		bctbx_list_t *parts = linphone_content_get_parts(content->toC());
-		xmlXPathObjectPtr resourceObject =
-		    xmlCtx.getXpathObjectForNodeList("/rlmi:list/rlmi:resource/rlmi:instance[@state=\"active\"]/..");
-		if (resourceObject && resourceObject->nodesetval) {
-			for (int i = 1; i <= resourceObject->nodesetval->nodeNr; i++) {
-				xmlCtx.setXpathContextNode(xmlXPathNodeSetItem(resourceObject->nodesetval, i - 1));
-				std::string cid = xmlCtx.getTextContent("./rlmi:instance/@cid");
-				if (!cid.empty()) {
-					std::shared_ptr<Content> presencePart = nullptr;
-					bctbx_list_t *it = parts;
-					while (it != nullptr) {
-						LinphoneContent *content = (LinphoneContent *)it->data;
-						const char *header = linphone_content_get_custom_header(content, "Content-Id");
-						if (header && (std::string(header) == cid)) {
-							presencePart = Content::toCpp(content)->getSharedFromThis();
-							break;
-						}
-						it = bctbx_list_next(it);
-					}
-					if (!presencePart) {
-						lWarning() << "rlmi+xml: Cannot find part with Content-Id: " << cid;
-					} else {
-						SalPresenceModel *presence = nullptr;
-						const ContentType &presencePartContentType = presencePart->getContentType();
-						PresenceModel::parsePresence(presencePartContentType.getType(),
-						                             presencePartContentType.getSubType(),
-						                             presencePart->getBodyAsUtf8String(), &presence);
-						if (presence) {
-							// Try to reduce CPU cost of linphone_address_new and find_friend_by_address by only doing
-							// it when we know for sure we have a presence to notify
-							std::string uri = xmlCtx.getTextContent("./@uri");
-							if (uri.empty()) continue;
-							std::shared_ptr<Address> addr = Address::create(uri);
-							if (!addr) continue;
-
-							// Clean the URI
-							if (addr->hasUriParam("gr")) addr->removeUriParam("gr");
-							uri = addr->asStringUriOnly();
-
-							const auto [first, last] = mFriendsMapByUri.equal_range(uri);
-							if (first == last) {
-								if (mBodylessSubscription) {
-									std::shared_ptr<Friend> lf = Friend::create(getCore(), uri);
-									addFriend(lf);
-									lf->presenceReceived(
-									    getSharedFromThis(), uri,
-									    PresenceModel::toCpp((LinphonePresenceModel *)presence)->getSharedFromThis());
-									listFriendsPresenceReceived.insert(lf);
-								}
-							} else {
-								// Save the equal_range iterators for looping because mFriendsMapByUri might
-								// change during the loop, leading to wrong presence notifications
-								std::list<std::multimap<std::string, std::shared_ptr<Friend>>::iterator> its;
-								for (auto it = first; it != last; it++)
-									its.push_back(it);
-								for (const auto &it : its) {
-									it->second->presenceReceived(
-									    getSharedFromThis(), uri,
-									    PresenceModel::toCpp((LinphonePresenceModel *)presence)->getSharedFromThis());
-									listFriendsPresenceReceived.insert(it->second);
-								}
-							}
-
-							PresenceModel::toCpp((LinphonePresenceModel *)presence)->unref();
+		PresenceModel::toCpp((LinphonePresenceModel *)presence)->unref();
+	};
+
+	// Walk the rlmi document with a streaming reader: resources are handled as soon as their end tag is read,
+	// without building a DOM tree nor evaluating XPath expressions.
+	xmlTextReaderPtr reader =
+	    xmlReaderForMemory(firstPartBody.c_str(), (int)firstPartBody.size(), nullptr, nullptr, XML_PARSE_NONET);
+	if (!reader) {
+		lWarning() << "Wrongly formatted rlmi+xml body";
+		return;
+	}
+	xmlTextReaderSetErrorHandler(reader, rlmiReaderErrorHandler, nullptr);
+
+	try {
+		RlmiResource resource;
+		bool inList = false;
+		bool inResource = false;
+		int ret;
+		while ((ret = xmlTextReaderRead(reader)) == 1) {
+			const int type = xmlTextReaderNodeType(reader);
+			const int depth = xmlTextReaderDepth(reader);
+			if (type == XML_READER_TYPE_END_ELEMENT) {
+				if (inResource && (depth == 1)) {
+					inResource = false;
+					processResource(resource);
+				}
+				continue;
+			}
+			if (type != XML_READER_TYPE_ELEMENT) continue;
+
+			if (depth == 0) {
+				if (!isRlmiElement(reader, "list"))
+					throw FriendListXmlException("rlmi+xml: root element is not a list");
+				std::string versionStr = getRlmiReaderAttribute(reader, "version");
+				if (versionStr.empty()) throw FriendListXmlException("rlmi+xml: No version attribute in list");
+				int version = atoi(versionStr.c_str());
+				if (version < mExpectedNotificationVersion) {
+					// No longer an error as dialog may be silently restarting by the refresher
+					lWarning() << "rlmi+xml: Received notification with version " << version << " expected was "
+					           << mExpectedNotificationVersion << ", dialog may have been reseted";
+				}
+				std::string fullStateString = getRlmiReaderAttribute(reader, "fullState");
+				if (fullStateString.empty()) throw FriendListXmlException("rlmi+xml: No fullState attribute in list");
+				bool fullState = false;
+				if ((fullStateString == "true") || (fullStateString == "1")) {
+					fullState = true;
+					for (const auto &lf : mFriends)
+						lf->clearPresenceModels();
+				}
+				if ((mExpectedNotificationVersion == 0) && !fullState)
+					throw FriendListXmlException(
+					    "rlmi+xml: Notification with version 0 is not full state, this is not valid");
+				mExpectedNotificationVersion = version + 1;
+				inList = true;
+			} else if (inList && (depth == 1) && isRlmiElement(reader, "resource")) {
+				resource = RlmiResource();
+				resource.uri = getRlmiReaderAttribute(reader, "uri");
+				if (xmlTextReaderIsEmptyElement(reader)) processResource(resource);
+				else inResource = true;
+			} else if (inResource && (depth == 2)) {
+				if (isRlmiElement(reader, "name")) {
+					resource.hasName = true;
+					if (resource.name.empty()) {
+						xmlChar *text = xmlTextReaderReadString(reader);
+						if (text) {
+							resource.name = reinterpret_cast<const char *>(text);
+							xmlFree(text);
 						}
 					}
+				} else if (resource.activeCid.empty() && isRlmiElement(reader, "instance") &&
+				           (getRlmiReaderAttribute(reader, "state") == "active")) {
+					resource.activeCid = getRlmiReaderAttribute(reader, "cid");
 				}
 			}
-
-			// Notify list with all friends for which we received presence information
-			if (!listFriendsPresenceReceived.empty()) {
-				bctbx_list_t *l = nullptr;
-				for (const auto &lf : listFriendsPresenceReceived)
-					l = bctbx_list_append(l, lf->toC());
-				LINPHONE_HYBRID_OBJECT_INVOKE_CBS(FriendList, this, linphone_friend_list_cbs_get_presence_received, l);
-				bctbx_list_free(l);
-			}
 		}
-
-		bctbx_list_free_with_data(parts, (void (*)(void *))linphone_content_unref);
-		if (resourceObject) xmlXPathFreeObject(resourceObject);
+		if (ret < 0) throw FriendListXmlException("Wrongly formatted rlmi+xml body");
 	} catch (FriendListXmlException &e) {
 		lWarning() << e.what();
 	}
+	xmlFreeTextReader(reader);
+
+	// Notify list with all friends for which we received presence information
+	if (!listFriendsPresenceReceived.empty()) {
+		bctbx_list_t *l = nullptr;
+		for (const auto &lf : listFriendsPresenceReceived)
+			l = bctbx_list_append(l, lf->toC());
+		LINPHONE_HYBRID_OBJECT_INVOKE_CBS(FriendList, this, linphone_friend_list_cbs_get_presence_received, l);
+		bctbx_list_free(l);
+	}
 }
 
 #else
@@ -890,6 +952,7 @@ void FriendList::removeFriends(bool removeFromServer) {
 		deleteFriend(lf, removeFromServer);
 	}
 	mFriends.clear();
+	mSearchIndex.clear();
 }
 
 LinphoneFriendListStatus FriendList::removeFriend(const std::shared_ptr<Friend> &lf, bool removeFromServer) {
@@ -898,6 +961,7 @@ LinphoneFriendListStatus FriendList::removeFriend(const std::shared_ptr<Friend>
 
 	deleteFriend(lf, removeFromServer);
 	mFriends.erase(it);
+	mSearchIndex.remove(lf.get());
 	return LinphoneFriendListOK;
 }
 
@@ -992,6 +1056,7 @@ void FriendList::sendListSubscriptionWithoutBody(const std::shared_ptr<Address>
 
 void FriendList::setFriends(const std::list<std::shared_ptr<Friend>> &friends) {
 	mFriends = friends;
+	mSearchIndex.clear();
 }
 
 void FriendList::syncBctbxFriends() const {
@@ -1086,6 +1151,7 @@ void FriendList::carddavUpdated(const CardDAVContext *context,
 	auto it = std::find_if(context->mFriendList->mFriends.begin(), context->mFriendList->mFriends.end(),
 	                       [&](const auto &elem) { return elem == oldFriend; });
 	if (it != context->mFriendList->mFriends.end()) *it = newFriend;
+	context->mFriendList->mSearchIndex.replace(oldFriend.get(), newFriend);
 	newFriend->saveInDb();
 	LINPHONE_HYBRID_OBJECT_INVOKE_CBS(FriendList, context->mFriendList, linphone_friend_list_cbs_get_contact_updated,
 	                                  newFriend->toC(), oldFriend->toC());
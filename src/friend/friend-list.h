@@ -26,6 +26,7 @@
 #include "c-wrapper/c-wrapper.h"
 #include "core/core-accessor.h"
 #include "private_functions.h"
+#include "search/friend-search-index.h"
 
 // =============================================================================
 
@@ -108,6 +109,7 @@ public:
 	const std::string &getUri() const;
 	const std::list<std::shared_ptr<Friend>> &getDirtyFriendsToUpdate() const;
 	bool isSubscriptionBodyless() const;
+	FriendSearchIndex &getSearchIndex() const;
 
 	// Other
 	LinphoneFriendListStatus addFriend(const std::shared_ptr<Friend> &lf);
@@ -187,10 +189,12 @@ private:
 	std::list<std::shared_ptr<Friend>> mDirtyFriendsToUpdate;
 	bctbx_list_t *mBctbxDirtyFriendsToUpdate = nullptr; // This field must be kept in sync with mDirtyFriendsToUpdate
 	int mRevision = -1;
+	std::string mSyncToken; // RFC 6578 sync-token of the last successful CardDAV synchronization
 	bool mSubscriptionsEnabled = false;
 	bool mBodylessSubscription = false;
 	LinphoneFriendListType mType = LinphoneFriendListTypeDefault;
 	bool mStoreInDb = false;
+	mutable FriendSearchIndex mSearchIndex;
 #if VCARD_ENABLED
 	CardDAVContext *mCardDavContext = nullptr;
 #endif
@@ -91,6 +91,7 @@ std::string Friend::toString() const {
 // -----------------------------------------------------------------------------
 
 LinphoneStatus Friend::setAddress(const std::shared_ptr<const Address> &address) {
+	invalidateSearchData();
 	if (!address) return -1;
 	Address *newAddress = address->clone();
 	newAddress->clean();
@@ -131,6 +132,7 @@ void Friend::setJobTitle(const std::string &title) {
 }
 
 LinphoneStatus Friend::setName(const std::string &name) {
+	invalidateSearchData();
 	if (linphone_core_vcard_supported()) {
 		if (!mVcard) {
 			createVcard(name);
@@ -153,6 +155,7 @@ void Friend::setNativeUri(const std::string &nativeUri) {
 }
 
 void Friend::setOrganization(const std::string &organization) {
+	invalidateSearchData();
 	if (linphone_core_vcard_supported() && mVcard) {
 		mVcard->setOrganization(organization);
 	}
@@ -195,6 +198,7 @@ void Friend::setVcard(const std::shared_ptr<Vcard> &vcard) {
 	}
 
 	mVcard = vcard;
+	invalidateSearchData();
 	if (mFriendList) saveInDb();
 }
 
@@ -507,6 +511,7 @@ LinphoneSecurityLevel Friend::getSecurityLevelForAddress(const Address &address)
 // -----------------------------------------------------------------------------
 
 void Friend::addAddress(const std::shared_ptr<const Address> &address) {
+	invalidateSearchData();
 	if (!address) return;
 
 	std::shared_ptr<Address> newAddr = address->clone()->getSharedFromThis();
@@ -526,6 +531,7 @@ void Friend::addAddress(const std::shared_ptr<const Address> &address) {
 }
 
 void Friend::addPhoneNumber(const std::string &phoneNumber) {
+	invalidateSearchData();
 	if (phoneNumber.empty()) return;
 	if (mFriendList) {
 		const std::string uri = phoneNumberToSipUri(phoneNumber);
@@ -538,6 +544,7 @@ void Friend::addPhoneNumber(const std::string &phoneNumber) {
 }
 
 void Friend::addPhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneNumber> &phoneNumber) {
+	invalidateSearchData();
 	if (!phoneNumber) return;
 	const std::string &phone = phoneNumber->getPhoneNumber();
 	if (phone.empty()) return;
@@ -570,6 +577,7 @@ bool Friend::createVcard(const std::string &name) {
 }
 
 void Friend::done() {
+	invalidateSearchData();
 	if (linphone_core_vcard_supported() && mVcard) {
 		if (mVcard->compareMd5Hash()) {
 			lDebug() << "vCard's md5 has changed, mark friend as dirty and clear sip addresses list cache";
@@ -688,6 +696,7 @@ void Friend::remove() {
 }
 
 void Friend::removeAddress(const std::shared_ptr<const Address> &address) {
+	invalidateSearchData();
 	if (!address) return;
 
 	std::string uri = address->asStringUriOnly();
@@ -698,6 +707,7 @@ void Friend::removeAddress(const std::shared_ptr<const Address> &address) {
 }
 
 void Friend::removePhoneNumber(const std::string &phoneNumber) {
+	invalidateSearchData();
 	if (phoneNumber.empty()) return;
 
 	if (mFriendList) removeFriendFromListMapIfAlreadyInIt(phoneNumberToSipUri(phoneNumber));
@@ -707,6 +717,7 @@ void Friend::removePhoneNumber(const std::string &phoneNumber) {
 }
 
 void Friend::removePhoneNumberWithLabel(const std::shared_ptr<const FriendPhoneNumber> &phoneNumber) {
+	invalidateSearchData();
 	if (!phoneNumber) return;
 
 	const std::string &phone = phoneNumber->getPhoneNumber();
@@ -765,6 +776,8 @@ void Friend::addPresenceModelForUriOrTel(const std::string &uriOrTel, const std:
 	} else {
 		it->second = model;
 	}
+	// The presence contact of phone numbers is searchable.
+	invalidateSearchData();
 }
 
 void Friend::apply() {
@@ -871,6 +884,11 @@ bool Friend::hasPhoneNumber(const std::shared_ptr<Account> &account, const std::
 	return found;
 }
 
+void Friend::invalidateSearchData() {
+	mSearchRevision++;
+	if (mFriendList) mFriendList->getSearchIndex().markDirty(getSharedFromThis());
+}
+
 void Friend::invalidateSubscription() {
 	if (mOutSub) {
 		mOutSub->release();
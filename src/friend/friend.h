@@ -38,6 +38,7 @@ class CardDAVContext;
 class FriendCbs;
 class FriendList;
 class FriendDevice;
+class FriendSearchIndex;
 class FriendPhoneNumber;
 class MainDb;
 class MainDbPrivate;
@@ -64,6 +65,7 @@ public:
 	// Friends
 	friend CardDAVContext;
 	friend FriendList;
+	friend FriendSearchIndex;
 	friend MainDb;
 	friend MainDbPrivate;
 	friend PresenceModel;
@@ -166,6 +168,7 @@ private:
 	void closeSubscriptions();
 	void doSubscribe();
 	bool hasPhoneNumber(const std::shared_ptr<Account> &account, const std::string &searchedPhoneNumber) const;
+	void invalidateSearchData();
 	void invalidateSubscription();
 	void notify(const std::shared_ptr<PresenceModel> &presence);
 	const std::string &phoneNumberToSipUri(const std::string &phoneNumber) const;
@@ -213,6 +216,7 @@ private:
 	BuddyInfo *mInfo = nullptr;
 	std::shared_ptr<Vcard> mVcard = nullptr;
 	FriendList *mFriendList = nullptr;
+	unsigned int mSearchRevision = 0; // Incremented on changes affecting the search index of the friend list.
 
 	mutable std::list<std::shared_ptr<Address>> mAddresses;
 	mutable bctbx_list_t *mBctbxAddresses = nullptr; // Kept in sync with mAddresses for C compatibility
@@ -331,6 +331,16 @@ bool PresenceModel::isOnline() const {
 	return (mIsOnline || ((getBasicStatus() == LinphonePresenceBasicStatusOpen) && (getNbActivities() == 0)));
 }
 
+static bool streamingPidfParser = true;
+
+void PresenceModel::enableStreamingPidfParser(bool enable) {
+	streamingPidfParser = enable;
+}
+
+bool PresenceModel::streamingPidfParserEnabled() {
+	return streamingPidfParser;
+}
+
 #ifdef HAVE_XML2
 
 int PresenceModel::parsePidfXmlPresenceNotes(XmlParsingContext &xmlContext) {
@@ -445,6 +455,224 @@ int PresenceModel::parsePidfXmlPresenceServices(XmlParsingContext &xmlContext) {
 	return 0;
 }
 
+static constexpr const char *pidfNs = "urn:ietf:params:xml:ns:pidf";
+static constexpr const char *pidfDataModelNs = "urn:ietf:params:xml:ns:pidf:data-model";
+static constexpr const char *pidfRpidNs = "urn:ietf:params:xml:ns:pidf:rpid";
+static constexpr const char *pidfOnlineNs = "http://www.linphone.org/xsds/pidfonline.xsd";
+static constexpr const char *pidfOmaPresNs = "urn:oma:xml:prs:pidf:oma-pres";
+
+static void pidfReaderErrorHandler(BCTBX_UNUSED(void *arg),
+                                   const char *msg,
+                                   BCTBX_UNUSED(xmlParserSeverities severity),
+                                   BCTBX_UNUSED(xmlTextReaderLocatorPtr locator)) {
+	ms_warning("Wrongly formatted presence XML: %s", msg);
+}
+
+static bool isPidfReaderElement(xmlTextReaderPtr reader, const char *ns, const char *localName) {
+	const xmlChar *elementNs = xmlTextReaderConstNamespaceUri(reader);
+	const xmlChar *elementName = xmlTextReaderConstLocalName(reader);
+	return elementNs && elementName && (strcmp(reinterpret_cast<const char *>(elementNs), ns) == 0) &&
+	       (strcmp(reinterpret_cast<const char *>(elementName), localName) == 0);
+}
+
+static std::string getPidfReaderAttribute(xmlTextReaderPtr reader, const char *name) {
+	std::string result;
+	xmlChar *value = xmlTextReaderGetAttribute(reader, reinterpret_cast<const xmlChar *>(name));
+	if (value) {
+		result = reinterpret_cast<const char *>(value);
+		xmlFree(value);
+	}
+	return result;
+}
+
+/*
+ * Reads the text of the current element and leaves the reader on its end tag. Only the text directly under the
+ * element is kept, unless deep is set.
+ */
+static int readPidfReaderText(xmlTextReaderPtr reader, std::string &text, bool deep = false) {
+	text.clear();
+	if (xmlTextReaderIsEmptyElement(reader)) return 1;
+	const int depth = xmlTextReaderDepth(reader);
+	int ret;
+	while ((ret = xmlTextReaderRead(reader)) == 1) {
+		const int type = xmlTextReaderNodeType(reader);
+		const int nodeDepth = xmlTextReaderDepth(reader);
+		if ((type == XML_READER_TYPE_END_ELEMENT) && (nodeDepth == depth)) break;
+		if (((type == XML_READER_TYPE_TEXT) || (type == XML_READER_TYPE_CDATA) ||
+		     (type == XML_READER_TYPE_WHITESPACE) || (type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE)) &&
+		    (deep || (nodeDepth == depth + 1))) {
+			const xmlChar *value = xmlTextReaderConstValue(reader);
+			if (value) text += reinterpret_cast<const char *>(value);
+		}
+	}
+	return ret;
+}
+
+int PresenceModel::parsePidfXmlPresenceService(xmlTextReaderPtr reader, bool &invalid) {
+	std::string basicStatusStr, timestampStr, contactStr, text;
+	std::string serviceId, version;
+	std::list<std::string> descriptions;
+	bool online = false;
+	std::shared_ptr<PresenceService> service =
+	    PresenceService::create(getPidfReaderAttribute(reader, "id"), LinphonePresenceBasicStatusClosed);
+
+	if (!xmlTextReaderIsEmptyElement(reader)) {
+		const int depth = xmlTextReaderDepth(reader);
+		bool inStatus = false;
+		bool inDescription = false;
+		int ret;
+		while ((ret = xmlTextReaderRead(reader)) == 1) {
+			const int type = xmlTextReaderNodeType(reader);
+			const int nodeDepth = xmlTextReaderDepth(reader);
+			if (type == XML_READER_TYPE_END_ELEMENT) {
+				if (nodeDepth == depth) break;
+				if (inDescription && (nodeDepth == depth + 1)) {
+					if (!serviceId.empty()) {
+						descriptions.push_back(serviceId);
+						service->addCapability(serviceId, version);
+					}
+					serviceId.clear(), version.clear();
+				}
+				continue;
+			}
+			if (type != XML_READER_TYPE_ELEMENT) continue;
+
+			if (nodeDepth == depth + 1) {
+				const bool isEmpty = xmlTextReaderIsEmptyElement(reader);
+				inStatus = !isEmpty && isPidfReaderElement(reader, pidfNs, "status");
+				inDescription = !isEmpty && isPidfReaderElement(reader, pidfOmaPresNs, "service-description");
+				if (isPidfReaderElement(reader, pidfNs, "timestamp")) {
+					ret = readPidfReaderText(reader, text);
+					if (timestampStr.empty()) timestampStr = text;
+				} else if (isPidfReaderElement(reader, pidfNs, "contact")) {
+					ret = readPidfReaderText(reader, text);
+					if (contactStr.empty()) contactStr = text;
+				} else if (isPidfReaderElement(reader, pidfNs, "note")) {
+					std::string lang = getPidfReaderAttribute(reader, "xml:lang");
+					ret = readPidfReaderText(reader, text);
+					if (!text.empty()) service->addNote(PresenceNote::create(text, lang));
+				}
+			} else if (inStatus && (nodeDepth == depth + 2)) {
+				if (isPidfReaderElement(reader, pidfNs, "basic")) {
+					ret = readPidfReaderText(reader, text);
+					if (basicStatusStr.empty()) basicStatusStr = text;
+				} else if (isPidfReaderElement(reader, pidfOnlineNs, "online")) {
+					online = true;
+				}
+			} else if (inDescription && (nodeDepth == depth + 2)) {
+				if (isPidfReaderElement(reader, pidfOmaPresNs, "service-id")) {
+					ret = readPidfReaderText(reader, text);
+					if (serviceId.empty()) serviceId = text;
+				} else if (isPidfReaderElement(reader, pidfOmaPresNs, "version")) {
+					ret = readPidfReaderText(reader, text);
+					if (version.empty()) version = text;
+				}
+			}
+			if (ret != 1) break;
+		}
+		if (ret != 1) return ret;
+	}
+
+	if (basicStatusStr.empty()) return 1;
+	if (basicStatusStr == "open") service->setBasicStatus(LinphonePresenceBasicStatusOpen);
+	else if (basicStatusStr != "closed") {
+		invalid = true; /* Invalid value for basic status. */
+		return 1;
+	}
+	if (online) mIsOnline = true;
+	if (!timestampStr.empty()) service->setTimestamp(PresenceModel::parseTimestamp(timestampStr));
+	if (!contactStr.empty()) service->setContact(contactStr);
+	if (!descriptions.empty()) service->setDescriptions(descriptions);
+	addService(service);
+	return 1;
+}
+
+int PresenceModel::parsePidfXmlPresencePerson(xmlTextReaderPtr reader, time_t &timestamp) {
+	std::string timestampStr, text;
+	std::shared_ptr<PresencePerson> person = PresencePerson::create(getPidfReaderAttribute(reader, "id"), timestamp);
+
+	if (!xmlTextReaderIsEmptyElement(reader)) {
+		const int depth = xmlTextReaderDepth(reader);
+		bool inActivities = false;
+		int ret;
+		while ((ret = xmlTextReaderRead(reader)) == 1) {
+			const int type = xmlTextReaderNodeType(reader);
+			const int nodeDepth = xmlTextReaderDepth(reader);
+			if ((type == XML_READER_TYPE_END_ELEMENT) && (nodeDepth == depth)) break;
+			if (type != XML_READER_TYPE_ELEMENT) continue;
+
+			if (nodeDepth == depth + 1) {
+				inActivities =
+				    !xmlTextReaderIsEmptyElement(reader) && isPidfReaderElement(reader, pidfRpidNs, "activities");
+				if (isPidfReaderElement(reader, pidfDataModelNs, "timestamp")) {
+					ret = readPidfReaderText(reader, text);
+					if (timestampStr.empty()) timestampStr = text;
+				} else if (isPidfReaderElement(reader, pidfDataModelNs, "note")) {
+					std::string lang = getPidfReaderAttribute(reader, "xml:lang");
+					ret = readPidfReaderText(reader, text);
+					if (!text.empty()) person->addNote(PresenceNote::create(text, lang));
+				}
+			} else if (inActivities && (nodeDepth == depth + 2)) {
+				const xmlChar *ns = xmlTextReaderConstNamespaceUri(reader);
+				if (!ns || (strcmp(reinterpret_cast<const char *>(ns), pidfRpidNs) != 0)) continue;
+				const char *name = reinterpret_cast<const char *>(xmlTextReaderConstLocalName(reader));
+				LinphonePresenceActivityType activityType;
+				if (strcmp(name, "note") == 0) {
+					std::string lang = getPidfReaderAttribute(reader, "xml:lang");
+					ret = readPidfReaderText(reader, text);
+					if (!text.empty()) person->addActivitiesNote(PresenceNote::create(text, lang));
+				} else if (PresenceActivity::activityNameToType(name, &activityType) == 0) {
+					ret = readPidfReaderText(reader, text, true);
+					person->addActivity(PresenceActivity::create(activityType, text));
+				}
+			}
+			if (ret != 1) break;
+		}
+		if (ret != 1) return ret;
+	}
+
+	// As with the XPath parser, a person without timestamp gets the one of the previous person.
+	if (!timestampStr.empty()) timestamp = PresenceModel::parseTimestamp(timestampStr);
+	person->mTimestamp = timestamp;
+	addPerson(person);
+	return 1;
+}
+
+std::shared_ptr<PresenceModel> PresenceModel::parsePidfXmlPresence(const std::string &body) {
+	xmlTextReaderPtr reader =
+	    xmlReaderForMemory(body.c_str(), (int)body.size(), nullptr, nullptr, XML_PARSE_NONET);
+	if (!reader) return nullptr;
+	xmlTextReaderSetErrorHandler(reader, pidfReaderErrorHandler, nullptr);
+
+	std::shared_ptr<PresenceModel> model = PresenceModel::create();
+	time_t personTimestamp = static_cast<time_t>(-1);
+	bool invalid = false;
+	std::string text;
+	int ret;
+	while ((ret = xmlTextReaderRead(reader)) == 1) {
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) continue;
+		const int depth = xmlTextReaderDepth(reader);
+		// Like the XPath queries, only consider the children of a pidf presence root element.
+		if ((depth == 0) && !isPidfReaderElement(reader, pidfNs, "presence")) break;
+		if (depth != 1) continue;
+
+		if (isPidfReaderElement(reader, pidfNs, "tuple")) {
+			ret = model->parsePidfXmlPresenceService(reader, invalid);
+		} else if (isPidfReaderElement(reader, pidfDataModelNs, "person")) {
+			ret = model->parsePidfXmlPresencePerson(reader, personTimestamp);
+		} else if (isPidfReaderElement(reader, pidfNs, "note")) {
+			std::string lang = getPidfReaderAttribute(reader, "xml:lang");
+			ret = readPidfReaderText(reader, text);
+			if (!text.empty()) model->mNotes.push_back(PresenceNote::create(text, lang));
+		}
+		if ((ret != 1) || invalid) break;
+	}
+	xmlFreeTextReader(reader);
+
+	if ((ret < 0) || invalid) return nullptr;
+	return model;
+}
+
 #endif /* HAVE_XML2 */
 
 // -----------------------------------------------------------------------------
@@ -616,9 +844,13 @@ void PresenceModel::parsePresence(const std::string &contentType,
 	}
 
 	std::shared_ptr<PresenceModel> model = nullptr;
-	XmlParsingContext xmlContext = XmlParsingContext(body);
-	if (xmlContext.isValid()) model = PresenceModel::parsePidfXmlPresence(xmlContext);
-	else ms_warning("Wrongly formatted presence XML: %s", xmlContext.getError().c_str());
+	if (streamingPidfParserEnabled()) {
+		model = PresenceModel::parsePidfXmlPresence(body);
+	} else {
+		XmlParsingContext xmlContext = XmlParsingContext(body);
+		if (xmlContext.isValid()) model = PresenceModel::parsePidfXmlPresence(xmlContext);
+		else ms_warning("Wrongly formatted presence XML: %s", xmlContext.getError().c_str());
+	}
 
 	*result = (SalPresenceModel *)(model ? linphone_presence_model_ref(model->toC()) : nullptr);
 }
@@ -22,6 +22,7 @@
 #define _L_PRESENCE_MODEL_H_
 
 #ifdef HAVE_XML2
+#include <libxml/xmlreader.h>
 #include <libxml/xmlwriter.h>
 #endif // HAVE_XML2
 
@@ -109,6 +110,10 @@ public:
 	bool hasCapabilityWithVersionOrMore(const LinphoneFriendCapability capability, float version) const;
 	bool isOnline() const;
 
+	// Selects the single pass PIDF parser (the default) or the XPath based one.
+	static void enableStreamingPidfParser(bool enable);
+	static bool streamingPidfParserEnabled();
+
 #ifdef HAVE_XML2
 	int parsePidfXmlPresenceNotes(XmlParsingContext &xmlContext);
 	int parsePidfXmlPresencePersons(XmlParsingContext &xmlContext);
@@ -128,6 +133,9 @@ private:
 
 #ifdef HAVE_XML2
 	static std::shared_ptr<PresenceModel> parsePidfXmlPresence(XmlParsingContext &xmlContext);
+	static std::shared_ptr<PresenceModel> parsePidfXmlPresence(const std::string &body);
+	int parsePidfXmlPresenceService(xmlTextReaderPtr reader, bool &invalid);
+	int parsePidfXmlPresencePerson(xmlTextReaderPtr reader, time_t &timestamp);
 	static int timestampToXml(xmlTextWriterPtr writer, time_t timestamp, const std::string &ns);
 #endif /* HAVE_XML2 */
 
@@ -108,7 +108,7 @@ LinphoneStatus PresencePerson::addActivity(const std::shared_ptr<PresenceActivit
 
 LinphoneStatus PresencePerson::addActivitiesNote(const std::shared_ptr<PresenceNote> &note) {
 	if (note == nullptr) return -1;
-	mNotes.insert(mActivitiesNotes.cbegin(), note);
+	mActivitiesNotes.insert(mActivitiesNotes.cbegin(), note);
 	return 0;
 }
 
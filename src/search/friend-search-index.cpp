@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2010-2022 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "account/account.h"
+#include "address/address.h"
+#include "friend/friend-list.h"
+#include "friend/friend.h"
+#include "friend-search-index.h"
+#include "linphone/api/c-account.h"
+#include "linphone/core.h"
+#include "logger/logger.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+static bool isSipUri(const string &phoneNumber) {
+	const char *c_phone_number = phoneNumber.c_str();
+	if ((strstr(c_phone_number, "sip:") == NULL) && (strstr(c_phone_number, "sips:") == NULL)) {
+		return false;
+	}
+	return (strchr(c_phone_number, '@') != NULL);
+}
+
+// Key of the trigram starting at pos, bytes past the end of str being 0.
+static uint32_t getNgramKey(const string &str, size_t pos) {
+	uint32_t key = 0;
+	for (size_t i = pos; i < pos + 3; i++) {
+		key = (key << 8) | (i < str.size() ? (unsigned char)str[i] : 0u);
+	}
+	return key;
+}
+
+static void addNgramKeys(const string &field, vector<uint32_t> &keys) {
+	for (size_t pos = 0; pos < field.size(); pos++) {
+		keys.push_back(getNgramKey(field, pos));
+	}
+}
+
+string FriendSearchIndex::toLower(const string &str) {
+	string result = str;
+	transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return tolower(c); });
+	return result;
+}
+
+void FriendSearchIndex::checkNormalizationParams(const shared_ptr<Account> &account) {
+	const auto params = account ? account->getAccountParams() : nullptr;
+	if (params != mNormalizationParams) {
+		// Phone numbers have to be normalized again with the new dial plan.
+		mEntries.clear();
+		clearNgrams();
+		mNormalizationParams = params;
+	}
+}
+
+const FriendSearchIndex::Entry &FriendSearchIndex::getEntry(const shared_ptr<Friend> &lFriend,
+                                                            const shared_ptr<Account> &account) {
+	checkNormalizationParams(account);
+	Entry &entry = mEntries[lFriend.get()];
+	if (entry.owner.lock() != lFriend || entry.revision != lFriend->mSearchRevision) {
+		fillEntry(entry, lFriend, account);
+	}
+	return entry;
+}
+
+const FriendSearchIndex::Entry &FriendSearchIndex::getEntryOf(const shared_ptr<Friend> &lFriend,
+                                                              const shared_ptr<Account> &account,
+                                                              Entry &standaloneEntry) {
+	if (lFriend->mFriendList) return lFriend->mFriendList->getSearchIndex().getEntry(lFriend, account);
+	fillEntry(standaloneEntry, lFriend, account);
+	return standaloneEntry;
+}
+
+void FriendSearchIndex::remove(const Friend *lFriend) {
+	mEntries.erase(lFriend);
+	removeNgrams(lFriend);
+	mNgramDirtyFriends.erase(lFriend);
+	mListPositions.erase(lFriend);
+}
+
+void FriendSearchIndex::clear() {
+	mEntries.clear();
+	clearNgrams();
+}
+
+size_t FriendSearchIndex::getSize() const {
+	return mEntries.size();
+}
+
+vector<shared_ptr<Friend>> FriendSearchIndex::findCandidates(const list<shared_ptr<Friend>> &friends,
+                                                             const string &lowercaseFilter,
+                                                             const shared_ptr<Account> &account) {
+	checkNormalizationParams(account);
+	if (lowercaseFilter.empty()) return vector<shared_ptr<Friend>>(friends.cbegin(), friends.cend());
+
+	if (mNgramsBuilt && mNgramOutdatedCount > mNgramLiveCount) {
+		lDebug() << "[Magic Search] Rebuilding n-gram index, " << mNgramOutdatedCount << " outdated postings";
+		clearNgrams();
+	}
+	if (!mNgramsBuilt) {
+		long long position = 0;
+		for (const auto &lFriend : friends) {
+			indexNgrams(lFriend, account);
+			mListPositions[lFriend.get()] = position++;
+		}
+		mFrontListPosition = 0;
+		mNgramsBuilt = true;
+	} else {
+		for (const auto &dirtyFriend : mNgramDirtyFriends) {
+			const auto lFriend = dirtyFriend.second.lock();
+			if (lFriend) indexNgrams(lFriend, account);
+		}
+	}
+	mNgramDirtyFriends.clear();
+
+	vector<uint32_t> ids;
+	if (lowercaseFilter.size() < 3) {
+		// Occurrences of the filter are the prefixes of a range of trigrams.
+		const uint32_t first = getNgramKey(lowercaseFilter, 0);
+		const uint32_t last = first | (lowercaseFilter.size() == 1 ? 0xffffu : 0xffu);
+		for (auto it = mNgramPostings.lower_bound(first); it != mNgramPostings.cend() && it->first <= last; ++it) {
+			ids.insert(ids.end(), it->second.cbegin(), it->second.cend());
+		}
+		sort(ids.begin(), ids.end());
+		ids.erase(unique(ids.begin(), ids.end()), ids.end());
+	} else {
+		vector<const vector<uint32_t> *> postings;
+		for (size_t pos = 0; pos + 3 <= lowercaseFilter.size(); pos++) {
+			const auto it = mNgramPostings.find(getNgramKey(lowercaseFilter, pos));
+			if (it == mNgramPostings.cend()) return vector<shared_ptr<Friend>>();
+			postings.push_back(&it->second);
+		}
+		sort(postings.begin(), postings.end(), [](const auto *l, const auto *r) { return l->size() < r->size(); });
+		// Walk the shortest posting list and look its ids up in the others.
+		for (uint32_t id : *postings.front()) {
+			if (all_of(postings.cbegin() + 1, postings.cend(),
+			           [id](const auto *posting) { return binary_search(posting->cbegin(), posting->cend(), id); })) {
+				ids.push_back(id);
+			}
+		}
+	}
+
+	// Ids follow the indexing order, which no longer matches the list order once a friend has been re-indexed: the
+	// candidates are returned in the order of the list, as the results of a scan of the list would be.
+	vector<pair<long long, shared_ptr<Friend>>> matches;
+	matches.reserve(ids.size());
+	for (uint32_t id : ids) {
+		auto lFriend = mNgramDocuments[id].owner.lock();
+		if (!lFriend) continue;
+		const auto it = mListPositions.find(lFriend.get());
+		if (it != mListPositions.cend()) matches.emplace_back(it->second, std::move(lFriend));
+	}
+	sort(matches.begin(), matches.end(), [](const auto &l, const auto &r) { return l.first < r.first; });
+	vector<shared_ptr<Friend>> candidates;
+	candidates.reserve(matches.size());
+	for (auto &match : matches) {
+		candidates.push_back(std::move(match.second));
+	}
+	return candidates;
+}
+
+void FriendSearchIndex::markDirty(const shared_ptr<Friend> &lFriend) {
+	if (mNgramsBuilt) mNgramDirtyFriends[lFriend.get()] = lFriend;
+}
+
+void FriendSearchIndex::markAddedToFront(const shared_ptr<Friend> &lFriend) {
+	if (!mNgramsBuilt) return;
+	mListPositions[lFriend.get()] = --mFrontListPosition;
+	markDirty(lFriend);
+}
+
+void FriendSearchIndex::replace(const Friend *oldFriend, const shared_ptr<Friend> &newFriend) {
+	const auto it = mListPositions.find(oldFriend);
+	const bool hasPosition = it != mListPositions.cend();
+	const long long position = hasPosition ? it->second : 0;
+	remove(oldFriend);
+	if (hasPosition) mListPositions[newFriend.get()] = position;
+	markDirty(newFriend);
+}
+
+void FriendSearchIndex::clearNgrams() {
+	mNgramsBuilt = false;
+	mNgramDocuments.clear();
+	mNgramDocumentIds.clear();
+	mNgramPostings.clear();
+	mNgramDirtyFriends.clear();
+	mListPositions.clear();
+	mFrontListPosition = 0;
+	mNgramLiveCount = 0;
+	mNgramOutdatedCount = 0;
+}
+
+void FriendSearchIndex::indexNgrams(const shared_ptr<Friend> &lFriend, const shared_ptr<Account> &account) {
+	removeNgrams(lFriend.get());
+
+	const Entry &entry = getEntry(lFriend, account);
+	vector<uint32_t> keys;
+	if (entry.hasName) addNgramKeys(entry.name, keys);
+	if (entry.hasOrganization) addNgramKeys(entry.organization, keys);
+	for (const auto &addressEntry : entry.addresses) {
+		if (addressEntry.hasUsername) addNgramKeys(addressEntry.username, keys);
+		if (addressEntry.hasDisplayName) addNgramKeys(addressEntry.displayName, keys);
+	}
+	for (const auto &numberEntry : entry.phoneNumbers) {
+		addNgramKeys(numberEntry.lowercaseNormalizedNumber, keys);
+		const LinphonePresenceModel *presence =
+		    linphone_friend_get_presence_model_for_uri_or_tel(lFriend->toC(), numberEntry.number.c_str());
+		char *contact = presence ? linphone_presence_model_get_contact(presence) : nullptr;
+		if (contact) {
+			addNgramKeys(toLower(contact), keys);
+			bctbx_free(contact);
+		}
+	}
+	sort(keys.begin(), keys.end());
+	keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+	const uint32_t id = (uint32_t)mNgramDocuments.size();
+	NgramDocument document;
+	document.owner = lFriend;
+	document.ngramCount = keys.size();
+	mNgramDocuments.push_back(document);
+	mNgramDocumentIds[lFriend.get()] = id;
+	for (uint32_t key : keys) {
+		mNgramPostings[key].push_back(id);
+	}
+	mNgramLiveCount += keys.size();
+}
+
+void FriendSearchIndex::removeNgrams(const Friend *lFriend) {
+	const auto it = mNgramDocumentIds.find(lFriend);
+	if (it == mNgramDocumentIds.cend()) return;
+	NgramDocument &document = mNgramDocuments[it->second];
+	document.owner.reset();
+	mNgramLiveCount -= document.ngramCount;
+	mNgramOutdatedCount += document.ngramCount;
+	mNgramDocumentIds.erase(it);
+}
+
+void FriendSearchIndex::fillEntry(Entry &entry, const shared_ptr<Friend> &lFriend, const shared_ptr<Account> &account) {
+	LinphoneFriend *cFriend = lFriend->toC();
+	entry = Entry();
+	entry.owner = lFriend;
+	entry.revision = lFriend->mSearchRevision;
+
+	if (linphone_core_vcard_supported()) {
+		LinphoneVcard *vcard = linphone_friend_get_vcard(cFriend);
+		if (vcard) {
+			const char *name = linphone_vcard_get_full_name(vcard);
+			if (name) {
+				entry.hasName = true;
+				entry.name = toLower(name);
+			}
+			const char *organization = linphone_vcard_get_organization(vcard);
+			if (organization) {
+				entry.hasOrganization = true;
+				entry.organization = toLower(organization);
+			}
+		}
+	}
+
+	for (const bctbx_list_t *elem = linphone_friend_get_addresses(cFriend); elem && elem->data; elem = elem->next) {
+		const LinphoneAddress *lAddress = static_cast<LinphoneAddress *>(elem->data);
+		AddressEntry addressEntry;
+		addressEntry.address = Address::toCpp(lAddress)->getSharedFromThis();
+		const char *username = linphone_address_get_username(lAddress);
+		if (username) {
+			addressEntry.hasUsername = true;
+			addressEntry.username = toLower(username);
+		}
+		const char *displayName = linphone_address_get_display_name(lAddress);
+		if (displayName) {
+			addressEntry.hasDisplayName = true;
+			addressEntry.displayName = toLower(displayName);
+		}
+		entry.addresses.push_back(std::move(addressEntry));
+	}
+
+	bctbx_list_t *phoneNumbers = linphone_friend_get_phone_numbers(cFriend);
+	for (const bctbx_list_t *elem = phoneNumbers; elem && elem->data; elem = elem->next) {
+		PhoneNumberEntry numberEntry;
+		numberEntry.number = static_cast<const char *>(elem->data);
+		numberEntry.normalizedNumber = numberEntry.number;
+		if (account) {
+			char *normalized = linphone_account_normalize_phone_number(account->toC(), numberEntry.number.c_str());
+			if (normalized) {
+				numberEntry.normalizedNumber = normalized;
+				bctbx_free(normalized);
+			}
+		}
+		numberEntry.lowercaseNormalizedNumber = toLower(numberEntry.normalizedNumber);
+		// Will prevent warning & error logs due to parsing failure
+		if (isSipUri(numberEntry.normalizedNumber)) {
+			numberEntry.sipAddress = Address::create(numberEntry.normalizedNumber);
+		}
+		entry.phoneNumbers.push_back(std::move(numberEntry));
+	}
+	if (phoneNumbers) bctbx_list_free_with_data(phoneNumbers, bctbx_free);
+}
+
+LINPHONE_END_NAMESPACE
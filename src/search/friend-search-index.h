@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2010-2022 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone
+ * (see https://gitlab.linphone.org/BC/public/liblinphone).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_FRIEND_SEARCH_INDEX_H_
+#define _L_FRIEND_SEARCH_INDEX_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+class Account;
+class AccountParams;
+class Address;
+class Friend;
+
+/**
+ * Searchable data of the friends of a FriendList, prepared once for MagicSearch: names are lowercased and phone
+ * numbers normalized with the dial plan of the default account. An entry is rebuilt when its friend has been
+ * modified since it was computed, or when the default account parameters change.
+ *
+ * An optional inverted index of the trigrams of these fields, built on the first call to findCandidates(), narrows a
+ * substring search to the friends that may match before they are weighted. Fields are padded so that every substring
+ * of one or two characters is the prefix of a trigram: shorter filters are answered from a range of trigrams.
+ */
+class FriendSearchIndex {
+public:
+	struct AddressEntry {
+		std::shared_ptr<Address> address;
+		bool hasUsername = false;
+		std::string username;
+		bool hasDisplayName = false;
+		std::string displayName;
+	};
+
+	struct PhoneNumberEntry {
+		std::string number; // As stored in the friend, for presence lookups.
+		std::string normalizedNumber;
+		std::string lowercaseNormalizedNumber;
+		std::shared_ptr<Address> sipAddress; // When the phone number field holds a SIP URI.
+	};
+
+	struct Entry {
+		std::weak_ptr<Friend> owner;
+		unsigned int revision = 0;
+		bool hasName = false;
+		std::string name;
+		bool hasOrganization = false;
+		std::string organization;
+		std::vector<AddressEntry> addresses;
+		std::vector<PhoneNumberEntry> phoneNumbers;
+	};
+
+	const Entry &getEntry(const std::shared_ptr<Friend> &lFriend, const std::shared_ptr<Account> &account);
+	// Entry from the index of the friend list of lFriend, or computed in standaloneEntry if it is in no list.
+	static const Entry &
+	getEntryOf(const std::shared_ptr<Friend> &lFriend, const std::shared_ptr<Account> &account, Entry &standaloneEntry);
+	void remove(const Friend *lFriend);
+	void clear();
+	size_t getSize() const;
+
+	// Friends among `friends` (the content of the friend list) whose searchable fields may contain lowercaseFilter.
+	std::vector<std::shared_ptr<Friend>> findCandidates(const std::list<std::shared_ptr<Friend>> &friends,
+	                                                    const std::string &lowercaseFilter,
+	                                                    const std::shared_ptr<Account> &account);
+	// Schedules the friend to be indexed again by the next findCandidates() call.
+	void markDirty(const std::shared_ptr<Friend> &lFriend);
+	// Same as markDirty() for a friend that has just been put at the front of the friend list.
+	void markAddedToFront(const std::shared_ptr<Friend> &lFriend);
+	// Same as remove(oldFriend) and markDirty(newFriend) for a friend that newFriend replaced in the friend list.
+	void replace(const Friend *oldFriend, const std::shared_ptr<Friend> &newFriend);
+
+	static std::string toLower(const std::string &str);
+
+private:
+	struct NgramDocument {
+		std::weak_ptr<Friend> owner; // Reset once the document is outdated.
+		size_t ngramCount = 0;
+	};
+
+	static void
+	fillEntry(Entry &entry, const std::shared_ptr<Friend> &lFriend, const std::shared_ptr<Account> &account);
+	void checkNormalizationParams(const std::shared_ptr<Account> &account);
+	void clearNgrams();
+	void indexNgrams(const std::shared_ptr<Friend> &lFriend, const std::shared_ptr<Account> &account);
+	void removeNgrams(const Friend *lFriend);
+
+	std::unordered_map<const Friend *, Entry> mEntries;
+	// Parameters of the account the phone numbers were normalized with.
+	std::shared_ptr<const AccountParams> mNormalizationParams;
+
+	bool mNgramsBuilt = false;
+	// A friend is given a new document id each time it is indexed, so that posting lists stay sorted by only appending
+	// to them. Outdated ids are skipped by lookups and dropped when the index is rebuilt.
+	std::vector<NgramDocument> mNgramDocuments;
+	std::unordered_map<const Friend *, uint32_t> mNgramDocumentIds;
+	std::map<uint32_t, std::vector<uint32_t>> mNgramPostings;
+	std::unordered_map<const Friend *, std::weak_ptr<Friend>> mNgramDirtyFriends;
+	// Positions of the friends in the friend list, in increasing order from its front, so that candidates are sorted
+	// without walking the list. Friends put at the front are given decreasing positions.
+	std::unordered_map<const Friend *, long long> mListPositions;
+	long long mFrontListPosition = 0;
+	size_t mNgramLiveCount = 0;
+	size_t mNgramOutdatedCount = 0;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_FRIEND_SEARCH_INDEX_H_
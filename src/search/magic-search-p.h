@@ -39,6 +39,9 @@ private:
 	bool mUseDelimiter = true;
 	std::string mFilter;
 	bool mAutoResetCache = true; // When a new search start, let MagicSearch to clean its cache
+	bool mUseNgramIndex = false;
+	bool mNotifyPartialResults = false;
+	bool mLastSearchPartial = false;
 
 	belle_sip_source_t *mIteration = nullptr;
 
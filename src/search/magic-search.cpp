@@ -19,6 +19,8 @@
  */
 
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 #include "bctoolbox/defs.h"
 #include <bctoolbox/list.h>
@@ -131,6 +133,31 @@ void MagicSearch::setLimitedSearch(const bool limited) {
 	d->mLimitedSearch = limited;
 }
 
+bool MagicSearch::getUseNgramIndex() const {
+	L_D();
+	return d->mUseNgramIndex;
+}
+
+void MagicSearch::setUseNgramIndex(bool enable) {
+	L_D();
+	d->mUseNgramIndex = enable;
+}
+
+bool MagicSearch::getNotifyPartialResults() const {
+	L_D();
+	return d->mNotifyPartialResults;
+}
+
+void MagicSearch::setNotifyPartialResults(bool enable) {
+	L_D();
+	d->mNotifyPartialResults = enable;
+}
+
+bool MagicSearch::isLastSearchPartial() const {
+	L_D();
+	return d->mLastSearchPartial;
+}
+
 void MagicSearch::resetSearchCache() {
 	L_D();
 	if (d->mCacheResult) {
@@ -168,13 +195,25 @@ bool MagicSearch::iterate(void) {
 		d->mAsyncData.initStartTime();
 	}
 	if (mState == STATE_WAIT) {
-		if (getAddressIsEndAsync(&d->mAsyncData)) {
-			mergeResults(request, &d->mAsyncData);
+		// Results are merged as soon as their provider ends, so that the slowest one only delays the last of them.
+		bool ended = getAddressIsEndAsync(&d->mAsyncData);
+		bool merged = d->mAsyncData.mergeProviderResults();
+		if (ended) {
 			mState = STATE_SEND;
+		} else if (merged && d->mNotifyPartialResults) {
+			// Notify copies: the merged results may still be completed by the pending providers.
+			auto partialResults = std::make_shared<list<std::shared_ptr<SearchResult>>>();
+			for (const auto &result : *d->mAsyncData.mSearchResults) {
+				partialResults->push_back(result->clone()->toSharedPtr());
+			}
+			d->mLastSearchPartial = true;
+			processResults(partialResults);
+			_linphone_magic_search_notify_search_results_received(L_GET_C_BACK_PTR(this));
 		}
 	}
 	if (mState == STATE_SEND || mState == STATE_CANCEL) {
 		if (mState == STATE_SEND) {
+			d->mLastSearchPartial = false;
 			processResults(d->mAsyncData.mSearchResults);
 			_linphone_magic_search_notify_search_results_received(L_GET_C_BACK_PTR(this));
 #ifdef LDAP_ENABLED
@@ -264,66 +303,122 @@ static int compareStringItems(const char *a, const char *b) {
 	return strcasecmp(a, b);
 }
 
-static void sortResultsList(std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList) {
-	lDebug() << "[Magic Search] Sorting " << resultList->size() << " results";
-	resultList->sort([](const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
-		const char *name1 = lsr->getDisplayName();
-		const char *name2 = rsr->getDisplayName();
-		int nameComp = compareStringItems(name1, name2);
-
-		// Check in order: Friend's display name, address username, address domain, phone number
-		if (nameComp == 0) {
-			if (lsr->getAddress() && rsr->getAddress()) {
-				const auto lsrAddress = lsr->getAddress();
-				const auto rsrAddress = rsr->getAddress();
-				int usernameComp =
-				    compareStringItems(lsrAddress->getUsername().c_str(), rsrAddress->getUsername().c_str());
-				if (usernameComp == 0) {
-					int domainComp =
-					    compareStringItems(lsrAddress->getDomain().c_str(), rsrAddress->getDomain().c_str());
-					if (domainComp == 0) {
-						if (!lsr->getPhoneNumber().empty() && !rsr->getPhoneNumber().empty()) {
-							int phoneComp = strcmp(lsr->getPhoneNumber().c_str(), rsr->getPhoneNumber().c_str());
-							if (phoneComp == 0) {
-								return true;
-							} else {
-								return phoneComp < 0;
-							}
-						}
-					} else {
-						return domainComp < 0;
+static bool compareResults(const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
+	bool sip_addresses = false;
+	const auto left = lsr->getAddress();
+	const auto right = rsr->getAddress();
+	if (left == nullptr && right == nullptr) {
+		sip_addresses = true;
+	} else if (left != nullptr && right != nullptr) {
+		sip_addresses = left->weakEqual(*right);
+	}
+	return sip_addresses && lsr->getCapabilities() == rsr->getCapabilities() &&
+	       lsr->getPhoneNumber() == rsr->getPhoneNumber() &&
+	       (compareStringItems(lsr->getDisplayName(), rsr->getDisplayName()) == 0);
+}
+
+static bool compareResultsFriend(const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
+	auto leftFriend = lsr->getFriend();
+	auto rightFriend = rsr->getFriend();
+	if (leftFriend == nullptr && rightFriend == nullptr) {
+		// Fall back to generic unique
+		return compareResults(lsr, rsr);
+	}
+	return leftFriend == rightFriend;
+}
+
+// Check in order: Friend's display name, address username, address domain, phone number
+static bool isResultBefore(const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
+	const char *name1 = lsr->getDisplayName();
+	const char *name2 = rsr->getDisplayName();
+	int nameComp = compareStringItems(name1, name2);
+
+	if (nameComp == 0) {
+		if (lsr->getAddress() && rsr->getAddress()) {
+			const auto lsrAddress = lsr->getAddress();
+			const auto rsrAddress = rsr->getAddress();
+			int usernameComp = compareStringItems(lsrAddress->getUsername().c_str(), rsrAddress->getUsername().c_str());
+			if (usernameComp == 0) {
+				int domainComp = compareStringItems(lsrAddress->getDomain().c_str(), rsrAddress->getDomain().c_str());
+				if (domainComp == 0) {
+					if (!lsr->getPhoneNumber().empty() && !rsr->getPhoneNumber().empty()) {
+						return strcmp(lsr->getPhoneNumber().c_str(), rsr->getPhoneNumber().c_str()) < 0;
 					}
 				} else {
-					return usernameComp < 0;
+					return domainComp < 0;
 				}
+			} else {
+				return usernameComp < 0;
 			}
 		}
+	}
 
-		return nameComp < 0;
-	});
+	return nameComp < 0;
+}
+
+static bool isResultFriendBefore(const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
+	const char *name1 = linphone_friend_get_name(lsr->getFriend());
+	if (name1 == nullptr) {
+		name1 = lsr->getAddress()->getUsernameCstr();
+	}
+	const char *name2 = linphone_friend_get_name(rsr->getFriend());
+	if (name2 == nullptr) {
+		name2 = rsr->getAddress()->getUsernameCstr();
+	}
+	int nameComp = compareStringItems(name1, name2);
+	return nameComp < 0;
+}
+
+static void sortResultsList(std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList) {
+	lDebug() << "[Magic Search] Sorting " << resultList->size() << " results";
+	resultList->sort(isResultBefore);
 }
 
 static void sortResultsByFriendInList(std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList) {
 	lDebug() << "[Magic Search] Sorting " << resultList->size() << " results by Friend";
-	resultList->sort([](const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
-		const char *name1 = linphone_friend_get_name(lsr->getFriend());
-		if (name1 == nullptr) {
-			name1 = lsr->getAddress()->getUsernameCstr();
-		}
-		const char *name2 = linphone_friend_get_name(rsr->getFriend());
-		if (name2 == nullptr) {
-			name2 = rsr->getAddress()->getUsernameCstr();
-		}
-		int nameComp = compareStringItems(name1, name2);
-		return nameComp < 0;
-	});
+	resultList->sort(isResultFriendBefore);
+}
+
+// Keeps the first `limit` results of resultList once sorted with `before` and made unique with `equal`. Only these
+// results are ordered, by popping them from a heap, instead of sorting the whole list. Results that `before` does not
+// order are popped in their list order, so that the selection is the one list::sort(), which is stable, would give.
+template <typename Before, typename Equal>
+static void
+selectFirstResults(list<std::shared_ptr<SearchResult>> &resultList, size_t limit, Before before, Equal equal) {
+	lDebug() << "[Magic Search] Selecting the first " << limit << " of " << resultList.size() << " results";
+	using RankedResult = pair<size_t, std::shared_ptr<SearchResult>>;
+	vector<RankedResult> heap;
+	heap.reserve(resultList.size());
+	for (auto &result : resultList)
+		heap.emplace_back(heap.size(), std::move(result));
+	resultList.clear();
+	auto after = [&before](const RankedResult &lsr, const RankedResult &rsr) {
+		if (before(rsr.second, lsr.second)) return true;
+		if (before(lsr.second, rsr.second)) return false;
+		return rsr.first < lsr.first;
+	};
+	make_heap(heap.begin(), heap.end(), after);
+	while (!heap.empty() && resultList.size() < limit) {
+		pop_heap(heap.begin(), heap.end(), after);
+		auto &result = heap.back().second;
+		if (resultList.empty() || !equal(resultList.back(), result)) resultList.push_back(std::move(result));
+		heap.pop_back();
+	}
 }
 
 list<std::shared_ptr<SearchResult>>
 MagicSearch::processResults(std::shared_ptr<list<std::shared_ptr<SearchResult>>> pResultList) {
 	L_D();
 
-	if (d->mAsyncData.mSearchRequest.getAggregation() == LinphoneMagicSearchAggregationFriend) {
+	const bool aggregateFriends = d->mAsyncData.mSearchRequest.getAggregation() == LinphoneMagicSearchAggregationFriend;
+	if (getLimitedSearch() && d->mAutoResetCache) {
+		// The cache is not used to refine the next search: only the results returned by getLastSearch() are needed.
+		if (aggregateFriends) {
+			selectFirstResults(*pResultList, getSearchLimit(), isResultFriendBefore, compareResultsFriend);
+		} else {
+			selectFirstResults(*pResultList, getSearchLimit(), isResultBefore, compareResults);
+		}
+	} else if (aggregateFriends) {
 		sortResultsByFriendInList(pResultList);
 		uniqueFriendsInList(pResultList);
 	} else {
@@ -551,6 +646,38 @@ list<std::shared_ptr<SearchResult>> MagicSearch::getAddressFromConferencesInfo(
 	return resultList;
 }
 
+list<std::shared_ptr<SearchResult>>
+MagicSearch::getAddressFromFriends(const string &filter, const string &withDomain, bool starredOnly) const {
+	L_D();
+	list<std::shared_ptr<SearchResult>> resultList;
+	const auto account = getCore()->getDefaultAccount();
+	const string lowercaseFilter = FriendSearchIndex::toLower(filter);
+	// With a non zero minimum weight, friends that do not contain the filter may still be results.
+	const bool useNgramIndex = d->mUseNgramIndex && getMinWeight() == 0;
+	const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
+	for (const bctbx_list_t *fl = friend_lists; fl != nullptr; fl = bctbx_list_next(fl)) {
+		const auto friendList = FriendList::toCpp(static_cast<LinphoneFriendList *>(fl->data));
+		FriendSearchIndex &index = friendList->getSearchIndex();
+		const std::list<std::shared_ptr<Friend>> &friends = friendList->getFriends();
+		auto searchIn = [&](const std::shared_ptr<Friend> &lFriend) {
+			if (starredOnly && !lFriend->getStarred()) return;
+			list<std::shared_ptr<SearchResult>> fResults =
+			    searchInFriend(lFriend->toC(), index.getEntry(lFriend, account), lowercaseFilter, withDomain);
+			addResultsToResultsList(fResults, resultList);
+		};
+		if (useNgramIndex) {
+			for (const auto &lFriend : index.findCandidates(friends, lowercaseFilter, account)) {
+				searchIn(lFriend);
+			}
+		} else {
+			for (const auto &lFriend : friends) {
+				searchIn(lFriend);
+			}
+		}
+	}
+	return resultList;
+}
+
 #ifdef LDAP_ENABLED
 void MagicSearch::getAddressFromLDAPServerStartAsync(const string &filter,
                                                      const string &withDomain,
@@ -589,7 +716,10 @@ bool MagicSearch::getAddressIsEndAsync(SearchAsyncData *asyncData) const {
 		auto data = asyncData->getData()[i];
 		bctbx_timespec_add(&timeout, data->mTimeout);
 		if (data->mEnd || bctbx_timespec_compare(&currentTime, &timeout) > 0) {
-			if (!data->mEnd) data->cancel();
+			if (!data->mEnd) {
+				data->cancel();
+				data->mEnd = TRUE;
+			}
 			++endCount;
 		}
 	}
@@ -626,20 +756,8 @@ void MagicSearch::beginNewSearchAsync(const SearchRequest &request, SearchAsyncD
 	bool checkFavoriteFriends = (request.getSourceFlags() & LinphoneMagicSearchSourceFavoriteFriends) ==
 	                            LinphoneMagicSearchSourceFavoriteFriends;
 	if (checkFriends || checkFavoriteFriends) {
-		const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
-		list<std::shared_ptr<SearchResult>> friendsList;
-		for (const bctbx_list_t *fl = friend_lists; fl != nullptr; fl = bctbx_list_next(fl)) {
-			LinphoneFriendList *fList = static_cast<LinphoneFriendList *>(fl->data);
-			// For all friends or when we reach the search limit
-			const std::list<std::shared_ptr<Friend>> friends = FriendList::toCpp(fList)->getFriends();
-			for (const auto &lFriend : friends) {
-				if (checkFriends || lFriend->getStarred()) {
-					list<std::shared_ptr<SearchResult>> fResults =
-					    searchInFriend(lFriend->toC(), request.getFilter(), request.getWithDomain());
-					addResultsToResultsList(fResults, friendsList);
-				}
-			}
-		}
+		list<std::shared_ptr<SearchResult>> friendsList =
+		    getAddressFromFriends(request.getFilter(), request.getWithDomain(), !checkFriends);
 		lInfo() << "[Magic Search] Found " << friendsList.size() << " results in friends";
 		asyncData->createResult(friendsList);
 	}
@@ -660,15 +778,6 @@ void MagicSearch::beginNewSearchAsync(const SearchRequest &request, SearchAsyncD
 		                                                      list<std::shared_ptr<SearchResult>>()));
 }
 
-void MagicSearch::mergeResults(const SearchRequest &request, SearchAsyncData *asyncData) {
-	std::shared_ptr<list<std::shared_ptr<SearchResult>>> resultList =
-	    std::make_shared<list<std::shared_ptr<SearchResult>>>();
-	for (auto it = asyncData->mProviderResults.begin(); it != asyncData->mProviderResults.end(); ++it) {
-		addResultsToResultsList(*it, *resultList, request.getFilter(), request.getWithDomain());
-	}
-	asyncData->setSearchResults(resultList);
-}
-
 std::shared_ptr<list<std::shared_ptr<SearchResult>>>
 MagicSearch::beginNewSearch(const string &filter, const string &withDomain, int sourceFlags) {
 	list<std::shared_ptr<SearchResult>> clResults, crResults;
@@ -680,18 +789,8 @@ MagicSearch::beginNewSearch(const string &filter, const string &withDomain, int
 	bool checkFavoriteFriends =
 	    (sourceFlags & LinphoneMagicSearchSourceFavoriteFriends) == LinphoneMagicSearchSourceFavoriteFriends;
 	if (checkFriends || checkFavoriteFriends) {
-		const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
-		for (const bctbx_list_t *fl = friend_lists; fl != nullptr; fl = bctbx_list_next(fl)) {
-			LinphoneFriendList *fList = static_cast<LinphoneFriendList *>(fl->data);
-			// For all friends or when we reach the search limit
-			const std::list<std::shared_ptr<Friend>> friends = FriendList::toCpp(fList)->getFriends();
-			for (const auto &lFriend : friends) {
-				if (checkFriends || lFriend->getStarred()) {
-					list<std::shared_ptr<SearchResult>> fResults = searchInFriend(lFriend->toC(), filter, withDomain);
-					addResultsToResultsList(fResults, *resultList);
-				}
-			}
-		}
+		list<std::shared_ptr<SearchResult>> fResults = getAddressFromFriends(filter, withDomain, !checkFriends);
+		addResultsToResultsList(fResults, *resultList);
 	}
 #ifdef LDAP_ENABLED
 	if ((sourceFlags & LinphoneMagicSearchSourceLdapServers) == LinphoneMagicSearchSourceLdapServers &&
@@ -743,18 +842,19 @@ std::shared_ptr<list<std::shared_ptr<SearchResult>>> MagicSearch::continueSearch
 	return resultList;
 }
 
-static bool isSipUri(const std::string &phoneNumber) {
-	const char *c_phone_number = phoneNumber.c_str();
-	if ((strstr(c_phone_number, "sip:") == NULL) && (strstr(c_phone_number, "sips:") == NULL)) {
-		return false;
-	}
-	return (strchr(c_phone_number, '@') != NULL);
-}
-
 list<std::shared_ptr<SearchResult>>
 MagicSearch::searchInFriend(LinphoneFriend *lFriend, const string &filter, const string &withDomain) const {
+	FriendSearchIndex::Entry standaloneEntry;
+	const auto &entry = FriendSearchIndex::getEntryOf(Friend::toCpp(lFriend)->getSharedFromThis(),
+	                                                  getCore()->getDefaultAccount(), standaloneEntry);
+	return searchInFriend(lFriend, entry, FriendSearchIndex::toLower(filter), withDomain);
+}
+
+list<std::shared_ptr<SearchResult>> MagicSearch::searchInFriend(LinphoneFriend *lFriend,
+                                                                const FriendSearchIndex::Entry &entry,
+                                                                const string &lowercaseFilter,
+                                                                const string &withDomain) const {
 	list<std::shared_ptr<SearchResult>> friendResult;
-	string phoneNumber = "";
 	unsigned int weight = getMinWeight();
 	int flags = LinphoneMagicSearchSourceFriends;
 	bool isStarred = linphone_friend_get_starred(lFriend);
@@ -763,57 +863,43 @@ MagicSearch::searchInFriend(LinphoneFriend *lFriend, const string &filter, const
 	}
 
 	// NAME & ORGANIZATION
-	if (linphone_core_vcard_supported()) {
-		if (linphone_friend_get_vcard(lFriend)) {
-			const char *name = linphone_vcard_get_full_name(linphone_friend_get_vcard(lFriend));
-			if (name) {
-				weight += getWeight(name, filter) * 3;
-			}
-			if (weight == getMinWeight()) {
-				// If name doesn't match filter, check if organization does
-				const char *organization = linphone_vcard_get_organization(linphone_friend_get_vcard(lFriend));
-				if (organization) {
-					weight += getWeight(organization, filter) * 2;
-				}
-			}
-		}
+	if (entry.hasName) {
+		weight += getLowercaseWeight(entry.name, lowercaseFilter) * 3;
+	}
+	if (weight == getMinWeight() && entry.hasOrganization) {
+		// If name doesn't match filter, check if organization does
+		weight += getLowercaseWeight(entry.organization, lowercaseFilter) * 2;
 	}
 
 	// SIP URI
-	for (const bctbx_list_t *listAddress = linphone_friend_get_addresses(lFriend);
-	     listAddress != nullptr && listAddress->data != nullptr; listAddress = listAddress->next) {
-		const LinphoneAddress *lAddress = static_cast<LinphoneAddress *>(listAddress->data);
+	for (const auto &addressEntry : entry.addresses) {
+		const LinphoneAddress *lAddress = addressEntry.address->toC();
 		if (!checkDomain(lFriend, lAddress, withDomain)) {
 			if (!withDomain.empty()) {
 				continue;
 			}
 		}
 
-		unsigned int weightAddress = searchInAddress(lAddress, filter, withDomain) * 1;
+		unsigned int weightAddress = getMinWeight();
+		if (checkDomain(nullptr, lAddress, withDomain)) {
+			if (addressEntry.hasUsername) weightAddress += getLowercaseWeight(addressEntry.username, lowercaseFilter);
+			if (addressEntry.hasDisplayName) {
+				weightAddress += getLowercaseWeight(addressEntry.displayName, lowercaseFilter);
+			}
+		}
 
 		if ((weightAddress + weight) > getMinWeight()) {
-			friendResult.push_back(SearchResult::create(
-			    weight + weightAddress, Address::toCpp(lAddress)->getSharedFromThis(), phoneNumber, lFriend, flags));
+			friendResult.push_back(
+			    SearchResult::create(weight + weightAddress, addressEntry.address, "", lFriend, flags));
 		}
 	}
 
 	// PHONE NUMBER
-	const auto &account = getCore()->getDefaultAccount();
-	bctbx_list_t *begin, *phoneNumbers = linphone_friend_get_phone_numbers(lFriend);
-	begin = phoneNumbers;
-	while (phoneNumbers && phoneNumbers->data) {
-		string number = static_cast<const char *>(phoneNumbers->data);
+	for (const auto &numberEntry : entry.phoneNumbers) {
 		const LinphonePresenceModel *presence =
-		    linphone_friend_get_presence_model_for_uri_or_tel(lFriend, number.c_str());
-		phoneNumber = number;
-		if (account) {
-			char *buff = linphone_account_normalize_phone_number(account->toC(), phoneNumber.c_str());
-			if (buff) {
-				phoneNumber = buff;
-				bctbx_free(buff);
-			}
-		}
-		unsigned int weightNumber = getWeight(phoneNumber.c_str(), filter);
+		    linphone_friend_get_presence_model_for_uri_or_tel(lFriend, numberEntry.number.c_str());
+		const string &phoneNumber = numberEntry.normalizedNumber;
+		unsigned int weightNumber = getLowercaseWeight(numberEntry.lowercaseNormalizedNumber, lowercaseFilter);
 		if (presence) {
 			char *contact = linphone_presence_model_get_contact(presence);
 			if (contact) {
@@ -821,20 +907,17 @@ MagicSearch::searchInFriend(LinphoneFriend *lFriend, const string &filter, const
 				if (tmpAdd) {
 					if (withDomain.empty() || withDomain == "*" ||
 					    compareStringItems(L_STRING_TO_C(tmpAdd->getDomain()), withDomain.c_str()) == 0) {
-						weightNumber += getWeight(contact, filter) * 2;
+						weightNumber += getLowercaseWeight(FriendSearchIndex::toLower(contact), lowercaseFilter) * 2;
 						if ((weightNumber + weight) > getMinWeight()) {
 							friendResult.push_back(
 							    SearchResult::create(weight + weightNumber, tmpAdd, phoneNumber, lFriend, flags));
 						}
-						bctbx_free(contact);
 					}
 				}
+				bctbx_free(contact);
 			}
 		} else {
-			std::shared_ptr<Address> tmpAdd = nullptr;
-			if (isSipUri(phoneNumber)) { // Will prevent warning & error logs due to parsing failure
-				tmpAdd = Address::create(phoneNumber);
-			}
+			const std::shared_ptr<Address> &tmpAdd = numberEntry.sipAddress;
 			if ((weightNumber + weight) > getMinWeight() &&
 			    (withDomain.empty() ||
 			     (tmpAdd != nullptr && compareStringItems(L_STRING_TO_C(tmpAdd->getDomain()), withDomain.c_str()) ==
@@ -844,9 +927,7 @@ MagicSearch::searchInFriend(LinphoneFriend *lFriend, const string &filter, const
 				    SearchResult::create(weight + weightNumber, tmpAdd, phoneNumber, lFriend, flags));
 			}
 		}
-		phoneNumbers = phoneNumbers->next;
 	}
-	if (begin) bctbx_list_free_with_data(begin, bctbx_free);
 
 	return friendResult;
 }
@@ -868,15 +949,11 @@ MagicSearch::searchInAddress(const LinphoneAddress *lAddress, const string &filt
 }
 
 unsigned int MagicSearch::getWeight(const string &stringWords, const string &filter) const {
-	locale loc;
-	setlocale(LC_ALL, "");
-	string filterLC = filter;
-	string stringWordsLC = stringWords;
-	size_t weight = string::npos;
+	return getLowercaseWeight(FriendSearchIndex::toLower(stringWords), FriendSearchIndex::toLower(filter));
+}
 
-	transform(stringWordsLC.begin(), stringWordsLC.end(), stringWordsLC.begin(),
-	          [](unsigned char c) { return tolower(c); });
-	transform(filterLC.begin(), filterLC.end(), filterLC.begin(), [](unsigned char c) { return tolower(c); });
+unsigned int MagicSearch::getLowercaseWeight(const string &stringWordsLC, const string &filterLC) const {
+	size_t weight = string::npos;
 
 	// Finding all occurrences of "filterLC" in "stringWordsLC"
 	for (size_t w = stringWordsLC.find(filterLC); w != string::npos;
@@ -912,6 +989,8 @@ bool MagicSearch::checkDomain(const LinphoneFriend *lFriend,
                               const LinphoneAddress *lAddress,
                               const string &withDomain) const {
 	bool onlyOneDomain = !withDomain.empty() && withDomain != "*";
+	if (!onlyOneDomain) return true;
+
 	char *addr = linphone_address_as_string_uri_only(lAddress);
 	const LinphonePresenceModel *presenceModel =
 	    lFriend ? linphone_friend_get_presence_model_for_uri_or_tel(lFriend, addr) : nullptr;
@@ -966,39 +1045,15 @@ void MagicSearch::addResultsToResultsList(std::list<std::shared_ptr<SearchResult
 	}
 }
 
-static bool compareResults(const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
-	bool sip_addresses = false;
-	const auto left = lsr->getAddress();
-	const auto right = rsr->getAddress();
-	if (left == nullptr && right == nullptr) {
-		sip_addresses = true;
-	} else if (left != nullptr && right != nullptr) {
-		sip_addresses = left->weakEqual(*right);
-	}
-	return sip_addresses && lsr->getCapabilities() == rsr->getCapabilities() &&
-	       lsr->getPhoneNumber() == rsr->getPhoneNumber() &&
-	       (compareStringItems(lsr->getDisplayName(), rsr->getDisplayName()) == 0);
-}
-
 void MagicSearch::uniqueItemsList(std::shared_ptr<list<std::shared_ptr<SearchResult>>> list) const {
 	lDebug() << "[Magic Search] List size before unique = " << list->size();
-	list->unique([](const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
-		return compareResults(lsr, rsr);
-	});
+	list->unique(compareResults);
 	lDebug() << "[Magic Search] List size after unique = " << list->size();
 }
 
 void MagicSearch::uniqueFriendsInList(std::shared_ptr<list<std::shared_ptr<SearchResult>>> list) const {
 	lDebug() << "[Magic Search] List size before friend unique = " << list->size();
-	list->unique([](const std::shared_ptr<SearchResult> &lsr, const std::shared_ptr<SearchResult> &rsr) {
-		auto leftFriend = lsr->getFriend();
-		auto rightFriend = rsr->getFriend();
-		if (leftFriend == nullptr && rightFriend == nullptr) {
-			// Fall back to generic unique
-			return compareResults(lsr, rsr);
-		}
-		return leftFriend == rightFriend;
-	});
+	list->unique(compareResultsFriend);
 	lDebug() << "[Magic Search] List size after friend unique = " << list->size();
 }
 
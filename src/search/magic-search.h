@@ -28,6 +28,7 @@
 
 #include "core/core-accessor.h"
 #include "core/core.h"
+#include "friend-search-index.h"
 #include "search-request.h"
 #include "search-result.h"
 
@@ -109,6 +110,34 @@ public:
 	 **/
 	void setLimitedSearch(const bool limited);
 
+	/**
+	 * @return if friends are looked up through the n-gram index of their friend list
+	 **/
+	bool getUseNgramIndex() const;
+
+	/**
+	 * Enable or disable the n-gram index: only the friends whose fields may contain the filter are weighted
+	 * @param[in] enable
+	 **/
+	void setUseNgramIndex(bool enable);
+
+	/**
+	 * @return if the asynchronous search notifies the results of the providers that have ended while others are
+	 * still running
+	 **/
+	bool getNotifyPartialResults() const;
+
+	/**
+	 * Enable or disable the notification of partial results by the asynchronous search
+	 * @param[in] enable
+	 **/
+	void setNotifyPartialResults(bool enable);
+
+	/**
+	 * @return if the results returned by getLastSearch() are partial: some providers have not answered yet
+	 **/
+	bool isLastSearchPartial() const;
+
 	/**
 	 * Reset the cache to begin a new search
 	 **/
@@ -216,6 +245,17 @@ private:
 	                              const std::string &withDomain,
 	                              const std::list<std::shared_ptr<SearchResult>> &currentList) const;
 
+	/**
+	 * Get all addresses and phone numbers from friends
+	 * @param[in] filter word we search
+	 * @param[in] withDomain domain which we want to search only
+	 * @param[in] starredOnly only search in favorite friends
+	 * @return all addresses and phone numbers of friends which match in a SearchResult list
+	 * @private
+	 **/
+	std::list<std::shared_ptr<SearchResult>>
+	getAddressFromFriends(const std::string &filter, const std::string &withDomain, bool starredOnly) const;
+
 #ifdef LDAP_ENABLED
 	/**
 	 * Get all addresses from LDAP Server
@@ -266,6 +306,17 @@ private:
 	std::list<std::shared_ptr<SearchResult>>
 	searchInFriend(LinphoneFriend *lFriend, const std::string &filter, const std::string &withDomain) const;
 
+	/**
+	 * Same as searchInFriend() on the prepared data of the friend
+	 * @param[in] entry search data of the friend, from its friend list index
+	 * @param[in] lowercaseFilter lowercased word we search
+	 * @private
+	 **/
+	std::list<std::shared_ptr<SearchResult>> searchInFriend(LinphoneFriend *lFriend,
+	                                                        const FriendSearchIndex::Entry &entry,
+	                                                        const std::string &lowercaseFilter,
+	                                                        const std::string &withDomain) const;
+
 	/**
 	 * Search informations in address given
 	 * @param[in] lAddress address whose informations will be check
@@ -285,6 +336,12 @@ private:
 	 **/
 	unsigned int getWeight(const std::string &stringWords, const std::string &filter) const;
 
+	/**
+	 * Same as getWeight() with both strings already lowercased
+	 * @private
+	 **/
+	unsigned int getLowercaseWeight(const std::string &lowercaseWords, const std::string &lowercaseFilter) const;
+
 	/**
 	 * Return if the given address match domain policy
 	 * @param[in] lFriend friend whose domain will be check
@@ -332,16 +389,6 @@ private:
 	 */
 	bool getAddressIsEndAsync(SearchAsyncData *asyncData) const;
 
-	/**
-	 * @brief mergeResults Merge all the providers results and build the final search vector, accessible with
-	 * mSearchResults. It sorts on display name and if equal, the sort will be in this order : Friend's display name,
-	 * address username, address domain, phone number
-	 * @param request : #SearchRequest that define filter, domain which we want to search only and source flags where to
-	 * search (#LinphoneMagicSearchSource)
-	 * @param asyncData Instance to use for all data storage.
-	 */
-	void mergeResults(const SearchRequest &request, SearchAsyncData *asyncData);
-
 	/**
 	 * @brief processResults Clean for unique items and set the cache.
 	 * @return the cleaned list.
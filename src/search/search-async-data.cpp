@@ -19,6 +19,8 @@
  */
 
 #include "search-async-data.h"
+#include "address/address.h"
+#include "linphone/utils/utils.h"
 #include "logger/logger.h"
 #include "magic-search-p.h"
 #include "magic-search.h"
@@ -130,6 +132,8 @@ std::vector<std::shared_ptr<SearchAsyncData::CbData>> &SearchAsyncData::getData(
 void SearchAsyncData::clear() {
 	mProvidersCbData.clear();
 	mProviderResults.clear();
+	mMergedProviderResults.clear();
+	mMergedAddresses.clear();
 }
 
 void SearchAsyncData::setSearchRequest(const SearchRequest &request) {
@@ -141,4 +145,58 @@ bool SearchAsyncData::setSearchResults(std::shared_ptr<list<std::shared_ptr<Sear
 	return mSearchResults != nullptr;
 }
 
+// Same key for the addresses that are weakly equal, see sal_address_weak_equals(). Empty if the address cannot be
+// merged with any other.
+static string getMergeKey(const Address &address) {
+	if (address.isSip()) {
+		const char *username = address.getUsernameCstr();
+		const char *domain = address.getDomainCstr();
+		string key = "s";
+		key += username ? string("+") + username : string("-");
+		key += '\0';
+		key += domain ? string("+") + domain : string("-");
+		key += '\0';
+		key += to_string(address.getPort());
+		return key;
+	}
+	const string uri = address.asStringUriOnly();
+	return uri.empty() ? string() : "a" + Utils::stringToLower(uri);
+}
+
+bool SearchAsyncData::mergeProviderResults() {
+	unordered_set<const list<std::shared_ptr<SearchResult>> *> pendingResults;
+	for (const auto &data : mProvidersCbData) {
+		if (!data->mEnd) pendingResults.insert(data->mResult);
+	}
+
+	if (!mSearchResults) mSearchResults = make_shared<list<std::shared_ptr<SearchResult>>>();
+	bool merged = false;
+	for (auto &results : mProviderResults) {
+		if (pendingResults.count(&results) > 0 || !mMergedProviderResults.insert(&results).second) continue;
+
+		// Results of a same provider are not merged together, they are only compared to previous providers.
+		list<std::shared_ptr<SearchResult>> newResults;
+		vector<string> newKeys;
+		for (auto &result : results) {
+			const string key = result->getAddress() ? getMergeKey(*result->getAddress()) : string();
+			const auto it = key.empty() ? mMergedAddresses.end() : mMergedAddresses.find(key);
+			if (it != mMergedAddresses.end()) {
+				it->second->merge(result);
+			} else {
+				newResults.push_back(result);
+				newKeys.push_back(key);
+			}
+			merged = true;
+		}
+		auto keyIt = newKeys.cbegin();
+		for (const auto &result : newResults) {
+			if (!keyIt->empty()) mMergedAddresses.emplace(*keyIt, result);
+			++keyIt;
+		}
+		mSearchResults->splice(mSearchResults->end(), newResults);
+		results.clear();
+	}
+	return merged;
+}
+
 LINPHONE_END_NAMESPACE
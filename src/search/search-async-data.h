@@ -24,6 +24,8 @@
 #include <list>
 #include <queue>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "search-request.h"
 #include "search-result.h"
@@ -35,7 +37,7 @@ class MagicSearch;
 class SearchAsyncData {
 public:
 	/**
-	 * @brief mSearchResults This is the final result to use.
+	 * @brief mSearchResults This is the final result to use. Filled by mergeProviderResults() as providers end.
 	 */
 	std::shared_ptr<std::list<std::shared_ptr<SearchResult>>> mSearchResults;
 
@@ -182,6 +184,13 @@ public:
 	 */
 	bool setSearchResults(std::shared_ptr<std::list<std::shared_ptr<SearchResult>>> resultList);
 
+	/**
+	 * @brief mergeProviderResults Move the results of the providers that have ended since the last call into
+	 * mSearchResults. A result whose address is weakly equal to the one of a result already there is merged into it.
+	 * @return true if results were added or merged.
+	 */
+	bool mergeProviderResults();
+
 	/**
 	 * @brief getData Const getter for the vector of provider
 	 * @return Const array of provider.
@@ -223,6 +232,16 @@ private:
 	 * asynchronous strategy.
 	 */
 	std::vector<std::shared_ptr<CbData>> mProvidersCbData;
+
+	/**
+	 * @brief mMergedProviderResults Provider results already moved into mSearchResults.
+	 */
+	std::unordered_set<const std::list<std::shared_ptr<SearchResult>> *> mMergedProviderResults;
+
+	/**
+	 * @brief mMergedAddresses Results of mSearchResults by address, see getMergeKey().
+	 */
+	std::unordered_map<std::string, std::shared_ptr<SearchResult>> mMergedAddresses;
 };
 LINPHONE_END_NAMESPACE
 
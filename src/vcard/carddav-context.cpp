@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
+
 #include "bctoolbox/defs.h"
 
 #include "carddav-context.h"
@@ -118,6 +120,7 @@ void CardDAVContext::synchronize() {
 	if (!isValid()) return;
 
 	mCtag = mFriendList->mRevision;
+	mSyncToken = mFriendList->mSyncToken;
 	mSyncUri = mFriendList->getUri();
 
 	if (mCtag != -1) {
@@ -181,6 +184,7 @@ void CardDAVContext::addressBookUrlAndCtagRetrieved(const std::list<CardDAVRespo
 			        << ctag << "] but our local one is [" << mCtag << "], fetching vCards";
 			mSyncUri = fullUrl;
 			mCtag = ctag;
+			mSyncToken = addressbook.mSyncToken;
 
 			if (mFriendList->getDisplayName().empty() && !displayName.empty()) {
 				lInfo() << "[CardDAV] Updating friend list display name with address book's one";
@@ -199,12 +203,22 @@ void CardDAVContext::addressBookUrlAndCtagRetrieved(const std::list<CardDAVRespo
 	}
 }
 
-void CardDAVContext::addressBookCtagRetrieved(int ctag) {
+void CardDAVContext::addressBookCtagRetrieved(const CardDAVResponse &addressbook) {
+	int ctag = addressbook.mCtag;
 	if (ctag == -1 || ctag > mCtag) {
 		lInfo() << "[CardDAV] User address book has CTAG [" << ctag << "] but our local one is [" << mCtag
 		        << "], fetching vCards";
 		mCtag = ctag;
-		fetchVcards();
+		mSyncToken = addressbook.mSyncToken;
+		// Only ask for what changed since the last sync when the server still advertises sync-tokens
+		const std::string &lastSyncToken = mFriendList->mSyncToken;
+		if (!lastSyncToken.empty() && !mSyncToken.empty()) {
+			lInfo() << "[CardDAV] Fetching changes since sync-token [" << lastSyncToken << "]";
+			mSyncCollectionChanges.clear();
+			fetchVcardsChanges(lastSyncToken);
+		} else {
+			fetchVcards();
+		}
 	} else {
 		lInfo() << "[CardDAV] No changes found on server, skipping sync";
 		serverToClientSyncDone(true, "Synchronization skipped because cTag already up to date");
@@ -215,6 +229,11 @@ void CardDAVContext::fetchVcards() {
 	sendQuery(CardDAVQuery::createAddressbookQuery(this));
 }
 
+void CardDAVContext::fetchVcardsChanges(const std::string &syncToken) {
+	mSyncCollectionToken = syncToken;
+	sendQuery(CardDAVQuery::createSyncCollectionQuery(this, syncToken));
+}
+
 void CardDAVContext::pullVcards(const std::list<CardDAVResponse> &list) {
 	sendQuery(CardDAVQuery::createAddressbookMultigetQuery(this, list));
 }
@@ -296,10 +315,12 @@ void CardDAVContext::sendQuery(CardDAVQuery *query) {
 
 void CardDAVContext::serverToClientSyncDone(bool success, const std::string &msg) {
 	if (success) {
-		lInfo() << "CardDAV sync successful, saving new cTag [" << mCtag << "]";
+		lInfo() << "CardDAV sync successful, saving new cTag [" << mCtag << "] and sync-token [" << mSyncToken << "]";
+		mFriendList->mSyncToken = mSyncToken;
 		mFriendList->updateRevision(mCtag);
 	} else {
 		lError() << "[CardDAV] CardDAV server to client sync failure: " << msg;
+		mSyncToken = mFriendList->mSyncToken;
 	}
 	if (mSynchronizationDoneCb) mSynchronizationDoneCb(this, success, msg);
 }
@@ -311,26 +332,30 @@ void CardDAVContext::vcardsFetched(const std::list<CardDAVResponse> &vCards) {
 	}
 
 	std::list<CardDAVResponse> vCardsToPull = vCards;
+	std::unordered_map<std::string, std::list<CardDAVResponse>::const_iterator> responsesByUrl;
+	responsesByUrl.reserve(vCardsToPull.size());
+	for (auto it = vCardsToPull.cbegin(); it != vCardsToPull.cend(); ++it) {
+		if (!it->mUrl.empty()) responsesByUrl.emplace(it->mUrl, it);
+	}
+
 	const std::list<shared_ptr<Friend>> &friends = mFriendList->getFriends();
 	std::list<shared_ptr<Friend>> friendsToRemove;
 	for (const auto &f : friends) {
-		const auto responseIt = std::find_if(vCardsToPull.cbegin(), vCardsToPull.cend(), [&](const auto &response) {
-			std::shared_ptr<Vcard> vcard = f->getVcard();
-			if (response.mUrl.empty() || !vcard || vcard->getUrl().empty()) return false;
-			return response.mUrl == vcard->getUrl();
-		});
-		if (responseIt == vCardsToPull.cend()) {
+		std::shared_ptr<Vcard> vcard = f->getVcard();
+		const auto responseIt = (vcard && !vcard->getUrl().empty()) ? responsesByUrl.find(vcard->getUrl())
+		                                                            : responsesByUrl.end();
+		if (responseIt == responsesByUrl.end()) {
 			lInfo() << "[CardDAV] Local friend [" << f->getName() << "] with eTag [" << f->getVcard()->getEtag()
 			        << "] isn't in the remote vCard list, will be removed";
 			friendsToRemove.push_back(f);
 		} else {
-			std::shared_ptr<Vcard> vcard = f->getVcard();
 			const std::string etag = vcard->getEtag();
 			lInfo() << "[CardDAV] Local friend [" << f->getName() << "] eTag is [" << etag
-			        << "], remote vCard eTag is [" << responseIt->mEtag << "]";
-			if (!etag.empty() && (etag == responseIt->mEtag)) {
+			        << "], remote vCard eTag is [" << responseIt->second->mEtag << "]";
+			if (!etag.empty() && (etag == responseIt->second->mEtag)) {
 				lInfo() << "[CardDAV] Contact is already up-to-date, do not ask server for vCard: " << f->getName();
-				vCardsToPull.erase(responseIt);
+				vCardsToPull.erase(responseIt->second);
+				responsesByUrl.erase(responseIt);
 			}
 		}
 	}
@@ -346,7 +371,11 @@ void CardDAVContext::vcardsFetched(const std::list<CardDAVResponse> &vCards) {
 
 void CardDAVContext::vcardsPulled(const std::list<CardDAVResponse> &vCards) {
 	if (!vCards.empty()) {
-		const std::list<shared_ptr<Friend>> &friends = mFriendList->getFriends();
+		std::unordered_map<std::string, shared_ptr<Friend>> friendsByUid;
+		for (const auto &f : mFriendList->getFriends()) {
+			std::shared_ptr<Vcard> vcard = f->getVcard();
+			if (vcard && !vcard->getUid().empty()) friendsByUid.emplace(vcard->getUid(), f);
+		}
 		for (const auto &response : vCards) {
 			string vCardBuffer = response.mVcard;
 			std::shared_ptr<Vcard> vcard =
@@ -354,28 +383,18 @@ void CardDAVContext::vcardsPulled(const std::list<CardDAVResponse> &vCards) {
 			        ->getVcardFromBuffer(vCardBuffer);
 			if (vcard) {
 				// Compute downloaded vCards' URL and save it (+ eTag)
-				auto slashPos = response.mUrl.rfind('/');
-				std::string vcardName = response.mUrl.substr((slashPos == std::string::npos) ? 0 : ++slashPos);
-				std::stringstream fullUrlSs;
-				fullUrlSs << mSyncUri << "/" << vcardName;
-				std::string fullUrl = fullUrlSs.str();
-				vcard->setUrl(fullUrl);
+				vcard->setUrl(getVcardUrl(response.mUrl));
 				vcard->setEtag(response.mEtag);
 				lInfo() << "[CardDAV] Downloaded vCard eTag is [" << vcard->getEtag() << "] and URL is ["
 				        << vcard->getUrl() << "]";
 				std::shared_ptr<Friend> newFriend = Friend::create(mFriendList->getCore(), vcard);
 				if (newFriend) {
-					const auto friendIt = std::find_if(friends.cbegin(), friends.cend(), [&](const auto &oldFriend) {
-						std::shared_ptr<Vcard> oldFriendVcard = oldFriend->getVcard();
-						std::shared_ptr<Vcard> newFriendVcard = newFriend->getVcard();
-						if (!oldFriendVcard || !newFriendVcard) return false;
-						std::string oldFriendUid = oldFriendVcard->getUid();
-						std::string newFriendUid = newFriendVcard->getUid();
-						if (oldFriendUid.empty() || newFriendUid.empty()) return false;
-						return oldFriendUid == newFriendUid;
-					});
-					if (friendIt != friends.cend()) {
-						std::shared_ptr<Friend> oldFriend = *friendIt;
+					std::shared_ptr<Vcard> newFriendVcard = newFriend->getVcard();
+					std::string newFriendUid = newFriendVcard ? newFriendVcard->getUid() : std::string();
+					const auto friendIt =
+					    newFriendUid.empty() ? friendsByUid.end() : friendsByUid.find(newFriendUid);
+					if (friendIt != friendsByUid.end()) {
+						std::shared_ptr<Friend> oldFriend = friendIt->second;
 						newFriend->mStorageId = oldFriend->mStorageId;
 						newFriend->setIncSubscribePolicy(oldFriend->getIncSubscribePolicy());
 						newFriend->enableSubscribes(oldFriend->subscribesEnabled());
@@ -387,12 +406,14 @@ void CardDAVContext::vcardsPulled(const std::list<CardDAVResponse> &vCards) {
 							        << newFriend->getVcard()->getEtag() << "]";
 							mContactUpdatedCb(this, newFriend, oldFriend);
 						}
+						friendIt->second = newFriend;
 					} else {
 						if (mContactCreatedCb) {
 							lInfo() << "Contact created []" << newFriend->getName() << "] with eTag ["
 							        << newFriend->getVcard()->getEtag() << "]";
 							mContactCreatedCb(this, newFriend);
 						}
+						if (!newFriendUid.empty()) friendsByUid.emplace(newFriendUid, newFriend);
 					}
 				} else {
 					lError() << "[CardDAV] Couldn't create a friend from vCard";
@@ -405,6 +426,97 @@ void CardDAVContext::vcardsPulled(const std::list<CardDAVResponse> &vCards) {
 	serverToClientSyncDone(true, "");
 }
 
+void CardDAVContext::vcardsChangesFetched(const std::list<CardDAVResponse> &changes,
+                                          const std::string &syncToken,
+                                          bool truncated) {
+	// RFC 6578 3.2: the sync-token is mandatory, it is also missing when the body couldn't be parsed
+	if (syncToken.empty()) {
+		lWarning() << "[CardDAV] sync-collection response has no sync-token, falling back to a full synchronization";
+		mSyncCollectionChanges.clear();
+		fetchVcards();
+		return;
+	}
+
+	mSyncCollectionChanges.insert(mSyncCollectionChanges.end(), changes.cbegin(), changes.cend());
+	if (truncated) {
+		// RFC 6578 3.6: the remaining changes are reported to a new query made with the sync-token of this response
+		if (syncToken == mSyncCollectionToken) {
+			lWarning() << "[CardDAV] Truncated sync-collection response doesn't advance the sync-token, falling back to "
+			              "a full synchronization";
+			mSyncCollectionChanges.clear();
+			fetchVcards();
+		} else {
+			lInfo() << "[CardDAV] Truncated sync-collection response, fetching the next changes since sync-token ["
+			        << syncToken << "]";
+			fetchVcardsChanges(syncToken);
+		}
+		return;
+	}
+	mSyncToken = syncToken;
+
+	// A member changed again while the changes were fetched page by page is only reported by its last response
+	std::list<CardDAVResponse> allChanges = std::move(mSyncCollectionChanges);
+	mSyncCollectionChanges.clear();
+	std::unordered_map<std::string, std::list<CardDAVResponse>::iterator> changesByUrl;
+	for (auto it = allChanges.begin(); it != allChanges.end(); ++it) {
+		auto inserted = changesByUrl.emplace(it->mUrl, it);
+		if (!inserted.second) {
+			allChanges.erase(inserted.first->second);
+			inserted.first->second = it;
+		}
+	}
+
+	std::unordered_map<std::string, shared_ptr<Friend>> friendsByUrl;
+	for (const auto &f : mFriendList->getFriends()) {
+		std::shared_ptr<Vcard> vcard = f->getVcard();
+		if (vcard && !vcard->getUrl().empty()) friendsByUrl.emplace(vcard->getUrl(), f);
+	}
+
+	std::list<CardDAVResponse> vCardsToPull;
+	std::list<shared_ptr<Friend>> friendsToRemove;
+	for (const auto &response : allChanges) {
+		// Local vCards either keep the href sent by the server or the full URL computed when they were pulled
+		auto friendIt = friendsByUrl.find(response.mUrl);
+		if (friendIt == friendsByUrl.end()) friendIt = friendsByUrl.find(getVcardUrl(response.mUrl));
+		if (response.mRemoved) {
+			if (friendIt != friendsByUrl.end()) {
+				friendsToRemove.push_back(friendIt->second);
+				friendsByUrl.erase(friendIt);
+			}
+			continue;
+		}
+		if (friendIt != friendsByUrl.end()) {
+			const std::string etag = friendIt->second->getVcard()->getEtag();
+			if (!etag.empty() && (etag == response.mEtag)) {
+				lInfo() << "[CardDAV] Contact is already up-to-date, do not ask server for vCard: "
+				        << friendIt->second->getName();
+				continue;
+			}
+		}
+		vCardsToPull.push_back(response);
+	}
+	lInfo() << "[CardDAV] Server reported " << allChanges.size() << " change(s) since last sync, " << vCardsToPull.size()
+	        << " vCard(s) to pull and " << friendsToRemove.size() << " to remove";
+
+	for (auto f : friendsToRemove) {
+		if (mContactRemovedCb) {
+			lInfo() << "[CardDAV] Contact removed [" << f->getName() << "] with eTag [" << f->getVcard()->getEtag()
+			        << "]";
+			mContactRemovedCb(this, f);
+		}
+	}
+	if (vCardsToPull.empty()) serverToClientSyncDone(true, "");
+	else pullVcards(vCardsToPull);
+}
+
+std::string CardDAVContext::getVcardUrl(const std::string &href) const {
+	auto slashPos = href.rfind('/');
+	std::string vcardName = href.substr((slashPos == std::string::npos) ? 0 : ++slashPos);
+	std::stringstream fullUrlSs;
+	fullUrlSs << mSyncUri << "/" << vcardName;
+	return fullUrlSs.str();
+}
+
 // -----------------------------------------------------------------------------
 
 std::string CardDAVContext::generateUrlFromServerAddressAndUid(const std::string &serverUrl) {
@@ -457,11 +569,13 @@ std::list<CardDAVResponse> CardDAVContext::parseAddressBookUrlAndCtagValueFromXm
 								if (ctag.empty()) ctag = "-1";
 								std::string url = xmlCtx.getTextContent("d:href");
 								std::string displayName = xmlCtx.getTextContent("d:propstat/d:prop/d:displayname");
+								std::string syncToken = xmlCtx.getTextContent("d:propstat/d:prop/d:sync-token");
 
 								CardDAVResponse response;
 								response.mDisplayName = displayName;
 								response.mCtag = atoi(ctag.c_str());
 								response.mUrl = url;
+								response.mSyncToken = syncToken;
 								result.push_back(std::move(response));
 
 								xmlXPathFreeObject(resources);
@@ -513,14 +627,16 @@ std::string CardDAVContext::parseUserAddressBookUrlValueFromXmlResponse(BCTBX_UN
 	return result;
 }
 
-int CardDAVContext::parseAddressBookCtagValueFromXmlResponse(BCTBX_UNUSED(const std::string &body)) {
-	int result = -1;
+CardDAVResponse CardDAVContext::parseAddressBookCtagValueFromXmlResponse(BCTBX_UNUSED(const std::string &body)) {
+	CardDAVResponse result;
+	result.mCtag = -1;
 	XmlParsingContext xmlCtx(body);
 	if (xmlCtx.isValid()) {
 		xmlCtx.initCarddavNs();
 		std::string response = xmlCtx.getTextContent("/d:multistatus/d:response/d:propstat/d:prop/x1:getctag");
 		lInfo() << "[CardDAV] Extracted CTAG value from body [" << response.c_str() << "]";
-		if (!response.empty()) result = atoi(response.c_str());
+		if (!response.empty()) result.mCtag = atoi(response.c_str());
+		result.mSyncToken = xmlCtx.getTextContent("/d:multistatus/d:response/d:propstat/d:prop/d:sync-token");
 	} else {
 		lError() << "[CardDAV] Body received for user address book CTAG query isn't valid!";
 	}
@@ -584,6 +700,47 @@ std::list<CardDAVResponse> CardDAVContext::parseVcardsFromXmlResponse(const std:
 	return result;
 }
 
+std::list<CardDAVResponse>
+CardDAVContext::parseSyncCollectionFromXmlResponse(const std::string &body, std::string &syncToken, bool &truncated) {
+	std::list<CardDAVResponse> result;
+	truncated = false;
+	XmlParsingContext xmlCtx(body);
+	if (xmlCtx.isValid()) {
+		xmlCtx.initCarddavNs();
+		syncToken = xmlCtx.getTextContent("/d:multistatus/d:sync-token");
+		xmlXPathObjectPtr responses = xmlCtx.getXpathObjectForNodeList("/d:multistatus/d:response");
+		if (responses && responses->nodesetval) {
+			xmlNodeSetPtr responsesNodes = responses->nodesetval;
+			for (int i = 0; i < responsesNodes->nodeNr; i++) {
+				xmlCtx.setXpathContextNode(responsesNodes->nodeTab[i]);
+				CardDAVResponse response;
+				response.mUrl = xmlCtx.getTextContent("d:href");
+				// Removed members come with a response level status instead of a propstat
+				std::string status = xmlCtx.getTextContent("d:status");
+				if (status.find(" 507") != std::string::npos) {
+					// Reported for the collection itself when the server limited the number of changes
+					truncated = true;
+					continue;
+				}
+				if (status.find(" 404") != std::string::npos) {
+					response.mRemoved = true;
+					lInfo() << "[CardDAV] vCard object with URL [" << response.mUrl << "] was removed";
+				} else {
+					response.mEtag = xmlCtx.getTextContent("d:propstat/d:prop/d:getetag");
+					if (response.mEtag.empty()) continue; // The collection itself
+					lInfo() << "[CardDAV] vCard object with URL [" << response.mUrl << "] changed, eTag is ["
+					        << response.mEtag << "]";
+				}
+				result.push_back(std::move(response));
+			}
+			xmlXPathFreeObject(responses);
+		}
+	} else {
+		lError() << "[CardDAV] Body received for sync-collection query isn't valid!";
+	}
+	return result;
+}
+
 #else
 
 std::list<CardDAVResponse>
@@ -599,8 +756,10 @@ std::string CardDAVContext::parseUserAddressBookUrlValueFromXmlResponse(BCTBX_UN
 	return "";
 }
 
-int CardDAVContext::parseAddressBookCtagValueFromXmlResponse(BCTBX_UNUSED(const std::string &body)) {
-	return -1;
+CardDAVResponse CardDAVContext::parseAddressBookCtagValueFromXmlResponse(BCTBX_UNUSED(const std::string &body)) {
+	CardDAVResponse result;
+	result.mCtag = -1;
+	return result;
 }
 
 std::list<CardDAVResponse> CardDAVContext::parseVcardsEtagsFromXmlResponse(BCTBX_UNUSED(const std::string &body)) {
@@ -611,6 +770,13 @@ std::list<CardDAVResponse> CardDAVContext::parseVcardsFromXmlResponse(BCTBX_UNUS
 	return std::list<CardDAVResponse>();
 }
 
+std::list<CardDAVResponse> CardDAVContext::parseSyncCollectionFromXmlResponse(BCTBX_UNUSED(const std::string &body),
+                                                                              BCTBX_UNUSED(std::string &syncToken),
+                                                                              bool &truncated) {
+	truncated = false;
+	return std::list<CardDAVResponse>();
+}
+
 #endif /* HAVE_XML2 */
 
 void CardDAVContext::processAuthRequestedFromCarddavRequest(void *data, belle_sip_auth_event_t *event) {
@@ -712,6 +878,12 @@ void CardDAVContext::processResponseFromCarddavRequest(void *data, const belle_h
 				case CardDAVQuery::Type::AddressbookMultiget:
 					query->mContext->vcardsPulled(parseVcardsFromXmlResponse(body));
 					break;
+				case CardDAVQuery::Type::SyncCollection: {
+					std::string syncToken;
+					bool truncated;
+					std::list<CardDAVResponse> changes = parseSyncCollectionFromXmlResponse(body, syncToken, truncated);
+					query->mContext->vcardsChangesFetched(changes, syncToken, truncated);
+				} break;
 				case CardDAVQuery::Type::Put: {
 					belle_sip_header_t *header =
 					    belle_sip_message_get_header((belle_sip_message_t *)event->response, "ETag");
@@ -750,6 +922,13 @@ void CardDAVContext::processResponseFromCarddavRequest(void *data, const belle_h
 					lError() << "[CardDAV] Unknown request: " << static_cast<int>(query->mType);
 					break;
 			}
+		} else if (query->mType == CardDAVQuery::Type::SyncCollection) {
+			// 403 / 409 mean our sync-token isn't valid anymore, anything else that the report isn't supported
+			lWarning() << "[CardDAV] sync-collection query failed with HTTP response code [" << code
+			           << "], falling back to a full synchronization";
+			if (code != 403 && code != 409) query->mContext->mSyncToken.clear();
+			query->mContext->mSyncCollectionChanges.clear();
+			query->mContext->fetchVcards();
 		} else {
 			if (query->mContext->mWellKnownQueried) {
 				std::stringstream ssMsg;
@@ -76,12 +76,13 @@ private:
 	void userPrincipalUrlRetrieved(std::string principalUrl);
 	void userAddressBookHomeUrlRetrieved(std::string addressBookHomeUrl);
 	void addressBookUrlAndCtagRetrieved(const std::list<CardDAVResponse> &list);
-	void addressBookCtagRetrieved(int ctag);
+	void addressBookCtagRetrieved(const CardDAVResponse &addressbook);
 
 	void setSchemeAndHostIfNotDoneYet(CardDAVQuery *query);
 	void processRedirect(CardDAVQuery *query, belle_sip_message_t *message);
 
 	void fetchVcards();
+	void fetchVcardsChanges(const std::string &syncToken);
 	void pullVcards(const std::list<CardDAVResponse> &list);
 
 	void queryWellKnown(CardDAVQuery *query);
@@ -94,20 +95,29 @@ private:
 	void serverToClientSyncDone(bool success, const std::string &msg);
 	void vcardsFetched(const std::list<CardDAVResponse> &vCards);
 	void vcardsPulled(const std::list<CardDAVResponse> &vCards);
+	void vcardsChangesFetched(const std::list<CardDAVResponse> &changes, const std::string &syncToken, bool truncated);
+
+	std::string getVcardUrl(const std::string &href) const;
 
 	static std::string generateUrlFromServerAddressAndUid(const std::string &serverUrl);
 	static std::string parseUserPrincipalUrlValueFromXmlResponse(const std::string &body);
 	static std::string parseUserAddressBookUrlValueFromXmlResponse(const std::string &body);
 	static std::list<CardDAVResponse> parseAddressBookUrlAndCtagValueFromXmlResponse(const std::string &body);
-	static int parseAddressBookCtagValueFromXmlResponse(const std::string &body);
+	static CardDAVResponse parseAddressBookCtagValueFromXmlResponse(const std::string &body);
 	static std::list<CardDAVResponse> parseVcardsEtagsFromXmlResponse(const std::string &body);
 	static std::list<CardDAVResponse> parseVcardsFromXmlResponse(const std::string &body);
+	static std::list<CardDAVResponse>
+	parseSyncCollectionFromXmlResponse(const std::string &body, std::string &syncToken, bool &truncated);
 	static void processAuthRequestedFromCarddavRequest(void *data, belle_sip_auth_event_t *event);
 	static void processIoErrorFromCarddavRequest(void *data, const belle_sip_io_error_event_t *event);
 	static void processResponseFromCarddavRequest(void *data, const belle_http_response_event_t *event);
 
 	std::shared_ptr<FriendList> mFriendList = nullptr;
 	int mCtag = -1;
+	std::string mSyncToken = ""; // Saved in the friend list once the server to client sync succeeds
+	// Changes reported by the sync-collection responses truncated by the server, applied with the last one
+	std::list<CardDAVResponse> mSyncCollectionChanges;
+	std::string mSyncCollectionToken = ""; // Sync-token of the pending sync-collection query
 	std::string mSyncUri = "";
 	std::string mScheme = "http";
 	std::string mHost = "";
@@ -47,6 +47,7 @@ bool CardDAVQuery::isClientToServerSync() const {
 		case Type::Propfind:
 		case Type::AddressbookQuery:
 		case Type::AddressbookMultiget:
+		case Type::SyncCollection:
 			return false;
 		case Type::Put:
 		case Type::Delete:
@@ -89,6 +90,19 @@ CardDAVQuery *CardDAVQuery::createAddressbookQuery(CardDAVContext *context) {
 	return query;
 }
 
+CardDAVQuery *CardDAVQuery::createSyncCollectionQuery(CardDAVContext *context, const std::string &syncToken) {
+	CardDAVQuery *query = new CardDAVQuery(context);
+	query->mDepth = "0"; // RFC 6578 only defines this report for Depth 0
+	std::stringstream ssBody;
+	ssBody << "<d:sync-collection xmlns:d=\"DAV:\"><d:sync-token>" << syncToken
+	       << "</d:sync-token><d:sync-level>1</d:sync-level><d:prop><d:getetag /></d:prop></d:sync-collection>";
+	query->mBody = ssBody.str();
+	query->mMethod = "REPORT";
+	query->mUrl = context->mSyncUri;
+	query->mType = Type::SyncCollection;
+	return query;
+}
+
 CardDAVQuery *CardDAVQuery::createDeleteQuery(CardDAVContext *context, const std::shared_ptr<Vcard> &vcard) {
 	CardDAVQuery *query = new CardDAVQuery(context);
 	query->mIfmatch = vcard->getEtag();
@@ -126,7 +140,7 @@ CardDAVQuery *CardDAVQuery::createAddressBookUrlAndCtagPropfindQuery(CardDAVCont
 	CardDAVQuery *query = new CardDAVQuery(context);
 	query->mDepth = "1"; // This PROPFIND must have Depth 1!
 	query->mBody = "<d:propfind xmlns:d=\"DAV:\" xmlns:cs=\"http://calendarserver.org/ns/\"><d:prop><d:resourcetype "
-	               "/><d:displayname /><cs:getctag /></d:prop></d:propfind>";
+	               "/><d:displayname /><cs:getctag /><d:sync-token /></d:prop></d:propfind>";
 	query->mMethod = "PROPFIND";
 	query->mUrl = context->mSyncUri;
 	query->mType = Type::Propfind;
@@ -138,7 +152,7 @@ CardDAVQuery *CardDAVQuery::createAddressBookCtagPropfindQuery(CardDAVContext *c
 	CardDAVQuery *query = new CardDAVQuery(context);
 	query->mDepth = "1"; // This PROPFIND must have Depth 1!
 	query->mBody = "<d:propfind xmlns:d=\"DAV:\" xmlns:cs=\"http://calendarserver.org/ns/\"><d:prop><cs:getctag "
-	               "/></d:prop></d:propfind>";
+	               "/><d:sync-token /></d:prop></d:propfind>";
 	query->mMethod = "PROPFIND";
 	query->mUrl = context->mSyncUri;
 	query->mType = Type::Propfind;
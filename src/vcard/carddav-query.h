@@ -33,7 +33,7 @@ class Vcard;
 
 class CardDAVQuery : public UserDataAccessor {
 public:
-	enum class Type { Propfind, AddressbookQuery, AddressbookMultiget, Put, Delete };
+	enum class Type { Propfind, AddressbookQuery, AddressbookMultiget, SyncCollection, Put, Delete };
 	enum class PropfindType { UserPrincipal, UserAddressBooksHome, AddressBookUrlAndCTAG, AddressBookCTAG };
 
 	CardDAVQuery(CardDAVContext *context);
@@ -52,6 +52,7 @@ public:
 	static CardDAVQuery *createAddressbookQuery(CardDAVContext *context);
 	static CardDAVQuery *createAddressbookMultigetQuery(CardDAVContext *context,
 	                                                    const std::list<CardDAVResponse> &list);
+	static CardDAVQuery *createSyncCollectionQuery(CardDAVContext *context, const std::string &syncToken);
 	static CardDAVQuery *createDeleteQuery(CardDAVContext *context, const std::shared_ptr<Vcard> &vcard);
 	static CardDAVQuery *createPutQuery(CardDAVContext *context, const std::shared_ptr<Vcard> &vcard);
 
@@ -38,6 +38,8 @@ public:
 	std::string mEtag;
 	std::string mUrl;
 	std::string mVcard;
+	std::string mSyncToken;
+	bool mRemoved = false; // Member reported as deleted by a sync-collection REPORT
 };
 
 LINPHONE_END_NAMESPACE
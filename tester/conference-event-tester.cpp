@@ -19,6 +19,7 @@
  */
 
 #include <map>
+#include <sstream>
 #include <string>
 
 #include "bctoolbox/defs.h"
@@ -2468,6 +2469,278 @@ void send_device_removed_notify() {
 	linphone_core_manager_destroy(pauline);
 }
 
+static string conferenceInfoUserToString(const Xsd::ConferenceInfo::UserType &user) {
+	Xsd::ConferenceInfo::ConferenceType confInfo(string("sip:conference@example.org"));
+	Xsd::ConferenceInfo::UsersType users;
+	users.getUser().push_back(user);
+	confInfo.setUsers(users);
+	stringstream xml;
+	Xsd::XmlSchema::NamespaceInfomap map;
+	map[""].name = "urn:ietf:params:xml:ns:conference-info";
+	map["linphone-cie"].name = "linphone:xml:ns:conference-info-linphone-extension";
+	Xsd::ConferenceInfo::serializeConferenceInfo(xml, confInfo, map);
+	return xml.str();
+}
+
+static unique_ptr<Xsd::ConferenceInfo::ConferenceType> parseConferenceInfoBody(const string &body) {
+	istringstream data(body);
+	try {
+		return Xsd::ConferenceInfo::parseConferenceInfo(data, Xsd::XmlSchema::Flags::dont_validate);
+	} catch (const exception &e) {
+		BC_FAIL("Cannot parse conference-info document");
+		ms_error("Cannot parse conference-info document: %s\n%s", e.what(), body.c_str());
+	}
+	return nullptr;
+}
+
+static const Xsd::ConferenceInfo::UserType *findConferenceInfoUser(const Xsd::ConferenceInfo::ConferenceType &confInfo,
+                                                                   const std::shared_ptr<Address> &address) {
+	if (!confInfo.getUsers()) return nullptr;
+	for (const auto &user : confInfo.getUsers()->getUser()) {
+		if (user.getEntity() && (user.getEntity().get() == address->asStringUriOnly())) return &user;
+	}
+	return nullptr;
+}
+
+void conference_info_writer_round_trip() {
+	LinphoneCoreManager *pauline =
+	    linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	std::shared_ptr<Address> addr = Address::toCpp(pauline->identity)->getSharedFromThis();
+	shared_ptr<ServerConferenceTester> localConf =
+	    make_shared<ServerConferenceTester>(pauline->lc->cppPtr, addr, nullptr);
+	localConf->init();
+	ServerConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+	std::shared_ptr<Address> bobAddr = Address::create(bobUri);
+	std::shared_ptr<Address> aliceAddr = Address::create(aliceUri);
+
+	localConf->addParticipant(bobAddr);
+	localConf->addParticipant(aliceAddr);
+	setParticipantAsAdmin(localConf, aliceAddr, true);
+	localConf->setState(ConferenceInterface::State::Instantiated);
+	localConf->setConferenceAddress(addr);
+
+	shared_ptr<ParticipantDevice> bobDevice = localConf->findParticipantDevice(bobAddr, bobAddr);
+	if (!BC_ASSERT_PTR_NOT_NULL(bobDevice)) {
+		localConf = nullptr;
+		linphone_core_manager_destroy(pauline);
+		return;
+	}
+	bobDevice->setName("Bob's \"phone\" & <tablet>");
+	bobDevice->setJoiningMethod(ParticipantDevice::JoiningMethod::DialedIn);
+	bobDevice->setTimeOfJoining(1700000000);
+	bobDevice->setState(ParticipantDevice::State::Present, false);
+	bobDevice->setStreamCapability(LinphoneMediaDirectionSendRecv, LinphoneStreamTypeAudio);
+	bobDevice->setSsrc(LinphoneStreamTypeAudio, 1234);
+	bobDevice->setStreamCapability(LinphoneMediaDirectionSendRecv, LinphoneStreamTypeVideo);
+	bobDevice->setLabel("bob-video", LinphoneStreamTypeVideo);
+	bobDevice->setSsrc(LinphoneStreamTypeVideo, 5678);
+	bobDevice->setCallId("call-id@example.org");
+	bobDevice->setFromTag("from-tag");
+	bobDevice->setToTag("to-tag");
+
+	{
+		// The full state document is still built with the DOM: the streamed documents must describe users and
+		// endpoints the same way.
+		auto fullState = parseConferenceInfoBody(localHandler->createNotifyFullState(nullptr)->getBodyAsUtf8String());
+		const auto *fullStateBob = fullState ? findConferenceInfoUser(*fullState, bobAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(fullStateBob);
+
+		auto added = parseConferenceInfoBody(localHandler->createNotifyParticipantAdded(bobAddr));
+		BC_ASSERT_PTR_NOT_NULL(added);
+		if (added) {
+			BC_ASSERT_TRUE(added->getEntity() == addr->asStringUriOnly());
+			BC_ASSERT_TRUE(added->getState() == Xsd::ConferenceInfo::StateType::partial);
+			BC_ASSERT_TRUE(added->getVersion().present() && (added->getVersion().get() == localConf->getLastNotify()));
+			BC_ASSERT_TRUE(added->getConferenceDescription().present() &&
+			               added->getConferenceDescription()->getFreeText().present());
+			const auto *addedBob = findConferenceInfoUser(*added, bobAddr);
+			BC_ASSERT_PTR_NOT_NULL(addedBob);
+			if (addedBob && fullStateBob) {
+				BC_ASSERT_STRING_EQUAL(conferenceInfoUserToString(*addedBob).c_str(),
+				                       conferenceInfoUserToString(*fullStateBob).c_str());
+			}
+		}
+
+		auto deviceAdded = parseConferenceInfoBody(localHandler->createNotifyParticipantDeviceAdded(bobAddr, bobAddr));
+		BC_ASSERT_PTR_NOT_NULL(deviceAdded);
+		const auto *deviceAddedBob = deviceAdded ? findConferenceInfoUser(*deviceAdded, bobAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(deviceAddedBob);
+		if (deviceAddedBob && fullStateBob) {
+			auto user = *fullStateBob;
+			user.setState(Xsd::ConferenceInfo::StateType::partial);
+			user.getRoles().reset();
+			BC_ASSERT_STRING_EQUAL(conferenceInfoUserToString(*deviceAddedBob).c_str(),
+			                       conferenceInfoUserToString(user).c_str());
+		}
+
+		auto dataChanged =
+		    parseConferenceInfoBody(localHandler->createNotifyParticipantDeviceDataChanged(bobAddr, bobAddr));
+		BC_ASSERT_PTR_NOT_NULL(dataChanged);
+		const auto *dataChangedBob = dataChanged ? findConferenceInfoUser(*dataChanged, bobAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(dataChangedBob);
+		if (dataChangedBob && fullStateBob) {
+			auto user = *fullStateBob;
+			user.setState(Xsd::ConferenceInfo::StateType::partial);
+			user.getRoles().reset();
+			for (auto &endpoint : user.getEndpoint())
+				endpoint.setState(Xsd::ConferenceInfo::StateType::partial);
+			BC_ASSERT_STRING_EQUAL(conferenceInfoUserToString(*dataChangedBob).c_str(),
+			                       conferenceInfoUserToString(user).c_str());
+		}
+	}
+
+	{
+		auto adminChanged =
+		    parseConferenceInfoBody(localHandler->createNotifyParticipantAdminStatusChanged(aliceAddr, false));
+		const auto *alice = adminChanged ? findConferenceInfoUser(*adminChanged, aliceAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(alice);
+		if (alice) {
+			BC_ASSERT_TRUE(alice->getState() == Xsd::ConferenceInfo::StateType::partial);
+			BC_ASSERT_TRUE(alice->getRoles().present() && (alice->getRoles()->getEntry().size() == 1) &&
+			               (alice->getRoles()->getEntry().front() == "participant"));
+			BC_ASSERT_TRUE(alice->getEndpoint().empty());
+		}
+
+		auto removed = parseConferenceInfoBody(localHandler->createNotifyParticipantRemoved(aliceAddr));
+		alice = removed ? findConferenceInfoUser(*removed, aliceAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(alice);
+		if (alice) {
+			BC_ASSERT_TRUE(alice->getState() == Xsd::ConferenceInfo::StateType::deleted);
+			BC_ASSERT_FALSE(alice->getRoles().present());
+		}
+
+		bobDevice->setTimeOfDisconnection(1700000100);
+		bobDevice->setDisconnectionMethod(ParticipantDevice::DisconnectionMethod::Booted);
+		bobDevice->setDisconnectionReason("Removed by <admin>");
+		auto deviceRemoved =
+		    parseConferenceInfoBody(localHandler->createNotifyParticipantDeviceRemoved(bobAddr, bobAddr));
+		const auto *bob = deviceRemoved ? findConferenceInfoUser(*deviceRemoved, bobAddr) : nullptr;
+		BC_ASSERT_PTR_NOT_NULL(bob);
+		if (bob && BC_ASSERT_EQUAL(bob->getEndpoint().size(), 1, size_t, "%zu")) {
+			const auto &endpoint = bob->getEndpoint().front();
+			BC_ASSERT_TRUE(endpoint.getState() == Xsd::ConferenceInfo::StateType::deleted);
+			BC_ASSERT_TRUE(endpoint.getDisconnectionMethod().present() &&
+			               (endpoint.getDisconnectionMethod().get() == Xsd::ConferenceInfo::DisconnectionType::booted));
+			const auto &disconnectionInfo = endpoint.getDisconnectionInfo();
+			BC_ASSERT_TRUE(disconnectionInfo.present() && disconnectionInfo->getWhen().present());
+			BC_ASSERT_TRUE(disconnectionInfo.present() && disconnectionInfo->getReason().present() &&
+			               (disconnectionInfo->getReason().get() == "Removed by <admin>"));
+			const auto &callInfo = endpoint.getCallInfo();
+			BC_ASSERT_TRUE(callInfo.present() && (callInfo->getSip().getCallId() == "call-id@example.org"));
+			BC_ASSERT_TRUE(endpoint.getMedia().empty());
+		}
+
+		const string subject = "Sales & marketing <weekly>";
+		localConf->setUtf8Subject(subject);
+		auto subjectChanged = parseConferenceInfoBody(localHandler->createNotifySubjectChanged());
+		BC_ASSERT_TRUE(subjectChanged && subjectChanged->getConferenceDescription().present() &&
+		               subjectChanged->getConferenceDescription()->getSubject().present() &&
+		               (subjectChanged->getConferenceDescription()->getSubject().get() == subject));
+		BC_ASSERT_FALSE(subjectChanged && subjectChanged->getUsers().present());
+
+		// C0 control characters other than tab, CR and LF are not allowed in XML 1.0 and are dropped.
+		localConf->setUtf8Subject("Bell\x07 and\x1B escape\tdone\x01");
+		subjectChanged = parseConferenceInfoBody(localHandler->createNotifySubjectChanged());
+		BC_ASSERT_TRUE(subjectChanged && subjectChanged->getConferenceDescription().present() &&
+		               subjectChanged->getConferenceDescription()->getSubject().present() &&
+		               (subjectChanged->getConferenceDescription()->getSubject().get() == "Bell and escape\tdone"));
+	}
+
+	bobDevice = nullptr;
+	localConf = nullptr;
+	linphone_core_manager_destroy(pauline);
+}
+
+void join_and_leave_many_devices() {
+	LinphoneCoreManager *pauline =
+	    linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	std::shared_ptr<Address> addr = Address::toCpp(pauline->identity)->getSharedFromThis();
+	shared_ptr<ServerConferenceTester> localConf =
+	    make_shared<ServerConferenceTester>(pauline->lc->cppPtr, addr, nullptr);
+	localConf->init();
+
+	const int count = 1000;
+	list<std::shared_ptr<Address>> addresses;
+	for (int i = 0; i < count; i++)
+		addresses.push_back(Address::create("sip:participant" + std::to_string(i) + "@sip.example.org"));
+
+	uint64_t start = bctbx_get_cur_time_ms();
+	for (const auto &participantAddress : addresses)
+		localConf->addParticipant(participantAddress);
+	ms_message("%d participants joined in %llu ms", count, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL(localConf->getParticipantCount(), count, int, "%d");
+
+	start = bctbx_get_cur_time_ms();
+	int found = 0;
+	for (const auto &participantAddress : addresses) {
+		if (localConf->findParticipant(participantAddress) &&
+		    localConf->findParticipantDevice(participantAddress, participantAddress))
+			found++;
+	}
+	ms_message("%d participants and devices looked up in %llu ms", count,
+	           (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL(found, count, int, "%d");
+
+	start = bctbx_get_cur_time_ms();
+	for (const auto &participantAddress : addresses) {
+		auto participant = localConf->findParticipant(participantAddress);
+		if (participant) localConf->removeParticipant(participant);
+	}
+	ms_message("%d participants left in %llu ms", count, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_TRUE(localConf->getParticipants().empty());
+	BC_ASSERT_PTR_NULL(localConf->findParticipant(addresses.front()));
+
+	localConf = nullptr;
+	linphone_core_manager_destroy(pauline);
+}
+
+void replay_missed_notifies_from_memory() {
+	LinphoneCoreManager *pauline =
+	    linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	std::shared_ptr<Address> addr = Address::toCpp(pauline->identity)->getSharedFromThis();
+	shared_ptr<ServerConferenceTester> localConf =
+	    make_shared<ServerConferenceTester>(pauline->lc->cppPtr, addr, nullptr);
+	localConf->init();
+	ServerConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+	std::shared_ptr<Address> bobAddr = Address::create(bobUri);
+
+	localConf->addParticipant(bobAddr);
+	localConf->setState(ConferenceInterface::State::Instantiated);
+	localConf->setConferenceAddress(addr);
+
+	for (int i = 0; i < 5; i++)
+		localConf->setSubject("Subject " + std::to_string(i));
+	const unsigned int lastNotify = localConf->getLastNotify();
+
+	// No chat room stores these events: they can only be replayed from the NOTIFYs kept in memory
+	auto missed = localHandler->createNotifyMissedUpdates(static_cast<int>(lastNotify - 3));
+	if (BC_ASSERT_PTR_NOT_NULL(missed)) {
+		BC_ASSERT_FALSE(missed->isEmpty());
+		BC_ASSERT_TRUE(missed->getContentType().isMultipart());
+		// Devices resynchronising from the same version share the same multipart
+		BC_ASSERT_PTR_EQUAL(localHandler->createNotifyMissedUpdates(static_cast<int>(lastNotify - 3)).get(),
+		                    missed.get());
+		auto copy = localHandler->getNotifyForId(static_cast<int>(lastNotify - 3), nullptr);
+		BC_ASSERT_TRUE(copy != missed);
+		BC_ASSERT_STRING_EQUAL(copy->getBodyAsUtf8String().c_str(), missed->getBodyAsUtf8String().c_str());
+	}
+	BC_ASSERT_TRUE(localHandler->createNotifyMissedUpdates(static_cast<int>(lastNotify - 2)) != missed);
+
+	// Only the last full_state_trigger_due_to_missing_updates versions are kept in memory
+	for (int i = 5; i < 20; i++)
+		localConf->setSubject("Subject " + std::to_string(i));
+	auto tooOld = localHandler->createNotifyMissedUpdates(static_cast<int>(lastNotify));
+	BC_ASSERT_TRUE(!tooOld || tooOld->isEmpty());
+	auto recent = localHandler->createNotifyMissedUpdates(static_cast<int>(localConf->getLastNotify() - 10));
+	BC_ASSERT_TRUE(recent && !recent->isEmpty());
+
+	missed = nullptr;
+	tooOld = nullptr;
+	recent = nullptr;
+	localConf = nullptr;
+	linphone_core_manager_destroy(pauline);
+}
+
 void one_to_one_keyword() {
 	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
 	LinphoneCoreManager *pauline =
@@ -2534,6 +2807,9 @@ test_t conference_event_tests[] = {
     TEST_NO_TAG("Send subject changed notify", send_subject_changed_notify),
     TEST_NO_TAG("Send device added notify", send_device_added_notify),
     TEST_NO_TAG("Send device removed notify", send_device_removed_notify),
+    TEST_NO_TAG("Join and leave 1000 devices", join_and_leave_many_devices),
+    TEST_NO_TAG("Conference info writer round trip", conference_info_writer_round_trip),
+    TEST_NO_TAG("Replay missed notifies from memory", replay_missed_notifies_from_memory),
     TEST_NO_TAG("one-to-one keyword", one_to_one_keyword)};
 
 test_suite_t conference_event_test_suite = {"Conference event",
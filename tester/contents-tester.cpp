@@ -25,6 +25,7 @@
 #include "content/content-type.h"
 #include "content/content.h"
 #include "content/header/header-param.h"
+#include "event/event-subscribe.h"
 #include "liblinphone_tester.h"
 #include "linphone/api/c-content.h"
 #include "logger/logger.h"
@@ -681,12 +682,94 @@ static void content_public_api(void) {
 	linphone_content_unref(content);
 }
 
+static void notify_fan_out_with_shared_body(void) {
+	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *laure = linphone_core_manager_new("laure_tcp_rc");
+	const list<LinphoneCoreManager *> subscribers = {marie, laure};
+	bctbx_list_t *lcs = bctbx_list_append(NULL, pauline->lc);
+	lcs = bctbx_list_append(lcs, marie->lc);
+	lcs = bctbx_list_append(lcs, laure->lc);
+
+	// Pauline does not notify subscriptions to this event on her own: the NOTIFYs below are the only ones.
+	list<LinphoneEvent *> outgoingEvents;
+	list<shared_ptr<EventSubscribe>> incomingEvents;
+	int subscriptionCount = 0;
+	for (auto subscriber : subscribers) {
+		LinphoneContent *subscribeContent = linphone_core_create_content(subscriber->lc);
+		linphone_content_set_type(subscribeContent, "application");
+		linphone_content_set_subtype(subscribeContent, "somexml");
+		linphone_content_set_utf8_text(subscribeContent, liblinphone_tester_get_subscribe_content());
+		LinphoneEvent *lev =
+		    linphone_core_subscribe(subscriber->lc, pauline->identity, "doingnothing", 600, subscribeContent);
+		linphone_event_ref(lev);
+		linphone_content_unref(subscribeContent);
+		outgoingEvents.push_back(lev);
+		subscriptionCount++;
+		BC_ASSERT_TRUE(wait_for_list(lcs, &subscriber->stat.number_of_LinphoneSubscriptionActive, 1, 5000));
+		BC_ASSERT_TRUE(
+		    wait_for_list(lcs, &pauline->stat.number_of_LinphoneSubscriptionActive, subscriptionCount, 5000));
+		if (BC_ASSERT_PTR_NOT_NULL(pauline->lev)) {
+			incomingEvents.push_back(
+			    dynamic_pointer_cast<EventSubscribe>(Event::toCpp(pauline->lev)->getSharedFromThis()));
+		}
+	}
+
+	auto content = Content::create();
+	content->setContentType(ContentType("application", "somexml2"));
+	content->setBodyFromUtf8(liblinphone_tester_get_notify_content());
+	// The body is deflated once, when it is prepared.
+	if (linphone_core_content_encoding_supported(pauline->lc, "deflate")) content->setContentEncoding("deflate");
+	BC_ASSERT_PTR_NULL(content->createPreparedBodyHandler());
+	content->prepareBodyHandler();
+
+	// Every message gets its own body handler, as the transfer state is kept in it.
+	SalBodyHandler *firstBodyHandler = sal_body_handler_ref(content->createPreparedBodyHandler());
+	SalBodyHandler *secondBodyHandler = sal_body_handler_ref(content->createPreparedBodyHandler());
+	BC_ASSERT_PTR_NOT_NULL(firstBodyHandler);
+	BC_ASSERT_PTR_NOT_EQUAL(firstBodyHandler, secondBodyHandler);
+	BC_ASSERT_EQUAL(sal_body_handler_get_size(firstBodyHandler), sal_body_handler_get_size(secondBodyHandler), size_t,
+	                "%zu");
+	sal_body_handler_unref(firstBodyHandler);
+	sal_body_handler_unref(secondBodyHandler);
+
+	// Every device is sent a copy of the prepared body, linphone_notify_received() checks the body each one receives.
+	for (const auto &ev : incomingEvents)
+		BC_ASSERT_EQUAL(ev->notify(content), 0, int, "%d");
+	for (auto subscriber : subscribers)
+		BC_ASSERT_TRUE(wait_for_list(lcs, &subscriber->stat.number_of_NotifyReceived, 1, 5000));
+
+	// A setter drops the prepared body, the next fan-out sends the modified content.
+	content->addHeader("X-Fan-Out", "2");
+	BC_ASSERT_PTR_NULL(content->createPreparedBodyHandler());
+	content->prepareBodyHandler();
+	BC_ASSERT_STRING_EQUAL(content->getCustomHeader("X-Fan-Out").c_str(), "2");
+	for (const auto &ev : incomingEvents)
+		BC_ASSERT_EQUAL(ev->notify(content), 0, int, "%d");
+	for (auto subscriber : subscribers)
+		BC_ASSERT_TRUE(wait_for_list(lcs, &subscriber->stat.number_of_NotifyReceived, 2, 5000));
+
+	incomingEvents.clear();
+	for (auto lev : outgoingEvents) {
+		linphone_event_terminate(lev);
+		linphone_event_unref(lev);
+	}
+	BC_ASSERT_TRUE(wait_for_list(lcs, &pauline->stat.number_of_LinphoneSubscriptionTerminated,
+	                             (int)subscribers.size(), 5000));
+
+	bctbx_list_free(lcs);
+	linphone_core_manager_destroy(laure);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
 test_t contents_tests[] = {TEST_NO_TAG("Multipart to list", multipart_to_list),
                            TEST_NO_TAG("Multipart parsing", multipart_parsing),
                            TEST_NO_TAG("List to multipart", list_to_multipart),
                            TEST_NO_TAG("Content type parsing", content_type_parsing),
                            TEST_NO_TAG("Content header parsing", content_header_parsing),
-                           TEST_NO_TAG("Content C public API", content_public_api)};
+                           TEST_NO_TAG("Content C public API", content_public_api),
+                           TEST_NO_TAG("NOTIFY fan-out with a shared body", notify_fan_out_with_shared_body)};
 
 test_suite_t contents_test_suite = {"Contents",
                                     nullptr,
@@ -1996,6 +1996,120 @@ static void group_chat_room_bulk_notify_to_participant(void) {
 	}
 }
 
+// The one-to-one and previous conference ID lookups of the core are served by indexes that must follow the chat
+// rooms through their exhumation and deletion.
+static void one_to_one_chatroom_lookups_through_indexes(void) {
+	Focus focus("chloe_rc");
+	{ // to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getConferenceFactoryAddress());
+		ClientConference pauline("pauline_rc", focus.getConferenceFactoryAddress());
+
+		focus.registerAsParticipantDevice(marie);
+		focus.registerAsParticipantDevice(pauline);
+
+		bctbx_list_t *coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		Address paulineAddr = pauline.getIdentity();
+		bctbx_list_t *participantsAddresses = bctbx_list_append(NULL, linphone_address_ref(paulineAddr.toC()));
+		auto marieIdentity = Address::create(linphone_core_get_identity(marie.getLc()));
+		auto paulineIdentity = Address::create(linphone_core_get_identity(pauline.getLc()));
+		const CorePrivate *marieCore = L_GET_PRIVATE_FROM_C_OBJECT(marie.getLc());
+		const CorePrivate *paulineCore = L_GET_PRIVATE_FROM_C_OBJECT(pauline.getLc());
+
+		stats initialMarieStats = marie.getStats();
+		stats initialPaulineStats = pauline.getStats();
+
+		const char *initialSubject = "one to one with Pauline";
+		LinphoneChatRoom *marieCr =
+		    create_chat_room_client_side(coresList, marie.getCMgr(), &initialMarieStats, participantsAddresses,
+		                                 initialSubject, FALSE, LinphoneChatRoomEphemeralModeDeviceManaged);
+		if (!BC_ASSERT_PTR_NOT_NULL(marieCr)) {
+			bctbx_list_free(coresList);
+			return;
+		}
+		LinphoneAddress *confAddr = linphone_address_clone(linphone_chat_room_get_conference_address(marieCr));
+		LinphoneChatRoom *paulineCr = check_creation_chat_room_client_side(
+		    coresList, pauline.getCMgr(), &initialPaulineStats, confAddr, initialSubject, 1, FALSE);
+		if (!BC_ASSERT_PTR_NOT_NULL(paulineCr)) {
+			linphone_address_unref(confAddr);
+			bctbx_list_free(coresList);
+			return;
+		}
+		auto paulineChatRoom = AbstractChatRoom::toCpp(paulineCr)->getSharedFromThis();
+		const ConferenceId previousConferenceId = paulineChatRoom->getConferenceId();
+
+		// FlexisipChat one-to-one chat rooms are found from the addresses of their local and only participant
+		BC_ASSERT_TRUE(marie.getCore().findOneToOneChatRoom(marieIdentity, paulineIdentity, false, true, false) ==
+		               AbstractChatRoom::toCpp(marieCr)->getSharedFromThis());
+		BC_ASSERT_TRUE(pauline.getCore().findOneToOneChatRoom(paulineIdentity, marieIdentity, false, false, false) ==
+		               paulineChatRoom);
+		BC_ASSERT_PTR_NULL(pauline.getCore().findOneToOneChatRoom(paulineIdentity, marieIdentity, true, false, false));
+		BC_ASSERT_TRUE(paulineCore->findExhumableOneToOneChatRoom(paulineIdentity, marieIdentity, false) ==
+		               paulineChatRoom);
+
+		// A deleted chat room is removed from the index
+		initialMarieStats = marie.getStats();
+		initialPaulineStats = pauline.getStats();
+		linphone_core_manager_delete_chat_room(marie.getCMgr(), marieCr, coresList);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneChatRoomStateTerminated,
+		                             initialMarieStats.number_of_LinphoneChatRoomStateTerminated + 1,
+		                             liblinphone_tester_sip_timeout));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_LinphoneChatRoomStateTerminated,
+		                             initialPaulineStats.number_of_LinphoneChatRoomStateTerminated + 1,
+		                             liblinphone_tester_sip_timeout));
+		BC_ASSERT_PTR_NULL(marie.getCore().findOneToOneChatRoom(marieIdentity, paulineIdentity, false, true, false));
+		BC_ASSERT_PTR_NULL(marieCore->findExhumableOneToOneChatRoom(marieIdentity, paulineIdentity, false));
+
+		// Pauline's chat room is still found, and is exhumed by her next message under a new conference ID
+		BC_ASSERT_TRUE(paulineCore->findExhumableOneToOneChatRoom(paulineIdentity, marieIdentity, false) ==
+		               paulineChatRoom);
+		LinphoneChatMessage *paulineMsg =
+		    linphone_chat_room_create_message_from_utf8(paulineCr, "Is anybody out there?");
+		linphone_chat_message_send(paulineMsg);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_LinphoneChatRoomStateCreated,
+		                             initialPaulineStats.number_of_LinphoneChatRoomStateCreated + 1,
+		                             liblinphone_tester_sip_timeout));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageReceived,
+		                             initialMarieStats.number_of_LinphoneMessageReceived + 1,
+		                             liblinphone_tester_sip_timeout));
+		linphone_chat_message_unref(paulineMsg);
+		BC_ASSERT_FALSE(paulineChatRoom->getConferenceId() == previousConferenceId);
+
+		BC_ASSERT_TRUE(pauline.getCore().findOneToOneChatRoom(paulineIdentity, marieIdentity, false, true, false) ==
+		               paulineChatRoom);
+		BC_ASSERT_TRUE(pauline.getCore().findChatRoom(paulineChatRoom->getConferenceId()) == paulineChatRoom);
+		// The previous conference ID still leads to the exhumed chat room
+		BC_ASSERT_TRUE(pauline.getCore().findChatRoom(previousConferenceId) == paulineChatRoom);
+		BC_ASSERT_TRUE(paulineCore->findExumedChatRoomFromPreviousConferenceId(previousConferenceId) ==
+		               paulineChatRoom);
+		auto marieChatRoom = marie.getCore().findOneToOneChatRoom(marieIdentity, paulineIdentity, false, true, false);
+		BC_ASSERT_PTR_NOT_NULL(marieChatRoom);
+
+		// Once deleted, the exhumed chat room is found neither from its addresses nor from its previous conference ID
+		initialMarieStats = marie.getStats();
+		initialPaulineStats = pauline.getStats();
+		linphone_core_manager_delete_chat_room(pauline.getCMgr(), paulineCr, coresList);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_LinphoneChatRoomStateTerminated,
+		                             initialPaulineStats.number_of_LinphoneChatRoomStateTerminated + 1,
+		                             liblinphone_tester_sip_timeout));
+		BC_ASSERT_PTR_NULL(pauline.getCore().findOneToOneChatRoom(paulineIdentity, marieIdentity, false, true, false));
+		BC_ASSERT_PTR_NULL(pauline.getCore().findChatRoom(previousConferenceId));
+		BC_ASSERT_PTR_NULL(paulineCore->findExumedChatRoomFromPreviousConferenceId(previousConferenceId));
+		paulineChatRoom = nullptr;
+
+		if (marieChatRoom) {
+			BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneChatRoomStateTerminated,
+			                             initialMarieStats.number_of_LinphoneChatRoomStateTerminated + 1,
+			                             liblinphone_tester_sip_timeout));
+			linphone_core_manager_delete_chat_room(marie.getCMgr(), marieChatRoom->toC(), coresList);
+		}
+
+		linphone_address_unref(confAddr);
+		bctbx_list_free(coresList);
+	}
+}
+
 static void one_to_one_chatroom_exhumed_while_offline(void) {
 	Focus focus("chloe_rc");
 	{ // to make sure focus is destroyed after clients.
@@ -3084,6 +3198,8 @@ static test_t local_conference_chat_basic_tests[] = {
     TEST_ONE_TAG("One to one chatroom exhumed while participant is offline",
                  LinphoneTest::one_to_one_chatroom_exhumed_while_offline,
                  "LeaksMemory"), /* because of network up and down*/
+    TEST_NO_TAG("One to one chatroom lookups through the core indexes",
+                LinphoneTest::one_to_one_chatroom_lookups_through_indexes),
     TEST_ONE_TAG("Group chat Server chat room deletion with remote list event handler",
                  LinphoneTest::group_chat_room_server_deletion_with_rmt_lst_event_handler,
                  "LeaksMemory") /* because of coreMgr restart*/
@@ -20,7 +20,11 @@
 
 #include "address/address.h"
 #include "c-wrapper/internal/c-tools.h"
+#include "call/call-log.h"
+#include "chat/chat-message/chat-message-p.h"
+#include "conference/conference.h"
 #include "core/core-p.h"
+#include "db/main-db-p.h"
 #include "db/main-db.h"
 #include "event-log/events.h"
 // TODO: Remove me.
@@ -46,12 +50,16 @@ public:
 	MainDbProvider() : MainDbProvider("db/linphone.db") {
 	}
 
-	MainDbProvider(const char *db_file) {
+	// The [storage] settings of enabledStorageSettings are enabled before the core is started.
+	MainDbProvider(const char *db_file, const list<string> &enabledStorageSettings = {}) {
 		mCoreManager = linphone_core_manager_create("empty_rc");
 		char *roDbPath = bc_tester_res(db_file);
 		char *rwDbPath = bc_tester_file(core_db);
 		BC_ASSERT_FALSE(liblinphone_tester_copy_file(roDbPath, rwDbPath));
-		linphone_config_set_string(linphone_core_get_config(mCoreManager->lc), "storage", "uri", rwDbPath);
+		LinphoneConfig *config = linphone_core_get_config(mCoreManager->lc);
+		linphone_config_set_string(config, "storage", "uri", rwDbPath);
+		for (const auto &setting : enabledStorageSettings)
+			linphone_config_set_bool(config, "storage", setting.c_str(), TRUE);
 		bc_free(roDbPath);
 		bc_free(rwDbPath);
 		linphone_core_manager_start(mCoreManager, false);
@@ -70,6 +78,10 @@ public:
 		linphone_core_manager_destroy(mCoreManager);
 	}
 
+	shared_ptr<Core> getCore() {
+		return mCoreManager->lc->cppPtr;
+	}
+
 	MainDb &getMainDb() {
 		return *L_GET_PRIVATE(mCoreManager->lc->cppPtr)->mainDb;
 	}
@@ -160,6 +172,514 @@ static void get_history(void) {
 	}
 }
 
+static void get_history_range_near(void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-1@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		const MainDb::FilterMask mask = MainDb::Filter::ConferenceChatMessageFilter;
+		const unsigned int pageSize = 20;
+
+		list<shared_ptr<EventLog>> fullHistory = mainDb.getHistoryRange(conferenceId, 0, -1, mask);
+		BC_ASSERT_EQUAL(fullHistory.size(), 804, size_t, "%zu");
+
+		// Scroll back through the whole history, one page at a time, using the oldest event of the previous page as
+		// the cursor of the next one.
+		list<shared_ptr<EventLog>> scrolledHistory = mainDb.getHistory(conferenceId, int(pageSize), mask);
+		BC_ASSERT_EQUAL(scrolledHistory.size(), pageSize, size_t, "%zu");
+		while (!scrolledHistory.empty()) {
+			list<shared_ptr<EventLog>> page =
+			    mainDb.getHistoryRangeNear(conferenceId, pageSize, 0, scrolledHistory.front(), mask);
+			if (page.empty()) break;
+
+			BC_ASSERT_LOWER(page.size(), pageSize + 1, size_t, "%zu");
+			scrolledHistory.insert(scrolledHistory.begin(), page.begin(), page.end());
+		}
+
+		BC_ASSERT_EQUAL(scrolledHistory.size(), fullHistory.size(), size_t, "%zu");
+		if (scrolledHistory.size() == fullHistory.size())
+			BC_ASSERT_TRUE(equal(scrolledHistory.begin(), scrolledHistory.end(), fullHistory.begin()));
+
+		// The deepest full page costs about as much as the most recent one: keep the best of a few runs of each to
+		// leave out scheduling noise, and allow a fixed margin for the timer resolution.
+		auto measurePageUs = [&](const shared_ptr<EventLog> &cursor) {
+			long bestUs = -1;
+			for (int i = 0; i < 5; i++) {
+				chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+				mainDb.getHistoryRangeNear(conferenceId, pageSize, 0, cursor, mask);
+				chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+				const long us = (long)chrono::duration_cast<chrono::microseconds>(end - start).count();
+				if (bestUs < 0 || us < bestUs) bestUs = us;
+			}
+			return bestUs;
+		};
+		const long firstPageUs = measurePageUs(*prev(fullHistory.end(), pageSize));
+		const long deepestPageUs = measurePageUs(*next(fullHistory.begin(), pageSize));
+		bctbx_message("History page latency: first page %li us, deepest page %li us", firstPageUs, deepestPageUs);
+		BC_ASSERT_LOWER(deepestPageUs, 3 * firstPageUs + 2000, long, "%li");
+
+		// Then walk forward from the oldest event.
+		const shared_ptr<EventLog> oldest = fullHistory.front();
+		list<shared_ptr<EventLog>> newer = mainDb.getHistoryRangeNear(conferenceId, 0, pageSize, oldest, mask);
+		BC_ASSERT_EQUAL(newer.size(), pageSize, size_t, "%zu");
+		if (!newer.empty()) BC_ASSERT_PTR_EQUAL(newer.front(), *next(fullHistory.begin()));
+		BC_ASSERT_EQUAL(mainDb.getHistoryRangeNear(conferenceId, pageSize, 0, oldest, mask).size(), 0, size_t, "%zu");
+
+		// A null cursor means the most recent events.
+		list<shared_ptr<EventLog>> mostRecent = mainDb.getHistoryRangeNear(conferenceId, pageSize, 0, nullptr, mask);
+		BC_ASSERT_EQUAL(mostRecent.size(), pageSize, size_t, "%zu");
+		if (!mostRecent.empty()) BC_ASSERT_PTR_EQUAL(mostRecent.back(), fullHistory.back());
+		BC_ASSERT_EQUAL(mainDb.getHistoryRangeNear(conferenceId, 0, pageSize, nullptr, mask).size(), 0, size_t, "%zu");
+
+		// The cursor must belong to the requested chat room.
+		const ConferenceId otherConferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                     Address::create("sip:test-1@sip.linphone.org"));
+		list<shared_ptr<EventLog>> otherHistory = mainDb.getHistory(otherConferenceId, 1, mask);
+		BC_ASSERT_EQUAL(otherHistory.size(), 1, size_t, "%zu");
+		if (!otherHistory.empty()) {
+			BC_ASSERT_EQUAL(
+			    mainDb.getHistoryRangeNear(conferenceId, pageSize, pageSize, otherHistory.front(), mask).size(), 0,
+			    size_t, "%zu");
+		}
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void prepared_statements_cache(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const DbSession &dbSession = L_GET_PRIVATE(&mainDb)->dbSession;
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+
+		// Each chat message count resolves one chat room id, its sip addresses are served by the sip address cache.
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		unsigned long hits = dbSession.getPreparedStatementHits();
+		unsigned long misses = dbSession.getPreparedStatementMisses();
+		for (int i = 0; i < 10; i++)
+			BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		BC_ASSERT_EQUAL(dbSession.getPreparedStatementMisses(), misses, unsigned long, "%lu");
+		BC_ASSERT_GREATER(dbSession.getPreparedStatementHits(), hits + 9, unsigned long, "%lu");
+		bctbx_message("Prepared statement cache: %lu hits, %lu misses", dbSession.getPreparedStatementHits(),
+		              dbSession.getPreparedStatementMisses());
+
+		// Statements must be prepared again on the new connection.
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		misses = dbSession.getPreparedStatementMisses();
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		BC_ASSERT_GREATER(dbSession.getPreparedStatementMisses(), misses, unsigned long, "%lu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void sip_address_cache(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const MainDbPrivate *d = L_GET_PRIVATE(&mainDb);
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+
+		// Cached addresses are not looked up in the database again.
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		const unsigned long misses = d->sipAddressCacheMisses;
+		for (int i = 0; i < 10; i++)
+			BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		BC_ASSERT_EQUAL(d->sipAddressCacheMisses, misses, unsigned long, "%lu");
+
+		// Addresses in use stay cached while more addresses than the cache can hold are stored.
+		LinphoneConfig *config = linphone_core_get_config(provider.getCore()->getCCore());
+		linphone_config_set_int(config, "storage", "sip_address_cache_size", LruCache<int, int>::MinCapacity);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		for (int i = 0; i <= LruCache<int, int>::MinCapacity; i++) {
+			mainDb.insertDevice(Address::create("sip:churn-" + to_string(i) + "@sip.linphone.org;gr=urn:uuid:" +
+			                                    to_string(i)),
+			                    "churn");
+			const unsigned long missesBefore = d->sipAddressCacheMisses;
+			BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+			BC_ASSERT_EQUAL(d->sipAddressCacheMisses, missesBefore, unsigned long, "%lu");
+		}
+
+		// Storing messages resolves the from and to addresses of each of them.
+		shared_ptr<AbstractChatRoom> chatRoom = provider.getCore()->findChatRoom(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(chatRoom);
+		if (chatRoom) {
+			for (int i = 0; i < 10; i++)
+				chatRoom->createChatMessageFromUtf8("Hello")->send();
+			BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 871, int, "%d");
+		}
+		bctbx_message("Sip address cache: %lu hits, %lu misses", d->sipAddressCacheHits, d->sipAddressCacheMisses);
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void sqlite_wal_storage_profile(void) {
+	// The database must be opened with WAL enabled to use a VFS providing shared memory.
+	MainDbProvider provider("db/linphone.db", {"sqlite3_wal_enabled"});
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const MainDbPrivate *d = L_GET_PRIVATE(&mainDb);
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		LinphoneConfig *config = linphone_core_get_config(provider.getCore()->getCCore());
+
+		linphone_config_set_string(config, "storage", "sqlite3_synchronous", "normal");
+		linphone_config_set_int(config, "storage", "sqlite3_cache_size", -4096);
+		linphone_config_set_int(config, "storage", "sqlite3_wal_checkpoint_interval", 0);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		BC_ASSERT_TRUE(mainDb.isInitialized());
+		string journalMode;
+		*d->dbSession.getBackendSession() << "PRAGMA journal_mode", soci::into(journalMode);
+		BC_ASSERT_STRING_EQUAL(Utils::stringToLower(journalMode).c_str(), "wal");
+		BC_ASSERT_TRUE(static_cast<bool>(d->readDbSession));
+
+		BC_ASSERT_EQUAL((int)mainDb.getHistoryRange(conferenceId, 0, 20).size(), 20, int, "%d");
+		shared_ptr<AbstractChatRoom> chatRoom = provider.getCore()->findChatRoom(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(chatRoom);
+		if (chatRoom) {
+			shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8("Hello");
+			message->send();
+			// Committed writes must be visible from the read connection.
+			list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, 0, 1);
+			BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+			if (!events.empty())
+				BC_ASSERT_TRUE(static_pointer_cast<ConferenceChatMessageEvent>(events.front())->getChatMessage() ==
+				               message);
+		}
+
+		linphone_config_set_bool(config, "storage", "sqlite3_wal_enabled", FALSE);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		*d->dbSession.getBackendSession() << "PRAGMA journal_mode", soci::into(journalMode);
+		BC_ASSERT_STRING_EQUAL(Utils::stringToLower(journalMode).c_str(), "delete");
+		BC_ASSERT_FALSE(static_cast<bool>(d->readDbSession));
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 862, int, "%d");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void write_behind_batch(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		LinphoneConfig *config = linphone_core_get_config(provider.getCore()->getCCore());
+		linphone_config_set_bool(config, "storage", "write_behind_enabled", TRUE);
+		linphone_config_set_int(config, "storage", "write_behind_max_delay_ms", 60000);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+
+		shared_ptr<AbstractChatRoom> chatRoom = provider.getCore()->findChatRoom(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(chatRoom);
+		if (!chatRoom) return;
+
+		auto start = chrono::high_resolution_clock::now();
+		shared_ptr<ChatMessage> lastMessage;
+		for (int i = 0; i < 50; i++) {
+			lastMessage = chatRoom->createChatMessageFromUtf8("Hello");
+			lastMessage->send();
+		}
+		auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+		bctbx_message("50 messages stored in %dms with write-behind", (int)ms);
+
+		// Batched writes are visible before being committed.
+		BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 911, int, "%d");
+		list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, 0, 1);
+		BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+		if (!events.empty())
+			BC_ASSERT_TRUE(static_pointer_cast<ConferenceChatMessageEvent>(events.front())->getChatMessage() ==
+			               lastMessage);
+
+		// The delay has not elapsed.
+		mainDb.flushPendingWritesIfNeeded();
+		BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+
+		BC_ASSERT_TRUE(mainDb.flushPendingWrites());
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+
+		// Committed writes survive a reconnection, a pending batch is flushed before it.
+		lastMessage = chatRoom->createChatMessageFromUtf8("Hello");
+		lastMessage->send();
+		BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+		linphone_config_set_bool(config, "storage", "write_behind_enabled", FALSE);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 912, int, "%d");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void write_behind_batch_commit_failure(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const MainDbPrivate *d = L_GET_PRIVATE(&mainDb);
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		LinphoneConfig *config = linphone_core_get_config(provider.getCore()->getCCore());
+		linphone_config_set_bool(config, "storage", "write_behind_enabled", TRUE);
+		linphone_config_set_int(config, "storage", "write_behind_max_delay_ms", 60000);
+		BC_ASSERT_TRUE(mainDb.forceReconnect());
+
+		shared_ptr<AbstractChatRoom> chatRoom = provider.getCore()->findChatRoom(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(chatRoom);
+		if (!chatRoom) return;
+		const int unreadCount = mainDb.getUnreadChatMessageCount(conferenceId);
+
+		list<shared_ptr<ChatMessage>> messages;
+		for (int i = 0; i < 5; i++) {
+			messages.push_back(chatRoom->createChatMessageFromUtf8("Hello"));
+			messages.back()->send();
+			BC_ASSERT_TRUE(messages.back()->isValid());
+		}
+		BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 866, int, "%d");
+
+		// A foreign key violation checked at commit time makes the whole batch fail.
+		soci::session *session = d->dbSession.getBackendSession();
+		*session << "PRAGMA defer_foreign_keys = ON";
+		*session << "INSERT INTO chat_room_participant (chat_room_id, participant_sip_address_id, is_admin)"
+		            " VALUES (-1, -1, 0)";
+		BC_ASSERT_FALSE(mainDb.flushPendingWrites());
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+
+		// The messages of the batch are not stored anymore.
+		for (const auto &message : messages)
+			BC_ASSERT_FALSE(message->isValid());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 861, int, "%d");
+		BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(conferenceId), unreadCount, int, "%d");
+		list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, 0, 1);
+		BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+		if (!events.empty())
+			BC_ASSERT_TRUE(static_pointer_cast<ConferenceChatMessageEvent>(events.front())->getChatMessage() !=
+			               messages.back());
+
+		// Later writes are stored.
+		chatRoom->createChatMessageFromUtf8("Hello")->send();
+		BC_ASSERT_TRUE(mainDb.flushPendingWrites());
+		BC_ASSERT_EQUAL(mainDb.getChatMessageCount(conferenceId), 862, int, "%d");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void write_batch_participant_states(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		list<shared_ptr<EventLog>> events =
+		    mainDb.getHistoryRange(conferenceId, 0, 1, MainDb::ConferenceChatMessageFilter);
+		BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+		if (events.empty()) return;
+
+		const shared_ptr<EventLog> &event = events.front();
+		const size_t initialCount = mainDb.getChatMessageParticipantStates(event).size();
+		const unique_ptr<MainDb> &mainDbPtr = L_GET_PRIVATE(provider.getCore())->mainDb;
+		auto start = chrono::high_resolution_clock::now();
+		{
+			MainDb::WriteBatch writeBatch(mainDbPtr);
+			for (int i = 0; i < 200; i++) {
+				auto address = Address::create("sip:participant-" + to_string(i) + "@sip.linphone.org");
+				mainDb.setChatMessageParticipantState(event, address, ChatMessage::State::DeliveredToUser,
+				                                      time(nullptr));
+				mainDb.setChatMessageParticipantState(event, address, ChatMessage::State::Displayed, time(nullptr));
+				// Displayed is never downgraded.
+				mainDb.setChatMessageParticipantState(event, address, ChatMessage::State::Delivered, time(nullptr));
+			}
+			BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+		}
+		auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+		bctbx_message("600 participant state updates stored in %dms in a single transaction", (int)ms);
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+
+		BC_ASSERT_EQUAL(mainDb.getChatMessageParticipantStates(event).size(), initialCount + 200, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.getChatMessageParticipantsByImdnState(event, ChatMessage::State::Displayed).size(),
+		                200, size_t, "%zu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void write_batch_keeps_loaded_messages(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		const unique_ptr<MainDb> &mainDbPtr = L_GET_PRIVATE(provider.getCore())->mainDb;
+		shared_ptr<EventLog> event;
+		shared_ptr<ChatMessage> message;
+		{
+			MainDb::WriteBatch writeBatch(mainDbPtr);
+			list<shared_ptr<EventLog>> events =
+			    mainDb.getHistoryRange(conferenceId, 0, 1, MainDb::ConferenceChatMessageFilter);
+			BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+			if (events.empty()) return;
+			event = events.front();
+			message = static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage();
+
+			// Makes the batch pending, then loads the message again from a read-only transaction.
+			mainDb.setChatMessageParticipantState(event, Address::create("sip:participant@sip.linphone.org"),
+			                                      ChatMessage::State::DeliveredToUser, time(nullptr));
+			BC_ASSERT_TRUE(mainDb.hasPendingWrites());
+			events = mainDb.getHistoryRange(conferenceId, 0, 1, MainDb::ConferenceChatMessageFilter);
+			BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+			if (!events.empty()) BC_ASSERT_TRUE(events.front() == event);
+		}
+		BC_ASSERT_FALSE(mainDb.hasPendingWrites());
+		BC_ASSERT_TRUE(message->isValid());
+
+		// The instances loaded during the batch are still the cached ones.
+		list<shared_ptr<EventLog>> events =
+		    mainDb.getHistoryRange(conferenceId, 0, 1, MainDb::ConferenceChatMessageFilter);
+		BC_ASSERT_EQUAL((int)events.size(), 1, int, "%d");
+		if (!events.empty()) {
+			BC_ASSERT_TRUE(events.front() == event);
+			BC_ASSERT_TRUE(static_pointer_cast<ConferenceChatMessageEvent>(events.front())->getChatMessage() ==
+			               message);
+		}
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void search_chat_messages(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		shared_ptr<AbstractChatRoom> chatRoom = provider.getCore()->findChatRoom(conferenceId);
+		BC_ASSERT_PTR_NOT_NULL(chatRoom);
+		if (!chatRoom) return;
+
+		// Index the existing history at once instead of waiting for the background backfill.
+		int chunks = 0;
+		auto start = chrono::high_resolution_clock::now();
+		while (mainDb.backfillChatMessageSearchIndex(100) && chunks < 100)
+			chunks++;
+		auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+		bctbx_message("Chat message search index backfilled in %dms", (int)ms);
+		BC_ASSERT_LOWER(chunks, 100, int, "%d");
+
+		const char *texts[] = {"The xylophonist played", "A xylophone", "Two xylophonists, one xylophone"};
+		list<shared_ptr<ChatMessage>> messages;
+		for (const char *text : texts) {
+			shared_ptr<ChatMessage> message = chatRoom->createChatMessageFromUtf8(text);
+			message->send();
+			messages.push_back(message);
+		}
+
+		BC_ASSERT_EQUAL(chatRoom->searchChatMessages("xylophon", 10, 0).size(), 3, size_t, "%zu");
+		BC_ASSERT_EQUAL(chatRoom->searchChatMessages("XYLOPHONE", 10, 0).size(), 2, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.searchChatMessages("xylophon").size(), 3, size_t, "%zu");
+		BC_ASSERT_EQUAL(chatRoom->searchChatMessages("", 10, 0).size(), 0, size_t, "%zu");
+
+		// Pagination.
+		list<shared_ptr<ChatMessage>> firstPage = chatRoom->searchChatMessages("xylophon", 2, 0);
+		list<shared_ptr<ChatMessage>> secondPage = chatRoom->searchChatMessages("xylophon", 2, 2);
+		BC_ASSERT_EQUAL(firstPage.size(), 2, size_t, "%zu");
+		BC_ASSERT_EQUAL(secondPage.size(), 1, size_t, "%zu");
+		if (!firstPage.empty() && !secondPage.empty()) {
+			BC_ASSERT_TRUE(find(firstPage.cbegin(), firstPage.cend(), secondPage.front()) == firstPage.cend());
+		}
+
+		// Deleted messages are removed from the index.
+		chatRoom->deleteMessageFromHistory(messages.front());
+		BC_ASSERT_EQUAL(chatRoom->searchChatMessages("xylophon", 10, 0).size(), 2, size_t, "%zu");
+
+		// Other chat rooms are not searched.
+		const ConferenceId otherConferenceId(Address::create("sip:test-7@sip.linphone.org")->getSharedFromThis(),
+		                                     Address::create("sip:test-7@sip.linphone.org"));
+		BC_ASSERT_EQUAL(mainDb.searchChatMessages("xylophon", otherConferenceId).size(), 0, size_t, "%zu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void call_history_lookups(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const shared_ptr<Address> local = Address::create("sip:call-history-local@sip.linphone.org");
+		const shared_ptr<Address> localWithGruu =
+		    Address::create("sip:call-history-local@sip.linphone.org;gr=urn:uuid:5b8f8a9e-e5e1-4bd3-9d4c-0cb7d7d5f5a1");
+		const shared_ptr<Address> peer = Address::create("sip:call-history-peer@sip.linphone.org");
+		const shared_ptr<Address> otherPeer = Address::create("sip:call-history-peer@sip.linphone.org.example");
+
+		mainDb.insertCallLog(CallLog::create(provider.getCore(), LinphoneCallOutgoing, local, peer));
+		mainDb.insertCallLog(CallLog::create(provider.getCore(), LinphoneCallOutgoing, localWithGruu, peer));
+		mainDb.insertCallLog(CallLog::create(provider.getCore(), LinphoneCallIncoming, peer, localWithGruu));
+		mainDb.insertCallLog(CallLog::create(provider.getCore(), LinphoneCallIncoming, otherPeer, local));
+		// Not a call of the local address: it is the callee of an outgoing call.
+		mainDb.insertCallLog(CallLog::create(provider.getCore(), LinphoneCallOutgoing, peer, local));
+
+		// Addresses with uri parameters match, addresses that only share a prefix do not.
+		BC_ASSERT_EQUAL(mainDb.getCallHistory(peer, local).size(), 3, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.getCallHistory(peer, local, 2).size(), 2, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.getCallHistory(otherPeer, local).size(), 1, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.getCallHistoryForLocalAddress(local, -1).size(), 4, size_t, "%zu");
+		BC_ASSERT_EQUAL(mainDb.getCallHistoryForLocalAddress(localWithGruu, -1).size(), 2, size_t, "%zu");
+		BC_ASSERT_EQUAL(
+		    mainDb.getCallHistoryForLocalAddress(Address::create("sip:call-history-unknown@sip.linphone.org"), -1)
+		        .size(),
+		    0, size_t, "%zu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
+static void prefetch_history_contents(void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	if (mainDb.isInitialized()) {
+		const ConferenceId conferenceId(Address::create("sip:test-3@sip.linphone.org")->getSharedFromThis(),
+		                                Address::create("sip:test-1@sip.linphone.org"));
+		LinphoneConfig *config = linphone_core_get_config(provider.getCore()->getCCore());
+
+		// Render the same 10 pages of 50 messages with lazy loading, then with prefetch.
+		size_t contentCounts[2] = {0, 0};
+		long durations[2] = {0, 0};
+		for (int prefetch = 0; prefetch < 2; prefetch++) {
+			linphone_config_set_bool(config, "storage", "history_contents_prefetch_enabled", prefetch);
+			BC_ASSERT_TRUE(mainDb.forceReconnect());
+
+			auto start = chrono::high_resolution_clock::now();
+			for (int page = 0; page < 10; page++) {
+				list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(conferenceId, page * 50, (page + 1) * 50,
+				                                                           MainDb::ConferenceChatMessageFilter);
+				BC_ASSERT_EQUAL((int)events.size(), 50, int, "%d");
+				for (const auto &event : events) {
+					shared_ptr<ChatMessage> message =
+					    static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage();
+					if (prefetch) BC_ASSERT_FALSE(L_GET_PRIVATE(message)->hasContentsNotLoadedFromDatabase());
+					contentCounts[prefetch] += message->getContents().size();
+				}
+			}
+			durations[prefetch] = (long)chrono::duration_cast<chrono::milliseconds>(
+			                          chrono::high_resolution_clock::now() - start)
+			                          .count();
+		}
+		bctbx_message("500 messages rendered in %ldms with lazy loading, %ldms with prefetch", durations[0],
+		              durations[1]);
+		BC_ASSERT_GREATER(contentCounts[1], 0, size_t, "%zu");
+		BC_ASSERT_EQUAL(contentCounts[0], contentCounts[1], size_t, "%zu");
+	} else {
+		BC_FAIL("Database not initialized");
+	}
+}
+
 static void get_conference_notified_events(void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -400,6 +920,44 @@ static void load_a_lot_of_chatrooms(void) {
 #endif
 }
 
+static void lazy_chat_room_loading(void) {
+	// Participant count of each chat room, loaded with the core.
+	list<pair<ConferenceId, size_t>> participantCounts;
+	long durationsMs[2];
+	for (int lazy = 0; lazy < 2; lazy++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		MainDbProvider provider("db/chatrooms.db",
+		                        lazy ? list<string>{"lazy_chat_room_loading_enabled"} : list<string>());
+		durationsMs[lazy] =
+		    (long)chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+		shared_ptr<Core> core = provider.getCore();
+		if (!lazy) {
+			for (const auto &chatRoom : core->getRawChatRoomList()) {
+				participantCounts.emplace_back(chatRoom->getConferenceId(), chatRoom->getParticipants().size());
+			}
+			continue;
+		}
+
+		BC_ASSERT_EQUAL(core->getRawChatRoomList().size(), participantCounts.size(), size_t, "%zu");
+		for (const auto &[conferenceId, participantCount] : participantCounts) {
+			shared_ptr<AbstractChatRoom> chatRoom = core->findChatRoom(conferenceId);
+			BC_ASSERT_PTR_NOT_NULL(chatRoom);
+			if (!chatRoom) continue;
+			const auto conference = chatRoom->getConference();
+			if (conference && chatRoom->getCurrentParams()->isGroup()) {
+				BC_ASSERT_FALSE(conference->participantsLoaded());
+			}
+			BC_ASSERT_EQUAL(chatRoom->getParticipants().size(), participantCount, size_t, "%zu");
+			if (conference) {
+				BC_ASSERT_TRUE(conference->participantsLoaded());
+				BC_ASSERT_PTR_NOT_NULL(conference->getMe());
+			}
+		}
+	}
+	bctbx_message("%zu chat rooms loaded in %ldms, %ldms without their participants", participantCounts.size(),
+	              durationsMs[0], durationsMs[1]);
+}
+
 static void load_chatroom_conference(void) {
 	MainDbProvider provider("db/chatroom_conference.db");
 	MainDb &mainDb = provider.getMainDb();
@@ -434,12 +992,24 @@ test_t main_db_tests[] = {TEST_NO_TAG("Get events count", get_events_count),
                           TEST_NO_TAG("Get messages count", get_messages_count),
                           TEST_NO_TAG("Get unread messages count", get_unread_messages_count),
                           TEST_NO_TAG("Get history", get_history),
+                          TEST_NO_TAG("Get history range near an event", get_history_range_near),
+                          TEST_NO_TAG("Prepared statements cache", prepared_statements_cache),
+                          TEST_NO_TAG("Sip address cache", sip_address_cache),
+                          TEST_NO_TAG("Sqlite WAL storage profile", sqlite_wal_storage_profile),
+                          TEST_NO_TAG("Write-behind batch", write_behind_batch),
+                          TEST_NO_TAG("Write-behind batch commit failure", write_behind_batch_commit_failure),
+                          TEST_NO_TAG("Write batch of participant states", write_batch_participant_states),
+                          TEST_NO_TAG("Write batch keeps loaded messages", write_batch_keeps_loaded_messages),
+                          TEST_NO_TAG("Search chat messages", search_chat_messages),
+                          TEST_NO_TAG("Call history lookups", call_history_lookups),
+                          TEST_NO_TAG("Prefetch history contents", prefetch_history_contents),
                           TEST_NO_TAG("Get conference events", get_conference_notified_events),
                           TEST_NO_TAG("Get chat rooms", get_chat_rooms),
                           TEST_NO_TAG("Set/get conference info", set_get_conference_info),
                           TEST_NO_TAG("Load chatroom and conference", load_chatroom_conference),
                           TEST_NO_TAG("Database with chatroom duplicates", database_with_chatroom_duplicates),
-                          TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms)};
+                          TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms),
+                          TEST_NO_TAG("Lazy chat room loading", lazy_chat_room_loading)};
 
 test_suite_t main_db_test_suite = {"MainDb",
                                    NULL,
@@ -496,6 +496,67 @@ static void create_two_basic_chat_room_with_same_remote(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static void lookup_in_many_basic_chat_rooms(void) {
+	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
+	const int count = 1000;
+	LinphoneChatRoom **chat_rooms = ms_new0(LinphoneChatRoom *, count);
+	LinphoneAddress **remote_addrs = ms_new0(LinphoneAddress *, count);
+
+	LinphoneChatRoomParams *chat_room_params = linphone_core_create_default_chat_room_params(pauline->lc);
+	linphone_chat_room_params_set_backend(chat_room_params, LinphoneChatRoomBackendBasic);
+	linphone_chat_room_params_enable_encryption(chat_room_params, FALSE);
+	linphone_chat_room_params_enable_group(chat_room_params, FALSE);
+	uint64_t start = bctbx_get_cur_time_ms();
+	for (int i = 0; i < count; i++) {
+		char uri[64];
+		snprintf(uri, sizeof(uri), "sip:remote%d@sip.example.org", i);
+		remote_addrs[i] = linphone_address_new(uri);
+		bctbx_list_t *participants = bctbx_list_append(NULL, remote_addrs[i]);
+		chat_rooms[i] =
+		    linphone_core_create_chat_room_6(pauline->lc, chat_room_params, pauline->identity, participants);
+		bctbx_list_free(participants);
+	}
+	ms_message("%d basic chat rooms created in %llu ms", count,
+	           (unsigned long long)(bctbx_get_cur_time_ms() - start));
+
+	int found = 0;
+	start = bctbx_get_cur_time_ms();
+	for (int i = 0; i < count; i++) {
+		if (chat_rooms[i] &&
+		    linphone_core_search_chat_room(pauline->lc, NULL, pauline->identity, remote_addrs[i], NULL) ==
+		        chat_rooms[i])
+			found++;
+	}
+	ms_message("%d basic chat rooms searched in %llu ms", count,
+	           (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL(found, count, int, "%d");
+
+	found = 0;
+	start = bctbx_get_cur_time_ms();
+	for (int i = 0; i < count; i++) {
+		if (chat_rooms[i] && linphone_core_find_one_to_one_chat_room_2(pauline->lc, pauline->identity,
+		                                                               remote_addrs[i], FALSE) == chat_rooms[i])
+			found++;
+	}
+	ms_message("%d one-to-one chat rooms found in %llu ms", count,
+	           (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	BC_ASSERT_EQUAL(found, count, int, "%d");
+
+	/* An unknown remote address must not match any of them. */
+	LinphoneAddress *unknown_addr = linphone_address_new("sip:unknown@sip.example.org");
+	BC_ASSERT_PTR_NULL(linphone_core_search_chat_room(pauline->lc, NULL, pauline->identity, unknown_addr, NULL));
+	linphone_address_unref(unknown_addr);
+
+	for (int i = 0; i < count; i++) {
+		if (chat_rooms[i]) linphone_chat_room_unref(chat_rooms[i]);
+		linphone_address_unref(remote_addrs[i]);
+	}
+	ms_free(chat_rooms);
+	ms_free(remote_addrs);
+	linphone_chat_room_params_unref(chat_room_params);
+	linphone_core_manager_destroy(pauline);
+}
+
 static void text_message(void) {
 	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
 	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
@@ -3952,6 +4013,7 @@ static void received_messages_with_aggregation_enabled(void) {
 test_t message_tests[] = {
     TEST_NO_TAG("File transfer content", file_transfer_content),
     TEST_NO_TAG("Create two basic chat rooms with same remote", create_two_basic_chat_room_with_same_remote),
+    TEST_NO_TAG("Lookup in many basic chat rooms", lookup_in_many_basic_chat_rooms),
     TEST_NO_TAG("Text message", text_message),
     TEST_NO_TAG("Text forward message", text_forward_message),
     TEST_NO_TAG("Text forward message with CPIM enabled with backward compat",
@@ -1068,6 +1068,104 @@ static void presence_list_subscribe_network_changes(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static void rlmi_presence_received(LinphoneFriendList *list, const bctbx_list_t *friends) {
+	int *counter = (int *)linphone_friend_list_cbs_get_user_data(linphone_friend_list_get_current_callbacks(list));
+	*counter += (int)bctbx_list_size(friends);
+}
+
+static LinphoneContent *create_rlmi_list_notify(LinphoneCore *lc, int resourceCount, int version) {
+	const size_t bodySize = (size_t)resourceCount * 640 + 1024;
+	char *body = ms_malloc(bodySize);
+	size_t offset = 0;
+	LinphoneContent *content;
+	int i;
+
+	offset += snprintf(body + offset, bodySize - offset,
+	                   "--rlmi-boundary\r\nContent-Transfer-Encoding: binary\r\nContent-Id: rlmi\r\n"
+	                   "Content-Type: application/rlmi+xml;charset=\"UTF-8\"\r\n\r\n"
+	                   "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+	                   "<list xmlns=\"urn:ietf:params:xml:ns:rlmi\" uri=\"sip:rls@sip.example.org\" version=\"%d\" "
+	                   "fullState=\"%s\">",
+	                   version, version == 0 ? "true" : "false");
+	for (i = 0; i < resourceCount; i++) {
+		offset += snprintf(body + offset, bodySize - offset,
+		                   "<resource uri=\"sip:user%d@sip.example.org\"><name>User %d</name>"
+		                   "<instance id=\"i%d\" state=\"active\" cid=\"part%d\"/></resource>",
+		                   i, i, i, i);
+	}
+	offset += snprintf(body + offset, bodySize - offset, "</list>\r\n");
+	for (i = 0; i < resourceCount; i++) {
+		offset += snprintf(body + offset, bodySize - offset,
+		                   "--rlmi-boundary\r\nContent-Transfer-Encoding: binary\r\nContent-Id: part%d\r\n"
+		                   "Content-Type: application/pidf+xml;charset=\"UTF-8\"\r\n\r\n"
+		                   "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+		                   "<presence xmlns=\"urn:ietf:params:xml:ns:pidf\" entity=\"sip:user%d@sip.example.org\">"
+		                   "<tuple id=\"t%d\"><status><basic>%s</basic></status></tuple></presence>\r\n",
+		                   i, i, i, version % 2 == 0 ? "open" : "closed");
+	}
+	offset += snprintf(body + offset, bodySize - offset, "--rlmi-boundary--\r\n");
+
+	content = linphone_core_create_content(lc);
+	linphone_content_set_type(content, "multipart");
+	linphone_content_set_subtype(content, "related");
+	linphone_content_set_buffer(content, (const uint8_t *)body, offset);
+	ms_free(body);
+	return content;
+}
+
+static void presence_list_large_notify_replay(void) {
+	const int resourceCount = 5000;
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendListCbs *cbs = linphone_factory_create_friend_list_cbs(linphone_factory_get());
+	LinphoneFriendList *lfl;
+	LinphoneFriend *lf;
+	LinphoneContent *content;
+	uint64_t start;
+	int presenceReceivedCount = 0;
+	int version, i;
+
+	// The synthetic friends do not need to be stored.
+	linphone_config_set_int(linphone_core_get_config(manager->lc), "misc", "store_friends", 0);
+	lfl = linphone_core_create_friend_list(manager->lc);
+	linphone_friend_list_enable_subscriptions(lfl, FALSE);
+	linphone_friend_list_cbs_set_presence_received(cbs, rlmi_presence_received);
+	linphone_friend_list_cbs_set_user_data(cbs, &presenceReceivedCount);
+	linphone_friend_list_add_callbacks(lfl, cbs);
+	linphone_friend_list_cbs_unref(cbs);
+	linphone_core_add_friend_list(manager->lc, lfl);
+	for (i = 0; i < resourceCount; i++) {
+		char uri[64];
+		snprintf(uri, sizeof(uri), "sip:user%d@sip.example.org", i);
+		lf = linphone_core_create_friend_with_address(manager->lc, uri);
+		linphone_friend_enable_subscribes(lf, FALSE);
+		linphone_friend_list_add_local_friend(lfl, lf);
+		linphone_friend_unref(lf);
+	}
+
+	// Replay a full state NOTIFY followed by a partial one.
+	for (version = 0; version < 2; version++) {
+		presenceReceivedCount = 0;
+		content = create_rlmi_list_notify(manager->lc, resourceCount, version);
+		start = bctbx_get_cur_time_ms();
+		linphone_friend_list_notify_presence_received(lfl, NULL, content);
+		ms_message("Parsed list NOTIFY version %d with %d resources in %llu ms", version, resourceCount,
+		           (unsigned long long)(bctbx_get_cur_time_ms() - start));
+		linphone_content_unref(content);
+		BC_ASSERT_EQUAL(presenceReceivedCount, resourceCount, int, "%d");
+	}
+
+	lf = linphone_friend_list_find_friend_by_uri(lfl, "sip:user4242@sip.example.org");
+	if (BC_ASSERT_PTR_NOT_NULL(lf)) {
+		BC_ASSERT_STRING_EQUAL(linphone_friend_get_name(lf), "User 4242");
+		BC_ASSERT_PTR_NOT_NULL(linphone_friend_get_presence_model(lf));
+		BC_ASSERT_EQUAL(linphone_friend_get_consolidated_presence(lf), LinphoneConsolidatedPresenceOffline, int,
+		                "%d");
+	}
+
+	linphone_friend_list_unref(lfl);
+	linphone_core_manager_destroy(manager);
+}
+
 static void long_term_presence_base(const char *addr, bool_t exist, const char *contact) {
 	LinphoneFriend *friend2;
 	const LinphonePresenceModel *model;
@@ -2629,6 +2727,7 @@ test_t presence_server_tests[] = {
     TEST_NO_TAG("Presence list, silent subscription expiration", presence_list_subscribe_dialog_expire),
     TEST_NO_TAG("Presence list, io error", presence_list_subscribe_io_error),
     TEST_NO_TAG("Presence list, network changes", presence_list_subscribe_network_changes),
+    TEST_NO_TAG("Presence list, large NOTIFY replay", presence_list_large_notify_replay),
     TEST_ONE_TAG("Long term presence existing friend", long_term_presence_existing_friend, "longterm"),
     TEST_ONE_TAG("Long term presence inexistent friend", long_term_presence_inexistent_friend, "longterm"),
     TEST_ONE_TAG("Long term presence phone alias", long_term_presence_phone_alias, "longterm"),
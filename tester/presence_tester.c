@@ -450,6 +450,159 @@ static void simple_subscribe_with_friend_from_rc(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static const char *pidf_conformance_documents[] = {
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<presence xmlns=\"urn:ietf:params:xml:ns:pidf\" xmlns:dm=\"urn:ietf:params:xml:ns:pidf:data-model\" "
+    "xmlns:rpid=\"urn:ietf:params:xml:ns:pidf:rpid\" xmlns:pidfonline=\"http://www.linphone.org/xsds/pidfonline.xsd\" "
+    "xmlns:oma-pres=\"urn:oma:xml:prs:pidf:oma-pres\" entity=\"sip:pauline@sip.example.org\">"
+    "<tuple id=\"tuple1\"><status><basic>open</basic><pidfonline:online/></status>"
+    "<contact>sip:pauline@192.168.0.1</contact><timestamp>2024-03-01T10:20:30Z</timestamp>"
+    "<oma-pres:service-description><oma-pres:service-id>groupchat</oma-pres:service-id>"
+    "<oma-pres:version>1.2</oma-pres:version></oma-pres:service-description>"
+    "<oma-pres:service-description><oma-pres:service-id>lime</oma-pres:service-id></oma-pres:service-description>"
+    "<note xml:lang=\"fr\">Bonjour</note><note>Hello</note></tuple>"
+    "<tuple id=\"tuple2\"><status/></tuple>"
+    "<tuple id=\"tuple3\"><status><basic>closed</basic></status><contact>sip:pauline@10.0.0.1</contact></tuple>"
+    "<dm:person id=\"person1\"><rpid:activities><rpid:away>Gone <em>fishing</em></rpid:away>"
+    "<rpid:note xml:lang=\"en\">Back soon</rpid:note><rpid:on-the-phone/></rpid:activities>"
+    "<dm:timestamp>2024-03-01T10:20:30Z</dm:timestamp><dm:note>Person note</dm:note></dm:person>"
+    "<dm:person id=\"person2\"/>"
+    "<note xml:lang=\"en\">Presence note</note></presence>",
+    "<presence xmlns=\"urn:ietf:params:xml:ns:pidf\" entity=\"sip:marie@sip.example.org\">"
+    "<tuple id=\"t\"><status><basic>maybe</basic></status></tuple></presence>",
+    "<presence xmlns=\"urn:ietf:params:xml:ns:pidf\"><tuple id=\"t\"><status><basic>open</basic></status>",
+    "<other xmlns=\"urn:ietf:params:xml:ns:pidf\"><tuple id=\"t\"/></other>",
+};
+
+static void check_presence_strings(char *streaming, char *xpath) {
+	BC_ASSERT_STRING_EQUAL(streaming ? streaming : "", xpath ? xpath : "");
+	if (streaming) bctbx_free(streaming);
+	if (xpath) bctbx_free(xpath);
+}
+
+static void check_presence_notes(const LinphonePresenceNote *streaming, const LinphonePresenceNote *xpath) {
+	if (!BC_ASSERT_PTR_NOT_NULL(streaming) || !BC_ASSERT_PTR_NOT_NULL(xpath)) return;
+	BC_ASSERT_STRING_EQUAL(linphone_presence_note_get_content(streaming), linphone_presence_note_get_content(xpath));
+	BC_ASSERT_STRING_EQUAL(linphone_presence_note_get_lang(streaming) ? linphone_presence_note_get_lang(streaming) : "",
+	                       linphone_presence_note_get_lang(xpath) ? linphone_presence_note_get_lang(xpath) : "");
+}
+
+static void check_presence_models(const LinphonePresenceModel *streaming, const LinphonePresenceModel *xpath) {
+	unsigned int i, j, nb;
+	BC_ASSERT_EQUAL(linphone_presence_model_is_online(streaming), linphone_presence_model_is_online(xpath), int, "%d");
+	BC_ASSERT_EQUAL(linphone_presence_model_get_basic_status(streaming),
+	                linphone_presence_model_get_basic_status(xpath), int, "%d");
+	BC_ASSERT_EQUAL(linphone_presence_model_get_consolidated_presence(streaming),
+	                linphone_presence_model_get_consolidated_presence(xpath), int, "%d");
+	BC_ASSERT_EQUAL(linphone_presence_model_get_capabilities(streaming),
+	                linphone_presence_model_get_capabilities(xpath), int, "%d");
+	BC_ASSERT_EQUAL((long)linphone_presence_model_get_timestamp(streaming),
+	                (long)linphone_presence_model_get_timestamp(xpath), long, "%ld");
+	check_presence_strings(linphone_presence_model_get_contact(streaming), linphone_presence_model_get_contact(xpath));
+	if (linphone_presence_model_get_note(xpath, NULL))
+		check_presence_notes(linphone_presence_model_get_note(streaming, NULL),
+		                     linphone_presence_model_get_note(xpath, NULL));
+
+	nb = linphone_presence_model_get_nb_services(xpath);
+	BC_ASSERT_EQUAL(linphone_presence_model_get_nb_services(streaming), nb, unsigned int, "%u");
+	if (linphone_presence_model_get_nb_services(streaming) != nb) return;
+	for (i = 0; i < nb; i++) {
+		LinphonePresenceService *streamingService = linphone_presence_model_get_nth_service(streaming, i);
+		LinphonePresenceService *xpathService = linphone_presence_model_get_nth_service(xpath, i);
+		check_presence_strings(linphone_presence_service_get_id(streamingService),
+		                       linphone_presence_service_get_id(xpathService));
+		check_presence_strings(linphone_presence_service_get_contact(streamingService),
+		                       linphone_presence_service_get_contact(xpathService));
+		BC_ASSERT_EQUAL(linphone_presence_service_get_basic_status(streamingService),
+		                linphone_presence_service_get_basic_status(xpathService), int, "%d");
+		BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_presence_service_get_service_descriptions(streamingService)),
+		                (int)bctbx_list_size(linphone_presence_service_get_service_descriptions(xpathService)), int,
+		                "%d");
+		BC_ASSERT_EQUAL(linphone_presence_service_get_nb_notes(streamingService),
+		                linphone_presence_service_get_nb_notes(xpathService), unsigned int, "%u");
+		for (j = 0; j < linphone_presence_service_get_nb_notes(xpathService); j++)
+			check_presence_notes(linphone_presence_service_get_nth_note(streamingService, j),
+			                     linphone_presence_service_get_nth_note(xpathService, j));
+	}
+
+	nb = linphone_presence_model_get_nb_persons(xpath);
+	BC_ASSERT_EQUAL(linphone_presence_model_get_nb_persons(streaming), nb, unsigned int, "%u");
+	if (linphone_presence_model_get_nb_persons(streaming) != nb) return;
+	for (i = 0; i < nb; i++) {
+		LinphonePresencePerson *streamingPerson = linphone_presence_model_get_nth_person(streaming, i);
+		LinphonePresencePerson *xpathPerson = linphone_presence_model_get_nth_person(xpath, i);
+		check_presence_strings(linphone_presence_person_get_id(streamingPerson),
+		                       linphone_presence_person_get_id(xpathPerson));
+		BC_ASSERT_EQUAL(linphone_presence_person_get_nb_activities(streamingPerson),
+		                linphone_presence_person_get_nb_activities(xpathPerson), unsigned int, "%u");
+		for (j = 0; j < linphone_presence_person_get_nb_activities(xpathPerson); j++) {
+			LinphonePresenceActivity *streamingActivity = linphone_presence_person_get_nth_activity(streamingPerson, j);
+			LinphonePresenceActivity *xpathActivity = linphone_presence_person_get_nth_activity(xpathPerson, j);
+			if (!BC_ASSERT_PTR_NOT_NULL(streamingActivity)) break;
+			BC_ASSERT_EQUAL(linphone_presence_activity_get_type(streamingActivity),
+			                linphone_presence_activity_get_type(xpathActivity), int, "%d");
+			BC_ASSERT_STRING_EQUAL(linphone_presence_activity_get_description(streamingActivity)
+			                           ? linphone_presence_activity_get_description(streamingActivity)
+			                           : "",
+			                       linphone_presence_activity_get_description(xpathActivity)
+			                           ? linphone_presence_activity_get_description(xpathActivity)
+			                           : "");
+		}
+		BC_ASSERT_EQUAL(linphone_presence_person_get_nb_activities_notes(streamingPerson),
+		                linphone_presence_person_get_nb_activities_notes(xpathPerson), unsigned int, "%u");
+		for (j = 0; j < linphone_presence_person_get_nb_activities_notes(xpathPerson); j++)
+			check_presence_notes(linphone_presence_person_get_nth_activities_note(streamingPerson, j),
+			                     linphone_presence_person_get_nth_activities_note(xpathPerson, j));
+		BC_ASSERT_EQUAL(linphone_presence_person_get_nb_notes(streamingPerson),
+		                linphone_presence_person_get_nb_notes(xpathPerson), unsigned int, "%u");
+		for (j = 0; j < linphone_presence_person_get_nb_notes(xpathPerson); j++)
+			check_presence_notes(linphone_presence_person_get_nth_note(streamingPerson, j),
+			                     linphone_presence_person_get_nth_note(xpathPerson, j));
+	}
+}
+
+static void presence_pidf_parsers(void) {
+	const int iterations = 5000;
+	LinphonePresenceModel *streaming, *xpath;
+	uint64_t start, streamingTime, xpathTime;
+	size_t i;
+	int k;
+
+	// Both parsers must build the same model, or both reject the document.
+	for (i = 0; i < sizeof(pidf_conformance_documents) / sizeof(pidf_conformance_documents[0]); i++) {
+		linphone_presence_model_enable_streaming_pidf_parser(TRUE);
+		streaming = linphone_presence_model_parse_pidf(pidf_conformance_documents[i]);
+		linphone_presence_model_enable_streaming_pidf_parser(FALSE);
+		xpath = linphone_presence_model_parse_pidf(pidf_conformance_documents[i]);
+		BC_ASSERT_EQUAL(streaming != NULL, xpath != NULL, int, "%d");
+		if (streaming && xpath) check_presence_models(streaming, xpath);
+		if (streaming) linphone_presence_model_unref(streaming);
+		if (xpath) linphone_presence_model_unref(xpath);
+	}
+
+	linphone_presence_model_enable_streaming_pidf_parser(TRUE);
+	streaming = linphone_presence_model_parse_pidf(pidf_conformance_documents[0]);
+	if (BC_ASSERT_PTR_NOT_NULL(streaming)) {
+		BC_ASSERT_EQUAL(linphone_presence_model_get_nb_services(streaming), 2, unsigned int, "%u");
+		BC_ASSERT_EQUAL(linphone_presence_model_get_nb_persons(streaming), 2, unsigned int, "%u");
+		BC_ASSERT_TRUE(linphone_presence_model_is_online(streaming));
+		linphone_presence_model_unref(streaming);
+	}
+
+	linphone_presence_model_enable_streaming_pidf_parser(FALSE);
+	start = bctbx_get_cur_time_ms();
+	for (k = 0; k < iterations; k++)
+		linphone_presence_model_unref(linphone_presence_model_parse_pidf(pidf_conformance_documents[0]));
+	xpathTime = bctbx_get_cur_time_ms() - start;
+	linphone_presence_model_enable_streaming_pidf_parser(TRUE);
+	start = bctbx_get_cur_time_ms();
+	for (k = 0; k < iterations; k++)
+		linphone_presence_model_unref(linphone_presence_model_parse_pidf(pidf_conformance_documents[0]));
+	streamingTime = bctbx_get_cur_time_ms() - start;
+	ms_message("Parsed %d PIDF documents in %llu ms with the streaming parser, %llu ms with the XPath parser",
+	           iterations, (unsigned long long)streamingTime, (unsigned long long)xpathTime);
+}
+
 test_t presence_tests[] = {
     TEST_ONE_TAG("Simple Subscribe", simple_subscribe, "presence"),
     TEST_ONE_TAG("Simple Subscribe with early NOTIFY", simple_subscribe_with_early_notify, "presence"),
@@ -457,6 +610,7 @@ test_t presence_tests[] = {
     /*TEST_ONE_TAG("Call with presence", call_with_presence, "LeaksMemory"),*/
     TEST_NO_TAG("Unsubscribe while subscribing", unsubscribe_while_subscribing),
     TEST_NO_TAG("Presence information", presence_information),
+    TEST_NO_TAG("Presence PIDF parsers", presence_pidf_parsers),
     TEST_ONE_TAG("App managed presence failure", subscribe_failure_handle_by_app, "presence"),
     TEST_NO_TAG("Presence SUBSCRIBE forked", subscribe_presence_forked),
     TEST_NO_TAG("Presence SUBSCRIBE expired", subscribe_presence_expired),
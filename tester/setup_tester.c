@@ -47,6 +47,10 @@
 #include "TargetConditionals.h"
 #endif
 
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
 #define S_SIZE_FRIEND 12
 static const unsigned int sSizeFriend = S_SIZE_FRIEND;
 static const char *sFriends[S_SIZE_FRIEND] = {
@@ -427,6 +431,38 @@ static void linphone_address_test(void) {
 	linphone_address_unref(address);
 }
 
+static void linphone_address_cache_test(void) {
+	LinphoneFactory *factory = linphone_factory_get();
+	const int capacity = linphone_factory_get_address_cache_capacity(factory);
+	char uri[64];
+
+	linphone_factory_set_address_cache_capacity(factory, 10);
+	BC_ASSERT_EQUAL(linphone_factory_get_address_cache_capacity(factory), 10, int, "%d");
+	BC_ASSERT_EQUAL(linphone_factory_get_address_cache_size(factory), 0, int, "%d");
+
+	uint64_t hits = linphone_factory_get_address_cache_hits(factory);
+	uint64_t misses = linphone_factory_get_address_cache_misses(factory);
+	uint64_t evictions = linphone_factory_get_address_cache_evictions(factory);
+	for (int i = 0; i < 15; i++) {
+		snprintf(uri, sizeof(uri), "sip:address-cache-%d@sip.example.org", i);
+		linphone_address_unref(linphone_address_new(uri));
+	}
+	BC_ASSERT_EQUAL(linphone_factory_get_address_cache_size(factory), 10, int, "%d");
+	BC_ASSERT_EQUAL((int)(linphone_factory_get_address_cache_misses(factory) - misses), 15, int, "%d");
+	BC_ASSERT_EQUAL((int)(linphone_factory_get_address_cache_evictions(factory) - evictions), 5, int, "%d");
+
+	// The least recently used address is evicted first.
+	linphone_address_unref(linphone_address_new("sip:address-cache-5@sip.example.org"));
+	linphone_address_unref(linphone_address_new("sip:address-cache-15@sip.example.org"));
+	linphone_address_unref(linphone_address_new("sip:address-cache-5@sip.example.org"));
+	linphone_address_unref(linphone_address_new("sip:address-cache-6@sip.example.org"));
+	BC_ASSERT_EQUAL((int)(linphone_factory_get_address_cache_hits(factory) - hits), 2, int, "%d");
+	BC_ASSERT_EQUAL((int)(linphone_factory_get_address_cache_misses(factory) - misses), 17, int, "%d");
+	BC_ASSERT_EQUAL(linphone_factory_get_address_cache_size(factory), 10, int, "%d");
+
+	linphone_factory_set_address_cache_capacity(factory, capacity);
+}
+
 static void core_sip_transport_test(void) {
 	LinphoneCore *lc;
 	LCSipTransports tr;
@@ -600,6 +636,86 @@ static void linphone_config_safety_test(void) {
 	bctbx_free(tmpfile);
 }
 
+static void linphone_config_background_sync_test(void) {
+	char *res = bc_tester_res("rcfiles/marie_rc");
+	char *file = bc_tester_file("bg_sync_marie_rc");
+	char *tmpfile = bctbx_strdup_printf("%s.tmp", file);
+	char value[32];
+	int i;
+
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(res, file), 0, int, "%d");
+
+	LinphoneConfig *cfg = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(cfg);
+	linphone_config_enable_background_sync(cfg, TRUE);
+	BC_ASSERT_TRUE(linphone_config_background_sync_enabled(cfg));
+	/* a burst of changes, each of them handed to the writer */
+	for (i = 0; i < 50; i++) {
+		snprintf(value, sizeof(value), "value%i", i);
+		linphone_config_set_string(cfg, "misc", "somekey", value);
+		BC_ASSERT_EQUAL(linphone_config_sync(cfg), 0, int, "%d");
+		BC_ASSERT_FALSE(linphone_config_needs_commit(cfg));
+	}
+	BC_ASSERT_EQUAL(linphone_config_flush(cfg), 0, int, "%d");
+	BC_ASSERT_TRUE(bctbx_file_exist(tmpfile) == -1);
+
+	/* the last snapshot is on disk, in the usual format */
+	LinphoneConfig *written = linphone_config_new(file);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(written, "proxy_0", "realm", NULL), "sip.example.org");
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(written, "misc", "somekey", NULL), "value49");
+	linphone_config_destroy(written);
+
+	/* disabling, as destroying the config, writes the pending snapshot */
+	linphone_config_set_string(cfg, "misc", "somekey", "last");
+	linphone_config_sync(cfg);
+	linphone_config_enable_background_sync(cfg, FALSE);
+	BC_ASSERT_FALSE(linphone_config_background_sync_enabled(cfg));
+	linphone_config_destroy(cfg);
+	cfg = linphone_config_new(file);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "misc", "somekey", NULL), "last");
+	linphone_config_destroy(cfg);
+
+	unlink(file);
+	bc_free(res);
+	bc_free(file);
+	bctbx_free(tmpfile);
+}
+
+#ifndef _WIN32
+static void linphone_config_rename_failure_test(void) {
+	char *res = bc_tester_res("rcfiles/marie_rc");
+	char *file = bc_tester_file("rename_failure_marie_rc");
+	char *tmpfile = bctbx_strdup_printf("%s.tmp", file);
+
+	BC_ASSERT_EQUAL(liblinphone_tester_copy_file(res, file), 0, int, "%d");
+	LinphoneConfig *cfg = linphone_config_new(file);
+	BC_ASSERT_PTR_NOT_NULL(cfg);
+
+	/* the written file cannot replace a directory */
+	unlink(file);
+	BC_ASSERT_EQUAL(mkdir(file, S_IRWXU), 0, int, "%d");
+	linphone_config_set_string(cfg, "misc", "somekey", "somevalue");
+	BC_ASSERT_EQUAL(linphone_config_sync(cfg), -1, int, "%d");
+	BC_ASSERT_TRUE(linphone_config_needs_commit(cfg));
+
+	/* the config is not made read-only, the next sync writes it */
+	BC_ASSERT_EQUAL(rmdir(file), 0, int, "%d");
+	BC_ASSERT_EQUAL(linphone_config_sync(cfg), 0, int, "%d");
+	BC_ASSERT_FALSE(linphone_config_needs_commit(cfg));
+	BC_ASSERT_TRUE(bctbx_file_exist(tmpfile) == -1);
+	linphone_config_destroy(cfg);
+
+	cfg = linphone_config_new(file);
+	BC_ASSERT_STRING_EQUAL(linphone_config_get_string(cfg, "misc", "somekey", NULL), "somevalue");
+	linphone_config_destroy(cfg);
+
+	unlink(file);
+	bc_free(res);
+	bc_free(file);
+	bctbx_free(tmpfile);
+}
+#endif
+
 static void linphone_lpconfig_from_buffer(void) {
 	const char *buffer = "[buffer]\ntest=ok";
 	const char *buffer_linebreaks = "[buffer_linebreaks]\n\n\n\r\n\n\r\ntest=ok";
@@ -614,6 +730,58 @@ static void linphone_lpconfig_from_buffer(void) {
 	linphone_config_destroy(conf);
 }
 
+static void linphone_lpconfig_lookup_benchmark(void) {
+	const int section_count = 40;
+	const int key_count = 50;
+	const int iterations = 100;
+	char section[32];
+	char key[32];
+	const size_t buffer_size = 64 * 1024;
+	size_t length = 0;
+	int i, j, k;
+	int sum = 0;
+	uint64_t start, elapsed;
+	LpConfig *conf;
+	char *buffer = ms_malloc0(buffer_size);
+
+	/* A linphonerc-like file of 2000 entries. */
+	for (i = 0; i < section_count; i++) {
+		length += (size_t)snprintf(buffer + length, buffer_size - length, "[section_%i]\n", i);
+		for (j = 0; j < key_count; j++)
+			length += (size_t)snprintf(buffer + length, buffer_size - length, "key_%i=%i\n", j, i * key_count + j);
+	}
+	conf = linphone_config_new_from_buffer(buffer);
+	ms_free(buffer);
+
+	start = bctbx_get_cur_time_ms();
+	for (k = 0; k < iterations; k++) {
+		for (i = 0; i < section_count; i++) {
+			snprintf(section, sizeof(section), "section_%i", i);
+			for (j = 0; j < key_count; j++) {
+				snprintf(key, sizeof(key), "key_%i", j);
+				sum += linphone_config_get_int(conf, section, key, -1) == i * key_count + j;
+			}
+		}
+	}
+	elapsed = bctbx_get_cur_time_ms() - start;
+	BC_ASSERT_EQUAL(sum, iterations * section_count * key_count, int, "%d");
+	ms_message("%d lookups over %d entries done in %llu ms", iterations * section_count * key_count,
+	           section_count * key_count, (unsigned long long)elapsed);
+
+	/* The index and cached values must follow modifications. */
+	linphone_config_set_int(conf, "section_3", "key_7", 42);
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_3", "key_7", -1), 42, int, "%d");
+	linphone_config_clean_entry(conf, "section_3", "key_7");
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_3", "key_7", -1), -1, int, "%d");
+	BC_ASSERT_FALSE(linphone_config_has_entry(conf, "section_3", "key_7"));
+	linphone_config_clean_section(conf, "section_4");
+	BC_ASSERT_FALSE(linphone_config_has_section(conf, "section_4"));
+	linphone_config_set_bool(conf, "section_4", "enabled", TRUE);
+	BC_ASSERT_TRUE(linphone_config_get_bool(conf, "section_4", "enabled", FALSE));
+	BC_ASSERT_EQUAL(linphone_config_get_int(conf, "section_4", "key_0", -1), -1, int, "%d");
+	linphone_config_destroy(conf);
+}
+
 static void linphone_lpconfig_from_buffer_zerolen_value(void) {
 	/* parameters that have no value should return NULL, not "". */
 	const char *zerolen = "[test]\nzero_len=\nnon_zero_len=test";
@@ -1936,6 +2104,211 @@ static void search_friend_with_name(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+static void search_friend_index_follows_changes(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+	const char *sipUri = {"sip:toto@sip.example.org"};
+	LinphoneFriend *lf = linphone_core_create_friend(manager->lc);
+	LinphoneVcard *vcard = linphone_factory_create_vcard(linphone_factory_get());
+
+	_create_friends_from_tab(manager->lc, lfl, sFriends, sSizeFriend);
+
+	linphone_vcard_set_full_name(vcard, "stephanie delarue");
+	linphone_vcard_add_sip_address(vcard, sipUri);
+	linphone_friend_set_vcard(lf, vcard);
+	linphone_core_add_friend(manager->lc, lf);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "delarue", "");
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, sipUri, NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+	linphone_magic_search_reset_search_cache(magicSearch);
+
+	// Renaming the friend must be reflected by the next search.
+	linphone_friend_edit(lf);
+	linphone_friend_set_name(lf, "stephanie dupont");
+	linphone_friend_done(lf);
+
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "delarue", "");
+	BC_ASSERT_PTR_NULL(resultList);
+	if (resultList) bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	linphone_magic_search_reset_search_cache(magicSearch);
+
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "dupont", "");
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, sipUri, NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+	linphone_magic_search_reset_search_cache(magicSearch);
+
+	// Once removed, the friend must no longer be found.
+	linphone_friend_list_remove_friend(lfl, lf);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "dupont", "");
+	BC_ASSERT_PTR_NULL(resultList);
+	if (resultList) bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+
+	_remove_friends_from_list(lfl, sFriends, sSizeFriend);
+	linphone_friend_unref(lf);
+	linphone_vcard_unref(vcard);
+
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
+static void search_friend_ngram_index_compare_results(const bctbx_list_t *scanList, const bctbx_list_t *indexList) {
+	const bctbx_list_t *scanIt, *indexIt;
+
+	// Both searches must return the same results, in the same order.
+	BC_ASSERT_EQUAL((int)bctbx_list_size(indexList), (int)bctbx_list_size(scanList), int, "%d");
+	for (scanIt = scanList, indexIt = indexList; scanIt && indexIt;
+	     scanIt = bctbx_list_next(scanIt), indexIt = bctbx_list_next(indexIt)) {
+		LinphoneSearchResult *scanResult = (LinphoneSearchResult *)bctbx_list_get_data(scanIt);
+		LinphoneSearchResult *indexResult = (LinphoneSearchResult *)bctbx_list_get_data(indexIt);
+		BC_ASSERT_PTR_EQUAL(linphone_search_result_get_friend(indexResult),
+		                    linphone_search_result_get_friend(scanResult));
+		BC_ASSERT_EQUAL(linphone_search_result_get_weight(indexResult), linphone_search_result_get_weight(scanResult),
+		                unsigned int, "%u");
+	}
+}
+
+static void search_friend_ngram_index_with_friends(int friendCount) {
+	const char *firstNames[] = {"martin", "marie", "pauline", "laure", "chloe", "arthur", "pierre", "jehan",
+	                            "sylvain", "ghislain", "simon", "johan", "benjamin", "francois", "ronan", "gautier"};
+	const char *lastNames[] = {"dupont", "durand", "bernard", "thomas", "petit", "robert", "richard", "moreau",
+	                           "simon", "laurent", "lefebvre", "michel", "garcia", "david", "bertrand", "roux"};
+	const char *filters[] = {"m", "ma", "mar", "martin", "durand 4", "12345", "42", "user999", "+33612", "dupont 7",
+	                         "zz"};
+	const LinphoneMagicSearchAggregation aggregations[] = {LinphoneMagicSearchAggregationNone,
+	                                                       LinphoneMagicSearchAggregationFriend};
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneMagicSearch *magicSearch = linphone_magic_search_new(manager->lc);
+	LinphoneFriendList *lfl;
+	LinphoneFriend *renamedFriend;
+	bctbx_list_t *resultList;
+	uint64_t start, scanTime = 0, indexTime = 0;
+	size_t i, j;
+
+	// The synthetic friends do not need to be stored.
+	linphone_config_set_int(linphone_core_get_config(manager->lc), "misc", "store_friends", 0);
+	lfl = linphone_core_create_friend_list(manager->lc);
+	linphone_friend_list_set_display_name(lfl, "benchmark");
+	linphone_friend_list_enable_subscriptions(lfl, FALSE);
+	linphone_core_add_friend_list(manager->lc, lfl);
+
+	start = bctbx_get_cur_time_ms();
+	for (i = 0; i < (size_t)friendCount; i++) {
+		char uri[80], name[80], refKey[32], phoneNumber[32];
+		LinphoneFriend *lf;
+		snprintf(uri, sizeof(uri), "sip:user%zu@sip.example%zu.org", i, i % 10);
+		snprintf(name, sizeof(name), "%s %s %zu", firstNames[i % 16], lastNames[(i / 16) % 16], i);
+		snprintf(refKey, sizeof(refKey), "%zu", i);
+		lf = linphone_core_create_friend_with_address(manager->lc, uri);
+		linphone_friend_enable_subscribes(lf, FALSE);
+		linphone_friend_set_name(lf, name);
+		linphone_friend_set_ref_key(lf, refKey);
+		if (i % 4 == 0) {
+			snprintf(phoneNumber, sizeof(phoneNumber), "+336%08zu", i);
+			linphone_friend_add_phone_number(lf, phoneNumber);
+		}
+		linphone_friend_list_add_local_friend(lfl, lf);
+		linphone_friend_unref(lf);
+	}
+	ms_message("Created %d friends in %llu ms", friendCount, (unsigned long long)(bctbx_get_cur_time_ms() - start));
+
+	// The first search with the n-gram index builds it.
+	linphone_magic_search_set_use_ngram_index(magicSearch, TRUE);
+	start = bctbx_get_cur_time_ms();
+	resultList = linphone_magic_search_get_contacts_list(magicSearch, "x", "", LinphoneMagicSearchSourceFriends,
+	                                                     LinphoneMagicSearchAggregationNone);
+	ms_message("Built n-gram index in %llu ms", (unsigned long long)(bctbx_get_cur_time_ms() - start));
+	bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+
+	// Give the first friend the name of the eighth one: it is indexed again after it, but must still come first
+	// among the friends that share this name.
+	renamedFriend = linphone_friend_list_find_friend_by_ref_key(lfl, "0");
+	if (BC_ASSERT_PTR_NOT_NULL(renamedFriend)) {
+		linphone_friend_edit(renamedFriend);
+		linphone_friend_set_name(renamedFriend, "jehan dupont 7");
+		linphone_friend_done(renamedFriend);
+	}
+
+	for (i = 0; i < sizeof(filters) / sizeof(filters[0]); i++) {
+		for (j = 0; j < sizeof(aggregations) / sizeof(aggregations[0]); j++) {
+			bctbx_list_t *scanList, *indexList;
+			uint64_t elapsed;
+
+			// Friend aggregation only orders the results by name, and returns the first ones through a heap.
+			linphone_magic_search_set_limited_search(magicSearch,
+			                                         aggregations[j] == LinphoneMagicSearchAggregationFriend);
+			linphone_magic_search_set_search_limit(magicSearch, 10);
+
+			linphone_magic_search_set_use_ngram_index(magicSearch, FALSE);
+			start = bctbx_get_cur_time_ms();
+			scanList = linphone_magic_search_get_contacts_list(magicSearch, filters[i], "",
+			                                                   LinphoneMagicSearchSourceFriends, aggregations[j]);
+			elapsed = bctbx_get_cur_time_ms() - start;
+			scanTime += elapsed;
+			ms_message("Search [%s] without index: %llu ms", filters[i], (unsigned long long)elapsed);
+
+			linphone_magic_search_set_use_ngram_index(magicSearch, TRUE);
+			start = bctbx_get_cur_time_ms();
+			indexList = linphone_magic_search_get_contacts_list(magicSearch, filters[i], "",
+			                                                    LinphoneMagicSearchSourceFriends, aggregations[j]);
+			elapsed = bctbx_get_cur_time_ms() - start;
+			indexTime += elapsed;
+			ms_message("Search [%s] with index: %llu ms", filters[i], (unsigned long long)elapsed);
+
+			search_friend_ngram_index_compare_results(scanList, indexList);
+			bctbx_list_free_with_data(scanList, (bctbx_list_free_func)linphone_search_result_unref);
+			bctbx_list_free_with_data(indexList, (bctbx_list_free_func)linphone_search_result_unref);
+		}
+	}
+	ms_message("Total search time: %llu ms without index, %llu ms with index", (unsigned long long)scanTime,
+	           (unsigned long long)indexTime);
+	linphone_magic_search_set_limited_search(magicSearch, FALSE);
+
+	// The index follows the changes of the friends.
+	renamedFriend = linphone_friend_list_find_friend_by_ref_key(lfl, "42");
+	if (BC_ASSERT_PTR_NOT_NULL(renamedFriend)) {
+		linphone_friend_edit(renamedFriend);
+		linphone_friend_set_name(renamedFriend, "zyzzyva");
+		linphone_friend_done(renamedFriend);
+		resultList = linphone_magic_search_get_contacts_list(magicSearch, "zyzzy", "",
+		                                                     LinphoneMagicSearchSourceFriends,
+		                                                     LinphoneMagicSearchAggregationNone);
+		if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+			BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+			bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+		}
+		linphone_friend_list_remove_friend(lfl, renamedFriend);
+		resultList = linphone_magic_search_get_contacts_list(magicSearch, "zyzzy", "",
+		                                                     LinphoneMagicSearchSourceFriends,
+		                                                     LinphoneMagicSearchAggregationNone);
+		BC_ASSERT_PTR_NULL(resultList);
+		if (resultList) bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+
+	linphone_core_remove_friend_list(manager->lc, lfl);
+	linphone_friend_list_unref(lfl);
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
+static void search_friend_ngram_index_matches_scan(void) {
+	search_friend_ngram_index_with_friends(2000);
+}
+
+static void search_friend_ngram_index_benchmark(void) {
+	search_friend_ngram_index_with_friends(100000);
+}
+
 static void search_friend_with_aggregation(void) {
 	LinphoneMagicSearch *magicSearch = NULL;
 	bctbx_list_t *resultList = NULL;
@@ -2794,6 +3167,57 @@ static void async_search_friend_in_sources(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+static void search_friend_partial_results(void) {
+	LinphoneCoreManager *manager = linphone_core_manager_new("marie_rc");
+	LinphoneLdap *ldap;
+
+	prepare_friends(manager, &ldap);
+	bool ldap_available = !!linphone_core_ldap_available(manager->lc);
+
+	LinphoneMagicSearchCbs *searchHandler = linphone_factory_create_magic_search_cbs(linphone_factory_get());
+	linphone_magic_search_cbs_set_search_results_received(searchHandler, _onMagicSearchResultsReceived);
+	LinphoneMagicSearch *magicSearch = linphone_magic_search_new(manager->lc);
+	linphone_magic_search_add_callbacks(magicSearch, searchHandler);
+	linphone_magic_search_set_notify_partial_results(magicSearch, TRUE);
+
+	bctbx_list_t *resultList = NULL;
+	stats *stat = get_stats(manager->lc);
+	linphone_magic_search_cbs_set_user_data(searchHandler, stat);
+
+	linphone_magic_search_get_contacts_list_async(magicSearch, "u", "", LinphoneMagicSearchSourceAll,
+	                                              LinphoneMagicSearchAggregationNone);
+	BC_ASSERT_TRUE(wait_for(manager->lc, NULL, &stat->number_of_LinphoneMagicSearchResultReceived, 1));
+	resultList = linphone_magic_search_get_last_search(magicSearch);
+	// Local sources are notified without waiting for the LDAP server.
+	BC_ASSERT_EQUAL(linphone_magic_search_is_last_search_partial(magicSearch), ldap_available, int, "%d");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 3, int, "%d");
+	_check_friend_result_list(manager->lc, resultList, 0, NULL, "+33655667788");
+	_check_friend_result_list(manager->lc, resultList, 1, "sip:pauline@sip.example.org", NULL);
+	_check_friend_result_list(manager->lc, resultList, 2, "sip:u@sip.example.org", NULL);
+	bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+
+	if (ldap_available) {
+		BC_ASSERT_TRUE(wait_for(manager->lc, NULL, &stat->number_of_LinphoneMagicSearchResultReceived, 2));
+		BC_ASSERT_FALSE(linphone_magic_search_is_last_search_partial(magicSearch));
+		resultList = linphone_magic_search_get_last_search(magicSearch);
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 6, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 1, "sip:laure@ldap.example.org", NULL);
+		_check_friend_result_list(manager->lc, resultList, 3, "sip:Pauline@ldap.example.org", NULL);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_search_result_unref);
+	}
+	stat->number_of_LinphoneMagicSearchResultReceived = 0;
+
+	linphone_magic_search_cbs_unref(searchHandler);
+	linphone_magic_search_unref(magicSearch);
+
+	if (ldap) {
+		linphone_core_clear_ldaps(manager->lc);
+		linphone_ldap_unref(ldap);
+	}
+
+	linphone_core_manager_destroy(manager);
+}
+
 static void ldap_search(void) {
 	// Prepare datas : Friends, Call logs, Chat rooms, ldap
 	LinphoneCoreManager *manager = linphone_core_manager_new("marie_rc");
@@ -3747,6 +4171,7 @@ test_t setup_tests[] = {
     TEST_NO_TAG("Version check", linphone_version_test),
     TEST_NO_TAG("Version update check", linphone_version_update_test),
     TEST_NO_TAG("Linphone Address", linphone_address_test),
+    TEST_NO_TAG("Linphone Address cache", linphone_address_cache_test),
     TEST_NO_TAG("Linphone proxy config address equal (internal api)", linphone_proxy_config_address_equal_test),
     TEST_NO_TAG("Linphone proxy config server address change (internal api)",
                 linphone_proxy_config_is_server_config_changed_test),
@@ -3761,7 +4186,12 @@ test_t setup_tests[] = {
     TEST_NO_TAG("Linphone random transport port", core_sip_transport_test),
     TEST_NO_TAG("Linphone interpret url", linphone_interpret_url_test),
     TEST_NO_TAG("LPConfig safety test", linphone_config_safety_test),
+    TEST_NO_TAG("LPConfig background sync", linphone_config_background_sync_test),
+#ifndef _WIN32
+    TEST_NO_TAG("LPConfig rename failure", linphone_config_rename_failure_test),
+#endif
     TEST_NO_TAG("LPConfig from buffer", linphone_lpconfig_from_buffer),
+    TEST_NO_TAG("LPConfig lookup benchmark", linphone_lpconfig_lookup_benchmark),
     TEST_NO_TAG("LPConfig zero_len value from buffer", linphone_lpconfig_from_buffer_zerolen_value),
     TEST_NO_TAG("LPConfig zero_len value from file", linphone_lpconfig_from_file_zerolen_value),
     TEST_NO_TAG("LPConfig zero_len value from XML", linphone_lpconfig_from_xml_zerolen_value),
@@ -3797,6 +4227,10 @@ test_t setup_tests[] = {
     TEST_ONE_TAG("Search friend with multiple sip address", search_friend_with_multiple_sip_address, "MagicSearch"),
     TEST_ONE_TAG("Search friend with same address", search_friend_with_same_address, "MagicSearch"),
     TEST_ONE_TAG("Search friend in large friends database", search_friend_large_database, "MagicSearch"),
+    TEST_ONE_TAG("Search friend index follows changes", search_friend_index_follows_changes, "MagicSearch"),
+    TEST_ONE_TAG("Search friend n-gram index matches scan", search_friend_ngram_index_matches_scan, "MagicSearch"),
+    // Benchmark, only run when explicitly requested.
+    TEST_TWO_TAGS("Search friend n-gram index benchmark", search_friend_ngram_index_benchmark, "MagicSearch", "Skip"),
     TEST_ONE_TAG("Search friend result has capabilities", search_friend_get_capabilities, "MagicSearch"),
     TEST_ONE_TAG("Search friend result chat room remote", search_friend_chat_room_remote, "MagicSearch"),
     TEST_ONE_TAG("Search friend result chat room remote ldap fallback",
@@ -3805,6 +4239,7 @@ test_t setup_tests[] = {
     TEST_ONE_TAG("Search friend in non default friend list", search_friend_non_default_list, "MagicSearch"),
     TEST_ONE_TAG("Async search friend in sources", async_search_friend_in_sources, "MagicSearch"),
     TEST_ONE_TAG("Ldap search", ldap_search, "MagicSearch"),
+    TEST_ONE_TAG("Search friend partial results", search_friend_partial_results, "MagicSearch"),
     TEST_ONE_TAG("Ldap features delay", ldap_features_delay, "MagicSearch"),
     TEST_ONE_TAG("Ldap features min characters", ldap_features_min_characters, "MagicSearch"),
     TEST_ONE_TAG("Ldap features more results", ldap_features_more_results, "MagicSearch"),
@@ -18,6 +18,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <map>
+#include <set>
+#include <unordered_map>
+
 #include "bctoolbox/utils.hh"
 
 #include "address/address.h"
@@ -113,6 +117,68 @@ static void address_comparisons(void) {
 	BC_ASSERT_FALSE(a3.weakEqual(a4));
 }
 
+static void address_ordered_key(void) {
+	Address a1("sip:toto@sip.example.org;b=dede;a=dada");
+	Address a2("sip:toto@sip.example.org;a=dada;b=dede");
+	BC_ASSERT_STRING_EQUAL(a1.getOrderedKey().c_str(), a1.toStringOrdered().c_str());
+	BC_ASSERT_STRING_EQUAL(a1.toStringUriOnlyOrdered().c_str(), "sip:toto@sip.example.org;a=dada;b=dede");
+	BC_ASSERT_FALSE(a1 < a2 || a2 < a1);
+
+	// The cached key must follow modifications of the address.
+	a2.setUriParam("a", "DADA");
+	BC_ASSERT_STRING_EQUAL(a2.toStringUriOnlyOrdered().c_str(), "sip:toto@sip.example.org;a=DADA;b=dede");
+	BC_ASSERT_STRING_EQUAL(a2.toStringUriOnlyOrdered(true).c_str(), "sip:toto@sip.example.org;a=dada;b=dede");
+	BC_ASSERT_TRUE(a2 < a1);
+	Address a3(a2);
+	a3.setUsername("titi");
+	BC_ASSERT_TRUE(a3 < a2);
+	a3 = a1;
+	BC_ASSERT_FALSE(a1 < a3 || a3 < a1);
+
+	const int count = 2000;
+	vector<Address> addresses;
+	addresses.reserve(count);
+	for (int i = 0; i < count; i++) {
+		const string index = to_string(i);
+		addresses.emplace_back("sip:user-" + index + "@sip.example.org;transport=tls;gr=urn:uuid:" + index);
+	}
+
+	// Baseline comparing freshly formatted strings, as Address::operator< used to do.
+	auto rebuildingLess = [](const Address &lhs, const Address &rhs) {
+		return Address(lhs.getImpl()).toStringOrdered() < Address(rhs.getImpl()).toStringOrdered();
+	};
+	uint64_t start = bctbx_get_cur_time_ms();
+	set<Address, decltype(rebuildingLess)> rebuildingSet(rebuildingLess);
+	for (const auto &address : addresses)
+		rebuildingSet.insert(address);
+	for (const auto &address : addresses)
+		BC_ASSERT_TRUE(rebuildingSet.find(address) != rebuildingSet.end());
+	uint64_t rebuildingTime = bctbx_get_cur_time_ms() - start;
+
+	start = bctbx_get_cur_time_ms();
+	set<Address> orderedSet(addresses.begin(), addresses.end());
+	map<Address, int> orderedMap;
+	for (int i = 0; i < count; i++)
+		orderedMap[addresses[(size_t)i]] = i;
+	for (const auto &address : addresses)
+		BC_ASSERT_TRUE(orderedSet.find(address) != orderedSet.end());
+	uint64_t orderedTime = bctbx_get_cur_time_ms() - start;
+
+	start = bctbx_get_cur_time_ms();
+	// Hashed containers are keyed by the ordered key explicitly: it follows operator<, not operator==.
+	unordered_map<string, int> hashedMap;
+	for (int i = 0; i < count; i++)
+		hashedMap[addresses[(size_t)i].getOrderedKey()] = i;
+	for (const auto &address : addresses)
+		BC_ASSERT_TRUE(hashedMap.find(address.getOrderedKey()) != hashedMap.end());
+	uint64_t hashedTime = bctbx_get_cur_time_ms() - start;
+
+	BC_ASSERT_EQUAL((int)orderedSet.size(), count, int, "%d");
+	BC_ASSERT_EQUAL((int)hashedMap.size(), count, int, "%d");
+	ms_message("%d addresses: rebuilt keys set %llu ms, cached keys set+map %llu ms, unordered_map %llu ms", count,
+	           (unsigned long long)rebuildingTime, (unsigned long long)orderedTime, (unsigned long long)hashedTime);
+}
+
 static void conferenceId_comparisons(void) {
 	std::shared_ptr<Address> a1 = Address::create("sip:toto@sip.example.org;a=dada;b=dede;c=didi;d=dodo");
 	std::shared_ptr<Address> a2 = Address::create("sip:toto@sip.example.org;b=dede;a=dada;d=dodo;c=didi");
@@ -157,6 +223,7 @@ test_t utils_tests[] = {
     TEST_NO_TAG("trim", trim),
     TEST_NO_TAG("Version comparisons", version_comparisons),
     TEST_NO_TAG("Address comparisons", address_comparisons),
+    TEST_NO_TAG("Address ordered key", address_ordered_key),
     TEST_NO_TAG("Conference ID comparisons", conferenceId_comparisons),
     TEST_NO_TAG("Parse capabilities", parse_capabilities)
 };
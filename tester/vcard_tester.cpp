@@ -23,6 +23,20 @@
 #ifdef VCARD_ENABLED
 #include <time.h>
 
+#ifndef _WIN32
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include <bctoolbox/defs.h>
 #include <bctoolbox/map.h>
 
@@ -826,6 +840,365 @@ static void carddav_server_to_client_and_client_to_sever_sync(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+#ifndef _WIN32
+// Minimal WebDAV address book served on the loopback. bellesip::HttpServer (cpp-httplib) rejects the PROPFIND and
+// REPORT methods, so requests are handled here by hand, one connection per request.
+class CardDAVStubServer {
+public:
+	CardDAVStubServer() {
+		mSocket = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		socklen_t len = sizeof(addr);
+		bind(mSocket, (sockaddr *)&addr, sizeof(addr));
+		listen(mSocket, 8);
+		getsockname(mSocket, (sockaddr *)&addr, &len);
+		mUrl = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/addressbook";
+		mThread = std::thread([this] { run(); });
+	}
+	~CardDAVStubServer() {
+		mRunning = false;
+		mThread.join();
+		close(mSocket);
+	}
+
+	const std::string &getUrl() const {
+		return mUrl;
+	}
+	void putCard(const std::string &name, const std::string &impp) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRevision++;
+		mCards[name] = std::make_pair("\"" + name + "-" + std::to_string(mRevision) + "\"",
+		                              "BEGIN:VCARD\r\nVERSION:4.0\r\nUID:urn:uuid:stub-" + name + "\r\nFN:" + name +
+		                                  "\r\nIMPP:" + impp + "\r\nEND:VCARD\r\n");
+		mChanges.emplace_back(mRevision, name);
+	}
+	void removeCard(const std::string &name) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRevision++;
+		mCards.erase(name);
+		mChanges.emplace_back(mRevision, name);
+	}
+	// Sync-tokens issued before the latest change are answered with a 403, as a server pruning its history would do.
+	void forgetHistory() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mOldestValidRevision = mRevision;
+	}
+	// Sync-collection responses report at most pageSize changes, then a 507 status for the collection (0: no limit).
+	void setSyncCollectionPageSize(size_t pageSize) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mSyncCollectionPageSize = pageSize;
+	}
+	enum class SyncCollectionFault { None, InvalidBody, MissingSyncToken };
+	// Sync-collection queries are answered with a 207 status, but with a broken body.
+	void setSyncCollectionFault(SyncCollectionFault fault) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mSyncCollectionFault = fault;
+	}
+
+	std::atomic<int> mFullListingCount{0};
+	std::atomic<int> mSyncCollectionCount{0};
+	std::atomic<int> mPulledCount{0};
+
+private:
+	static std::string multistatus(const std::string &content) {
+		return "<?xml version=\"1.0\" encoding=\"utf-8\"?><d:multistatus xmlns:d=\"DAV:\" "
+		       "xmlns:card=\"urn:ietf:params:xml:ns:carddav\" xmlns:cs=\"http://calendarserver.org/ns/\">" +
+		       content + "</d:multistatus>";
+	}
+	static std::string propstat(const std::string &href, const std::string &props) {
+		return "<d:response><d:href>" + href + "</d:href><d:propstat><d:prop>" + props +
+		       "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>";
+	}
+	std::string token(int revision) const {
+		return "http://127.0.0.1/sync/" + std::to_string(revision);
+	}
+
+	void run() {
+		while (mRunning) {
+			pollfd pfd = {mSocket, POLLIN, 0};
+			if (poll(&pfd, 1, 100) <= 0) continue;
+			int client = accept(mSocket, nullptr, nullptr);
+			if (client < 0) continue;
+			handle(client);
+			close(client);
+		}
+	}
+
+	void handle(int client) {
+		std::string request;
+		char buffer[4096];
+		size_t headersEnd = std::string::npos;
+		size_t contentLength = 0;
+		while (true) {
+			if (headersEnd != std::string::npos && request.size() >= headersEnd + 4 + contentLength) break;
+			ssize_t read = recv(client, buffer, sizeof(buffer), 0);
+			if (read <= 0) return;
+			request.append(buffer, (size_t)read);
+			if (headersEnd == std::string::npos && (headersEnd = request.find("\r\n\r\n")) != std::string::npos) {
+				size_t pos = request.find("Content-Length:");
+				if (pos != std::string::npos && pos < headersEnd) contentLength = (size_t)atoi(&request[pos + 15]);
+			}
+		}
+		std::string method = request.substr(0, request.find(' '));
+		std::string body = request.substr(headersEnd + 4);
+		int code = 207;
+		std::string content;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (method == "PROPFIND") {
+				content = multistatus(propstat(
+				    "/addressbook/", "<d:resourcetype><d:collection /><card:addressbook /></d:resourcetype>"
+				                     "<d:displayname>Stub</d:displayname><cs:getctag>" +
+				                         std::to_string(mRevision) + "</cs:getctag><d:sync-token>" +
+				                         token(mRevision) + "</d:sync-token>"));
+			} else if (body.find("sync-collection") != std::string::npos) {
+				mSyncCollectionCount++;
+				size_t start = body.find("<d:sync-token>") + 14;
+				std::string clientToken = body.substr(start, body.find("</d:sync-token>") - start);
+				int since = atoi(clientToken.substr(clientToken.rfind('/') + 1).c_str());
+				if (clientToken != token(since) || since < mOldestValidRevision) {
+					code = 403;
+				} else {
+					// Latest change of each member, reported from the oldest one
+					std::map<std::string, int> latestChanges;
+					for (const auto &change : mChanges)
+						if (change.first > since) latestChanges[change.second] = change.first;
+					std::map<int, std::string> changed;
+					for (const auto &change : latestChanges)
+						changed[change.second] = change.first;
+					int revision = mRevision;
+					std::string responses;
+					if (mSyncCollectionPageSize > 0 && changed.size() > mSyncCollectionPageSize) {
+						changed.erase(std::next(changed.begin(), (long)mSyncCollectionPageSize), changed.end());
+						revision = changed.rbegin()->first;
+						responses += "<d:response><d:href>/addressbook/</d:href><d:status>HTTP/1.1 507 Insufficient "
+						             "Storage</d:status></d:response>";
+					}
+					for (const auto &change : changed) {
+						const auto it = mCards.find(change.second);
+						std::string href = "/addressbook/" + change.second + ".vcf";
+						if (it == mCards.end()) {
+							responses += "<d:response><d:href>" + href +
+							             "</d:href><d:status>HTTP/1.1 404 Not Found</d:status></d:response>";
+						} else {
+							responses += propstat(href, "<d:getetag>" + it->second.first + "</d:getetag>");
+						}
+					}
+					if (mSyncCollectionFault == SyncCollectionFault::InvalidBody)
+						content = "<d:multistatus xmlns:d=\"DAV:\">" + responses;
+					else if (mSyncCollectionFault == SyncCollectionFault::MissingSyncToken)
+						content = multistatus(responses);
+					else content = multistatus(responses + "<d:sync-token>" + token(revision) + "</d:sync-token>");
+				}
+			} else if (body.find("addressbook-multiget") != std::string::npos) {
+				std::string responses;
+				for (size_t pos = body.find("<d:href>"); pos != std::string::npos; pos = body.find("<d:href>", pos)) {
+					pos += 8;
+					std::string href = body.substr(pos, body.find("</d:href>", pos) - pos);
+					std::string name = href.substr(href.rfind('/') + 1);
+					const auto it = mCards.find(name.substr(0, name.rfind(".vcf")));
+					if (it == mCards.end()) continue;
+					mPulledCount++;
+					responses += propstat(href, "<d:getetag>" + it->second.first + "</d:getetag><card:address-data>" +
+					                                it->second.second + "</card:address-data>");
+				}
+				content = multistatus(responses);
+			} else if (body.find("addressbook-query") != std::string::npos) {
+				mFullListingCount++;
+				std::string responses;
+				for (const auto &card : mCards)
+					responses += propstat("/addressbook/" + card.first + ".vcf",
+					                      "<d:getetag>" + card.second.first + "</d:getetag>");
+				content = multistatus(responses);
+			} else {
+				code = 405;
+			}
+		}
+		std::string response = "HTTP/1.1 " + std::to_string(code) + (code == 207 ? " Multi-Status" : " Error") +
+		                       "\r\nContent-Type: application/xml; charset=utf-8\r\nContent-Length: " +
+		                       std::to_string(content.size()) + "\r\nConnection: close\r\n\r\n" + content;
+		send(client, response.c_str(), response.size(), 0);
+	}
+
+	int mSocket = -1;
+	std::string mUrl;
+	std::thread mThread;
+	std::atomic<bool> mRunning{true};
+	std::mutex mMutex;
+	int mRevision = 0;
+	int mOldestValidRevision = 0;
+	size_t mSyncCollectionPageSize = 0;
+	SyncCollectionFault mSyncCollectionFault = SyncCollectionFault::None;
+	std::map<std::string, std::pair<std::string, std::string>> mCards; // name -> (eTag, vCard)
+	std::vector<std::pair<int, std::string>> mChanges;                 // (revision, name)
+};
+
+static void carddav_sync_token(void) {
+	CardDAVStubServer server;
+	server.putCard("alice", "sip:alice@sip.example.org");
+	server.putCard("bob", "sip:bob@sip.example.org");
+	server.putCard("carol", "sip:carol@sip.example.org");
+
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_create_friend_list(manager->lc);
+	LinphoneFriendListCbs *cbs = linphone_factory_create_friend_list_cbs(linphone_factory_get());
+	LinphoneCardDAVStats *stats = (LinphoneCardDAVStats *)ms_new0(LinphoneCardDAVStats, 1);
+
+	linphone_friend_list_add_callbacks(lfl, cbs);
+	linphone_friend_list_cbs_set_user_data(cbs, stats);
+	linphone_friend_list_cbs_set_contact_created(cbs, carddav_contact_created);
+	linphone_friend_list_cbs_set_contact_deleted(cbs, carddav_contact_deleted);
+	linphone_friend_list_cbs_set_contact_updated(cbs, carddav_contact_updated);
+	linphone_friend_list_cbs_set_sync_status_changed(cbs, carddav_sync_status_changed);
+	linphone_core_add_friend_list(manager->lc, lfl);
+	linphone_friend_list_set_uri(lfl, server.getUrl().c_str());
+	linphone_friend_list_set_type(lfl, LinphoneFriendListTypeCardDAV);
+	// The address book URL is already known, skip the discovery process
+	linphone_friend_list_update_revision(lfl, 0);
+
+	// First synchronization without sync-token: everything is listed and pulled
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 1, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(stats->new_contact_count, 3, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 0, int, "%i");
+	BC_ASSERT_EQUAL(server.mPulledCount, 3, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 3, int, "%i");
+
+	// Only the changed and new vCards are transferred, the removed one is reported by its href
+	server.putCard("bob", "sip:bob@sip2.example.org");
+	server.removeCard("carol");
+	server.putCard("dave", "sip:dave@sip.example.org");
+	stats->new_contact_count = 0;
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 2, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(stats->new_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL(stats->updated_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL(stats->removed_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mPulledCount, 5, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 3, int, "%i");
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:carol@sip.example.org"));
+
+	// Nothing changed, the CTAG is enough to skip the synchronization
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 3, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mPulledCount, 5, int, "%i");
+
+	// A sync-token the server doesn't know anymore falls back to a full synchronization
+	server.putCard("erin", "sip:erin@sip.example.org");
+	server.forgetHistory();
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 4, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 2, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 2, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 4, int, "%i");
+
+	// A truncated (507) response is followed by a query with the sync-token it returned, the changes are only applied
+	// once the last response has been received
+	server.setSyncCollectionPageSize(2);
+	server.putCard("frank", "sip:frank@sip.example.org");
+	server.putCard("grace", "sip:grace@sip.example.org");
+	server.removeCard("alice");
+	server.putCard("frank", "sip:frank@sip2.example.org");
+	stats->new_contact_count = 0;
+	stats->removed_contact_count = 0;
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 5, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 4, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 2, int, "%i");
+	BC_ASSERT_EQUAL(stats->new_contact_count, 2, int, "%i");
+	BC_ASSERT_EQUAL(stats->removed_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 5, int, "%i");
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:alice@sip.example.org"));
+	BC_ASSERT_PTR_NOT_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:frank@sip2.example.org"));
+
+	// The sync-token of the last response has been saved
+	server.putCard("heidi", "sip:heidi@sip.example.org");
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 6, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 5, int, "%i");
+	BC_ASSERT_EQUAL(stats->new_contact_count, 3, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 6, int, "%i");
+
+	ms_free(stats);
+	linphone_friend_list_unref(lfl);
+	linphone_friend_list_cbs_unref(cbs);
+	linphone_core_manager_destroy(manager);
+}
+
+// A sync-collection response that can't be trusted is not a successful synchronization: the whole address book is
+// listed again and the sync-token of the address book is saved
+static void carddav_sync_token_fault(CardDAVStubServer::SyncCollectionFault fault) {
+	CardDAVStubServer server;
+	server.putCard("alice", "sip:alice@sip.example.org");
+	server.putCard("bob", "sip:bob@sip.example.org");
+
+	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_create_friend_list(manager->lc);
+	LinphoneFriendListCbs *cbs = linphone_factory_create_friend_list_cbs(linphone_factory_get());
+	LinphoneCardDAVStats *stats = (LinphoneCardDAVStats *)ms_new0(LinphoneCardDAVStats, 1);
+
+	linphone_friend_list_add_callbacks(lfl, cbs);
+	linphone_friend_list_cbs_set_user_data(cbs, stats);
+	linphone_friend_list_cbs_set_contact_created(cbs, carddav_contact_created);
+	linphone_friend_list_cbs_set_contact_deleted(cbs, carddav_contact_deleted);
+	linphone_friend_list_cbs_set_contact_updated(cbs, carddav_contact_updated);
+	linphone_friend_list_cbs_set_sync_status_changed(cbs, carddav_sync_status_changed);
+	linphone_core_add_friend_list(manager->lc, lfl);
+	linphone_friend_list_set_uri(lfl, server.getUrl().c_str());
+	linphone_friend_list_set_type(lfl, LinphoneFriendListTypeCardDAV);
+	linphone_friend_list_update_revision(lfl, 0);
+
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 1, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mFullListingCount, 1, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 2, int, "%i");
+
+	server.setSyncCollectionFault(fault);
+	server.putCard("carol", "sip:carol@sip.example.org");
+	server.removeCard("alice");
+	stats->new_contact_count = 0;
+	stats->removed_contact_count = 0;
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 2, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 1, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 2, int, "%i");
+	BC_ASSERT_EQUAL(stats->new_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL(stats->removed_contact_count, 1, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 2, int, "%i");
+	BC_ASSERT_PTR_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:alice@sip.example.org"));
+	BC_ASSERT_PTR_NOT_NULL(linphone_friend_list_find_friend_by_uri(lfl, "sip:carol@sip.example.org"));
+
+	// The next synchronization starts from the sync-token saved by the full one
+	server.setSyncCollectionFault(CardDAVStubServer::SyncCollectionFault::None);
+	server.putCard("dave", "sip:dave@sip.example.org");
+	linphone_friend_list_synchronize_friends_from_server(lfl);
+	BC_ASSERT_TRUE(wait_for_until(manager->lc, NULL, &stats->sync_done_count, 3, CARDDAV_SYNC_TIMEOUT));
+	BC_ASSERT_EQUAL(server.mSyncCollectionCount, 2, int, "%i");
+	BC_ASSERT_EQUAL(server.mFullListingCount, 2, int, "%i");
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_friend_list_get_friends(lfl)), 3, int, "%i");
+
+	ms_free(stats);
+	linphone_friend_list_unref(lfl);
+	linphone_friend_list_cbs_unref(cbs);
+	linphone_core_manager_destroy(manager);
+}
+
+static void carddav_sync_token_invalid_body(void) {
+	carddav_sync_token_fault(CardDAVStubServer::SyncCollectionFault::InvalidBody);
+}
+
+static void carddav_sync_token_missing(void) {
+	carddav_sync_token_fault(CardDAVStubServer::SyncCollectionFault::MissingSyncToken);
+}
+#endif
+
 static void find_friend_by_ref_key_test(void) {
 	LinphoneCoreManager *manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
 	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
@@ -921,6 +1294,11 @@ test_t vcard_tests[] = {
     TEST_ONE_TAG("CardDAV client to server and server to client sync",
                  carddav_server_to_client_and_client_to_sever_sync,
                  "CardDAV"),
+#ifndef _WIN32
+    TEST_NO_TAG("CardDAV sync-token synchronization with a local server", carddav_sync_token),
+    TEST_NO_TAG("CardDAV sync-collection response with an invalid body", carddav_sync_token_invalid_body),
+    TEST_NO_TAG("CardDAV sync-collection response without sync-token", carddav_sync_token_missing),
+#endif
     TEST_NO_TAG("Find friend by ref key", find_friend_by_ref_key_test),
     TEST_NO_TAG("create a map and insert 20000 objects", insert_lot_of_friends_map_test),
     TEST_NO_TAG("Find ref key in 20000 objects map", find_friend_by_ref_key_in_lot_of_friends_test),